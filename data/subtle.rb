@@ -47,9 +47,17 @@ set :skip_pointer_warp, false
 # Skip pointer movement to urgent windows
 set :skip_urgent_warp, false
 
+# Move and resize windows live instead of drawing an outline
+set :opaque_drag, false
+
 # Set the WM_NAME of subtle (Java quirk)
 # set :wmname, "LG3D"
 
+# Number of ruby objects sublets and hooks may allocate before garbage is
+# collected while subtle is idle (needs ruby 2.1 or newer, otherwise the GC
+# runs as usual)
+# set :gc_budget, 20000
+
 #
 # == Screen
 #
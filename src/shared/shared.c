@@ -14,8 +14,246 @@
 #include <signal.h>
 #include <unistd.h>
 #include <sys/time.h>
+#include <sys/stat.h>
 #include "shared.h"
 
+/* Color tables */
+#define COLOR_NAME  0
+#define COLOR_RGB   1
+#define COLOR_PIXEL 2
+
+typedef struct sharedcolor_t /* {{{ */
+{
+  char          *name;                                            ///< Color name
+  unsigned long key;                                              ///< Color key
+  XColor        xcolor;                                           ///< Color values
+  struct sharedcolor_t *next;                                     ///< Color next entry
+} SharedColor; /* }}} */
+
+static SharedColor *colors[3][CACHESIZE] = { { NULL } };
+
+/* SharedColorFind {{{ */
+static SharedColor *
+SharedColorFind(int table,
+  unsigned long key,
+  const char *name)
+{
+  SharedColor *c = NULL;
+
+  for(c = colors[table][key % CACHESIZE]; c; c = c->next)
+    if(c->key == key && (!name || !strcmp(c->name, name))) break;
+
+  return c;
+} /* }}} */
+
+/* SharedColorAdd {{{ */
+static void
+SharedColorAdd(int table,
+  unsigned long key,
+  const char *name,
+  XColor *xcolor)
+{
+  SharedColor *c = NULL;
+
+  c = (SharedColor *)subSharedMemoryAlloc(1, sizeof(SharedColor));
+  c->name   = name ? strdup(name) : NULL;
+  c->key    = key;
+  c->xcolor = *xcolor;
+  c->next   = colors[table][key % CACHESIZE];
+
+  colors[table][key % CACHESIZE] = c;
+} /* }}} */
+
+#ifndef SUBTLE
+typedef struct sharedcache_t /* {{{ */
+{
+  Window        win;                                              ///< Cache window
+  Atom          prop, type;                                       ///< Cache property and type
+  int           strings, valid;                                   ///< Cache kind and state
+  unsigned long nitems, len;                                      ///< Cache items and data length
+  char          *data;                                            ///< Cache data
+  struct sharedcache_t *next;                                     ///< Cache next entry
+} SharedCache; /* }}} */
+
+static SubBackend *backend = NULL;
+static Display *cachedisp = NULL;
+static SharedCache *cache[CACHESIZE] = { NULL };
+
+/* SharedCacheDrop {{{ */
+static void
+SharedCacheDrop(Window win)
+{
+  SharedCache *c = NULL, **prev = &cache[win % CACHESIZE];
+
+  /* Remove all entries of window */
+  while((c = *prev))
+    {
+      if(c->win == win)
+        {
+          *prev = c->next;
+
+          if(c->data) free(c->data);
+          free(c);
+        }
+      else prev = &c->next;
+    }
+} /* }}} */
+
+/* SharedCacheWatched {{{ */
+static int
+SharedCacheWatched(Window win)
+{
+  SharedCache *c = NULL;
+
+  for(c = cache[win % CACHESIZE]; c; c = c->next)
+    if(c->win == win) return True;
+
+  return False;
+} /* }}} */
+
+/* SharedCachePredicate {{{ */
+static Bool
+SharedCachePredicate(Display *disp,
+  XEvent *ev,
+  XPointer arg)
+{
+  /* Events caused by the masks of watched windows, leave others queued */
+  switch(ev->type)
+    {
+      case PropertyNotify:
+      case DestroyNotify:
+      case ConfigureNotify:
+      case MapNotify:
+      case UnmapNotify:
+      case ReparentNotify:
+      case GravityNotify:
+      case CirculateNotify:
+        return SharedCacheWatched(ev->xany.window);
+    }
+
+  return False;
+} /* }}} */
+
+/* SharedCacheSync {{{ */
+static void
+SharedCacheSync(Display *disp)
+{
+  XEvent ev;
+  SharedCache *c = NULL;
+
+  /* Read pending events without blocking */
+  XEventsQueued(disp, QueuedAfterReading);
+
+  /* Invalidate changed properties and forget destroyed windows */
+  while(XCheckIfEvent(disp, &ev, SharedCachePredicate, NULL))
+    {
+      if(DestroyNotify == ev.type)
+        SharedCacheDrop(ev.xdestroywindow.window);
+      else if(PropertyNotify == ev.type)
+        {
+          for(c = cache[ev.xproperty.window % CACHESIZE]; c; c = c->next)
+            {
+              if(c->valid && c->win == ev.xproperty.window &&
+                  (c->prop == ev.xproperty.atom ||
+                  (c->strings && XA_STRING == ev.xproperty.atom)))
+                {
+                  if(c->data) free(c->data);
+
+                  c->data  = NULL;
+                  c->valid = False;
+                }
+            }
+        }
+    }
+} /* }}} */
+
+/* SharedCacheGet {{{ */
+static SharedCache *
+SharedCacheGet(Display *disp,
+  Window win,
+  Atom prop,
+  Atom type,
+  int strings)
+{
+  int watched = False;
+  SharedCache *c = NULL;
+  XWindowAttributes attrs;
+
+  /* Find entry; entries of a window share one bucket */
+  for(c = cache[win % CACHESIZE]; c; c = c->next)
+    {
+      if(c->win == win)
+        {
+          if(c->prop == prop && c->type == type && c->strings == strings)
+            return c;
+
+          watched = True;
+        }
+    }
+
+  /* Watch new window before the first read to catch every change */
+  if(!watched && XGetWindowAttributes(disp, win, &attrs))
+    XSelectInput(disp, win, attrs.your_event_mask|CACHEMASK);
+
+  c = (SharedCache *)subSharedMemoryAlloc(1, sizeof(SharedCache));
+  c->win     = win;
+  c->prop    = prop;
+  c->type    = type;
+  c->strings = strings;
+  c->next    = cache[win % CACHESIZE];
+
+  cache[win % CACHESIZE] = c;
+
+  return c;
+} /* }}} */
+
+/* SharedCacheStore {{{ */
+static void
+SharedCacheStore(SharedCache *c,
+  char *data,
+  unsigned long nitems,
+  unsigned long len)
+{
+  c->nitems = nitems;
+  c->len    = len;
+  c->valid  = True;
+
+  /* Copy data and keep it terminated like Xlib does */
+  if(data)
+    {
+      c->data = (char *)subSharedMemoryAlloc(len + 1, sizeof(char));
+
+      memcpy(c->data, data, len);
+    }
+} /* }}} */
+
+/* SharedDisplayEqual {{{ */
+static int
+SharedDisplayEqual(const char *name1,
+  const char *name2)
+{
+  int i;
+  long nums[2] = { 0 };
+  size_t lens[2] = { 0 };
+  const char *names[2] = { name1, name2 }, *colon = NULL;
+
+  /* Compare host and display number, ignore screen */
+  for(i = 0; i < 2; i++)
+    {
+      if(!names[i] || !(colon = strrchr(names[i], ':'))) return False;
+
+      nums[i] = strtol(colon + 1, NULL, 10);
+      lens[i] = colon - names[i];
+
+      /* Treat unix:0 like :0 */
+      if(4 == lens[i] && !strncmp(names[i], "unix", 4)) lens[i] = 0;
+    }
+
+  return nums[0] == nums[1] && lens[0] == lens[1] &&
+    !strncmp(name1, name2, lens[0]);
+} /* }}} */
+#endif /* SUBTLE */
+
 /* Memory */
 
  /** subSharedMemoryAlloc {{{
@@ -156,22 +394,62 @@ subSharedPropertyGet(Display *disp,
   unsigned long nitems = 0, bytes = 0;
   unsigned char *data = NULL;
   Atom rtype = None;
+#ifndef SUBTLE
+  char *copy = NULL;
+  SharedCache *c = NULL;
+#endif /* SUBTLE */
 
   assert(win);
 
+#ifndef SUBTLE
+  /* Serve decoded property from cache */
+  if(disp == cachedisp)
+    {
+      SharedCacheSync(disp);
+
+      if((c = SharedCacheGet(disp, win, prop, type, False))->valid)
+        {
+          if(!c->data) return NULL;
+
+          copy = (char *)subSharedMemoryAlloc(c->len + 1, sizeof(char));
+          memcpy(copy, c->data, c->len);
+
+          if(size) *size = c->nitems;
+
+          return copy;
+        }
+    }
+#endif /* SUBTLE */
+
   /* Get property */
   if(Success != XGetWindowProperty(disp, win, prop, 0L, 4096,
       False, type, &rtype, &format, &nitems, &bytes, &data))
-    return NULL;
+    {
+#ifndef SUBTLE
+      if(c) SharedCacheDrop(win); ///< Window is gone
+#endif /* SUBTLE */
+
+      return NULL;
+    }
 
   /* Check result */
   if(type != rtype)
     {
+#ifndef SUBTLE
+      if(c) SharedCacheStore(c, NULL, 0, 0);
+#endif /* SUBTLE */
+
       XFree(data);
 
       return NULL;
     }
 
+#ifndef SUBTLE
+  /* Xlib stores 32-bit items as longs */
+  if(c) SharedCacheStore(c, (char *)data, nitems, nitems *
+    (32 == format ? sizeof(long) : 16 == format ? sizeof(short) : 1));
+#endif /* SUBTLE */
+
   if(size) *size = nitems;
 
   return (char *)data;
@@ -194,9 +472,43 @@ subSharedPropertyGetStrings(Display *disp,
 {
   char **list = NULL;
   XTextProperty text;
+#ifndef SUBTLE
+  int i;
+  unsigned long len = 0;
+  char *block = NULL;
+  SharedCache *c = NULL;
+#endif /* SUBTLE */
 
   assert(win && nlist);
 
+#ifndef SUBTLE
+  /* Serve string list from cache in the layout of XFreeStringList */
+  if(disp == cachedisp)
+    {
+      SharedCacheSync(disp);
+
+      if((c = SharedCacheGet(disp, win, prop, None, True))->valid)
+        {
+          if(!c->data) return NULL;
+
+          list  = (char **)subSharedMemoryAlloc(c->nitems, sizeof(char *));
+          block = (char *)subSharedMemoryAlloc(c->len, sizeof(char));
+
+          memcpy(block, c->data, c->len);
+
+          for(i = 0; i < (int)c->nitems; i++)
+            {
+              list[i]  = block;
+              block   += strlen(block) + 1;
+            }
+
+          *nlist = c->nitems;
+
+          return list;
+        }
+    }
+#endif /* SUBTLE */
+
   /* Check UTF8 and XA_STRING */
   if((XGetTextProperty(disp, win, &text, prop) ||
       XGetTextProperty(disp, win, &text, XA_STRING)) && text.nitems)
@@ -206,6 +518,31 @@ subSharedPropertyGetStrings(Display *disp,
       XFree(text.value);
     }
 
+#ifndef SUBTLE
+  if(c)
+    {
+      /* Strings are consecutive in one block */
+      if(list && 0 < *nlist)
+        {
+          for(i = 0; i < *nlist; i++)
+            len += strlen(list[i]) + 1;
+
+          block = (char *)subSharedMemoryAlloc(len, sizeof(char));
+
+          for(i = 0, len = 0; i < *nlist; i++)
+            {
+              strcpy(block + len, list[i]);
+              len += strlen(list[i]) + 1;
+            }
+
+          SharedCacheStore(c, block, *nlist, len);
+
+          free(block);
+        }
+      else SharedCacheStore(c, NULL, 0, 0);
+    }
+#endif /* SUBTLE */
+
   return list;
 } /* }}} */
 
@@ -406,7 +743,7 @@ subSharedDrawString(Display *disp,
 
       /* Get color values */
       xcolor.pixel = fg;
-      XQueryColor(disp, DefaultColormap(disp, DefaultScreen(disp)), &xcolor);
+      subSharedColorQuery(disp, &xcolor);
 
       color.pixel       = xcolor.pixel;
       color.color.red   = xcolor.red;
@@ -534,6 +871,8 @@ subSharedFontNew(Display *disp,
         }
     }
 
+  if(f) f->name = strdup(name);
+
   return f;
 } /* }}} */
 
@@ -561,6 +900,7 @@ subSharedFontKill(Display *disp,
       XFreeFontSet(disp, f->xfs);
     }
 
+  if(f->name) free(f->name);
   free(f);
 } /* }}} */
 
@@ -577,23 +917,99 @@ unsigned long
 subSharedParseColor(Display *disp,
   char *name)
 {
+  unsigned long hash = 5381;
+  const char *ptr = NULL;
   XColor xcolor = { 0 }; ///< Default color
+  SharedColor *c = NULL;
 
   assert(name);
 
+  /* Check cache */
+  for(ptr = name; *ptr; ptr++)
+    hash = ((hash << 5) + hash) + *ptr;
+
+  if((c = SharedColorFind(COLOR_NAME, hash, name)))
+    return c->xcolor.pixel;
+
   /* Parse and store color */
   if(!XParseColor(disp, DefaultColormap(disp, DefaultScreen(disp)),
       name, &xcolor))
     {
       fprintf(stderr, "<CRITICAL> Failed loading color `%s'\n", name);
     }
-  else if(!XAllocColor(disp, DefaultColormap(disp, DefaultScreen(disp)),
-      &xcolor))
+  else if(!subSharedColorAlloc(disp, &xcolor))
     fprintf(stderr, "<CRITICAL> Failed allocating color `%s'\n", name);
+  else SharedColorAdd(COLOR_NAME, hash, name, &xcolor);
 
   return xcolor.pixel;
 } /* }}} */
 
+ /** subSharedColorAlloc {{{
+  * @brief Allocate color once per RGB value in the default colormap
+  * @param[in]     disp    Display
+  * @param[inout]  xcolor  Color with 16-bit RGB values
+  * @retval  True   Color was allocated
+  * @retval  False  Color could not be allocated
+  **/
+
+int
+subSharedColorAlloc(Display *disp,
+  XColor *xcolor)
+{
+  unsigned long key = 0;
+  SharedColor *c = NULL;
+
+  assert(disp && xcolor);
+
+  /* Normalize to 8-bit per channel */
+  key = ((xcolor->red >> 8) << 16) | ((xcolor->green >> 8) << 8) |
+    (xcolor->blue >> 8);
+
+  if((c = SharedColorFind(COLOR_RGB, key, NULL)))
+    {
+      *xcolor = c->xcolor;
+
+      return True;
+    }
+
+  if(!XAllocColor(disp, DefaultColormap(disp, DefaultScreen(disp)), xcolor))
+    return False;
+
+  /* Store both ways */
+  SharedColorAdd(COLOR_RGB, key, NULL, xcolor);
+
+  if(!SharedColorFind(COLOR_PIXEL, xcolor->pixel, NULL))
+    SharedColorAdd(COLOR_PIXEL, xcolor->pixel, NULL, xcolor);
+
+  return True;
+} /* }}} */
+
+ /** subSharedColorQuery {{{
+  * @brief Get RGB values of pixel from cache or default colormap
+  * @param[in]     disp    Display
+  * @param[inout]  xcolor  Color with pixel
+  **/
+
+void
+subSharedColorQuery(Display *disp,
+  XColor *xcolor)
+{
+  SharedColor *c = NULL;
+
+  assert(disp && xcolor);
+
+  if((c = SharedColorFind(COLOR_PIXEL, xcolor->pixel, NULL)))
+    {
+      *xcolor = c->xcolor;
+
+      return;
+    }
+
+  XQueryColor(disp, DefaultColormap(disp, DefaultScreen(disp)), xcolor);
+
+  SharedColorAdd(COLOR_PIXEL, xcolor->pixel, NULL, xcolor);
+} /* }}} */
+
  /** subSharedParseKey {{{
   * @brief Parse key
   * @param[in]     disp     Display
@@ -749,6 +1165,48 @@ subSharedStringWidth(Display *disp,
   return center ? width - abs(lbearing - rbearing) : width;
 } /* }}} */
 
+ /** subSharedRuntimePath {{{
+  * @brief Get path of runtime files of subtle like the RPC socket
+  * @param[in]     display  Display name
+  * @param[in]     name     File name
+  * @param[inout]  buf      Path buffer
+  * @param[in]     size     Size of buffer
+  * @param[in]     create   Create missing directory
+  * @retval  True   Path is inside of a private directory of the user
+  * @retval  False  Directory is missing or unsafe
+  **/
+
+int
+subSharedRuntimePath(const char *display,
+  const char *name,
+  char *buf,
+  size_t size,
+  int create)
+{
+  size_t len = 0;
+  char *dir = getenv("XDG_RUNTIME_DIR");
+  struct stat st;
+
+  assert(display && name && buf);
+
+  /* Keep files in a private directory per user */
+  if(dir && *dir) snprintf(buf, size, "%s/" PKG_NAME, dir);
+  else snprintf(buf, size, "/tmp/" PKG_NAME "-%d", (int)getuid());
+
+  if(create) mkdir(buf, S_IRWXU);
+
+  /* Refuse directories other users can write to or prepared */
+  if(-1 == lstat(buf, &st) || !S_ISDIR(st.st_mode) ||
+      st.st_uid != getuid() || st.st_mode & (S_IRWXG|S_IRWXO))
+    return False;
+
+  /* Keep files per display */
+  len = strlen(buf);
+  snprintf(buf + len, size - len, "/%s.%s", display, name);
+
+  return True;
+} /* }}} */
+
 #ifndef SUBTLE
 
  /** subSharedMessage {{{
@@ -772,10 +1230,15 @@ subSharedMessage(Display *disp,
 {
   int status = 0;
   XEvent ev;
+  SubBackend *b = NULL;
   long mask = SubstructureRedirectMask|SubstructureNotifyMask;
 
   assert(disp && win);
 
+  /* Hand message directly to subtle when possible */
+  if((b = subSharedBackendGet(disp)) && b->message(win, type, data))
+    return True;
+
   /* Assemble event */
   ev.xclient.type         = ClientMessage;
   ev.xclient.serial       = 0;
@@ -798,6 +1261,97 @@ subSharedMessage(Display *disp,
   return status;
 } /* }}} */
 
+/* Cache */
+
+ /** subSharedPropertyCache {{{
+  * @brief Enable or disable cache of decoded properties
+  * @param[in]  disp    Display
+  * @param[in]  enable  Whether to enable the cache
+  **/
+
+void
+subSharedPropertyCache(Display *disp,
+  int enable)
+{
+  int i;
+  XEvent ev;
+  SharedCache *c = NULL;
+  XWindowAttributes attrs;
+
+  assert(disp);
+
+  if(enable)
+    {
+      cachedisp = disp;
+
+      return;
+    }
+  else if(disp != cachedisp) return;
+
+  /* Stop watching windows and drop everything */
+  for(i = 0; i < CACHESIZE; i++)
+    {
+      while((c = cache[i]))
+        {
+          if(XGetWindowAttributes(disp, c->win, &attrs))
+            XSelectInput(disp, c->win,
+              attrs.your_event_mask & ~CACHEMASK);
+
+          /* Remove remaining entries of window first */
+          SharedCacheDrop(c->win);
+        }
+    }
+
+  /* Discard pending notifies */
+  XSync(disp, False);
+  while(XCheckIfEvent(disp, &ev, SharedCachePredicate, NULL));
+
+  cachedisp = NULL;
+} /* }}} */
+
+ /** subSharedPropertyCached {{{
+  * @brief Check whether property cache is enabled
+  * @param[in]  disp  Display
+  * @retval  True   Cache is enabled
+  * @retval  False  Cache is disabled
+  **/
+
+int
+subSharedPropertyCached(Display *disp)
+{
+  return disp && disp == cachedisp;
+} /* }}} */
+
+/* Backend */
+
+ /** subSharedBackendSet {{{
+  * @brief Set backend of subtle, either in-process or via RPC
+  * @param[in]  b  A #SubBackend
+  **/
+
+void
+subSharedBackendSet(SubBackend *b)
+{
+  backend = b;
+} /* }}} */
+
+ /** subSharedBackendGet {{{
+  * @brief Get backend if it serves given display
+  * @param[in]  disp  Display or \p NULL
+  * @return Returns the #SubBackend or \p NULL
+  **/
+
+SubBackend *
+subSharedBackendGet(Display *disp)
+{
+  /* Only use backend for the display of subtle */
+  if(backend && (!disp ||
+      SharedDisplayEqual(DisplayString(disp), backend->display)))
+    return backend;
+
+  return NULL;
+} /* }}} */
+
 #endif /* SUBTLE */
 
 // vim:ts=2:bs=2:sw=2:et:fdm=marker
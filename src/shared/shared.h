@@ -44,6 +44,9 @@
   __FILE__, __LINE__, #r, r.x, r.y, r.width, r.height);           ///< Print a XRectangle
 
 #define DEFFONT   "-*-*-*-*-*-*-14-*-*-*-*-*-*-*"                 ///< Default font
+#define RPCSIZE   1024                                            ///< Max RPC request payload
+#define CACHESIZE 64                                              ///< Property cache buckets
+#define CACHEMASK (PropertyChangeMask|StructureNotifyMask)        ///< Property cache event mask
 
 #define DATA(d)   ((SubData)d)                                    ///< Cast to SubData
 #define FONT(f)   ((SubFont *)f)                                  ///< Cast to SubFont
@@ -79,6 +82,47 @@
 #define SUB_MATCH_ROLE      (1L << 4)                             ///< Match window role
 #define SUB_MATCH_PID       (1L << 5)                             ///< Match pid
 #define SUB_MATCH_EXACT     (1L << 6)                             ///< Match exact string
+
+/* RPC request types */
+#define SUB_RPC_LIST        1L                                    ///< RPC list clients
+#define SUB_RPC_CURRENT     2L                                    ///< RPC get focus window
+#define SUB_RPC_CLIENT      3L                                    ///< RPC get client
+#define SUB_RPC_VIEW        4L                                    ///< RPC get current view
+#define SUB_RPC_MESSAGE     5L                                    ///< RPC send message
+#define SUB_RPC_SUBSCRIBE   6L                                    ///< RPC subscribe to events
+#define SUB_RPC_EVENT       7L                                    ///< RPC event of subscription
+
+/* Hook slots, shared with the event subscriptions of subtlext */
+#define SUB_SLOT_START      0L                                    ///< Slot start hook
+#define SUB_SLOT_RELOAD     1L                                    ///< Slot reload hook
+#define SUB_SLOT_EXIT       2L                                    ///< Slot exit hook
+#define SUB_SLOT_TILE       3L                                    ///< Slot tile hook
+#define SUB_SLOT_GENERIC    4L                                    ///< Slot count of generic hooks
+#define SUB_SLOT_CLIENT     0L                                    ///< Slot client hooks
+#define SUB_SLOT_VIEW       1L                                    ///< Slot view hooks
+#define SUB_SLOT_TAG        2L                                    ///< Slot tag hooks
+#define SUB_SLOT_TYPES      3L                                    ///< Slot count of hook types
+#define SUB_SLOT_CREATE     0L                                    ///< Slot create action
+#define SUB_SLOT_MODE       1L                                    ///< Slot mode action
+#define SUB_SLOT_GRAVITY    2L                                    ///< Slot gravity action
+#define SUB_SLOT_FOCUS      3L                                    ///< Slot focus action
+#define SUB_SLOT_KILL       4L                                    ///< Slot kill action
+#define SUB_SLOT_ACTIONS    5L                                    ///< Slot count of actions
+#define SUB_SLOT_TOTAL      (SUB_SLOT_GENERIC + \
+  SUB_SLOT_TYPES * SUB_SLOT_ACTIONS)                              ///< Slot count
+#define SUB_SLOT(t,a)       (SUB_SLOT_GENERIC + \
+  (t) * SUB_SLOT_ACTIONS + (a))                                   ///< Slot of type and action
+
+/* Mirror sections */
+#define SUB_MIRROR_VIEW     0L                                    ///< Mirror current view
+#define SUB_MIRROR_HISTORY  1L                                    ///< Mirror focus history
+#define SUB_MIRROR_TAGS     2L                                    ///< Mirror tags
+#define SUB_MIRROR_VIEWS    3L                                    ///< Mirror views
+#define SUB_MIRROR_CLIENTS  4L                                    ///< Mirror clients
+#define SUB_MIRROR_TOTAL    5L                                    ///< Mirror section count
+
+/* Mirror flags */
+#define SUB_MIRROR_CLOSED   (1L << 0)                             ///< Mirror closed by subtle
 /* }}} */
 
 /* Typedefs {{{ */
@@ -91,6 +135,7 @@ typedef union subdata_t /* {{{ */
 typedef struct subfont_t /* {{{ */
 {
   int      y, height;                                             ///< Font y, height
+  char     *name;                                                 ///< Font name
   XFontSet xfs;                                                   ///< Font set
 
 #ifdef HAVE_X11_XFT_XFT_H
@@ -105,6 +150,39 @@ typedef union submessagedata_t /* {{{ */
   short s[10];                                                    ///< MessageData short
   long  l[5];                                                     ///< MessageData long
 } SubMessageData; /* }}} */
+
+typedef struct subbackendclient_t /* {{{ */
+{
+  Window     win;                                                 ///< Client window
+  int        flags, tags, gravity;                                ///< Client EWMH flags, tags and gravity id
+  char       *name, *instance, *klass, *role;                     ///< Client names
+  XRectangle geom;                                                ///< Client geometry
+} SubBackendClient; /* }}} */
+
+typedef struct subbackend_t /* {{{ */
+{
+  char   *display;                                                ///< Backend display name
+  int    (*list)(SubBackendClient **recs);                        ///< Get client list
+  Window (*current)(void);                                        ///< Get focus window
+  int    (*client)(Window win, SubBackendClient *c);              ///< Get client values
+  int    (*view)(char **name);                                    ///< Get current view
+  int    (*message)(Window win, char *type, SubMessageData data); ///< Handle client message
+  int    (*tags)(char ***names);                                  ///< Get tag names
+  int    (*views)(char ***names, int **tags);                     ///< Get view names and tags
+  unsigned int (*generation)(void);                               ///< Get state generation
+} SubBackend; /* }}} */
+
+typedef struct subrpcheader_t /* {{{ */
+{
+  int type, len;                                                  ///< RPC request type or status, payload length
+} SubRpcHeader; /* }}} */
+
+typedef struct submirror_t /* {{{ */
+{
+  unsigned int seq, generation;                                   ///< Mirror sequence lock and generation
+  int          flags, size, len;                                  ///< Mirror flags, segment size and data length
+  int          sections[SUB_MIRROR_TOTAL];                        ///< Mirror section offsets
+} SubMirror; /* }}} */
 /* }}} */
 
 /* Memory {{{ */
@@ -151,11 +229,15 @@ void subSharedFontKill(Display *disp, SubFont *f);                ///< Kill font
 
 /* Misc {{{ */
 unsigned long subSharedParseColor(Display *disp, char *name);     ///< Parse color
+int subSharedColorAlloc(Display *disp, XColor *xcolor);            ///< Allocate cached color
+void subSharedColorQuery(Display *disp, XColor *xcolor);          ///< Query cached color
 KeySym subSharedParseKey(Display *disp, const char *key,
   unsigned int *code, unsigned int *state, int *mouse);           ///< Parse keys
 pid_t subSharedSpawn(char *cmd);                                  ///< Spawn command
 int subSharedStringWidth(Display *disp, SubFont *f,
   const char *text, int len, int *left, int *right, int center);  ///< Get text width
+int subSharedRuntimePath(const char *display, const char *name,
+  char *buf, size_t size, int create);                            ///< Get runtime file path
 /* }}} */
 
 #ifndef SUBTLE
@@ -165,6 +247,16 @@ int subSharedMessage(Display *disp, Window win, char *type,
   SubMessageData data, int format, int xsync);                    ///< Send client message
 /* }}} */
 
+/* Cache {{{ */
+void subSharedPropertyCache(Display *disp, int enable);           ///< Toggle property cache
+int subSharedPropertyCached(Display *disp);                       ///< Whether cache is enabled
+/* }}} */
+
+/* Backend {{{ */
+void subSharedBackendSet(SubBackend *b);                          ///< Set backend
+SubBackend *subSharedBackendGet(Display *disp);                   ///< Get backend
+/* }}} */
+
 #endif /* SUBTLE */
 
 #endif /* SHARED_H */
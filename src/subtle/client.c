@@ -10,6 +10,8 @@
   * See the file COPYING for details.
   **/
 
+#include <sys/time.h>
+#include <sys/select.h>
 #include <X11/Xatom.h>
 #include "subtle.h"
 
@@ -29,6 +31,16 @@ typedef struct clientmwmhints_t
   long input_mode;
   unsigned long status;
 } ClientMWMHints;
+
+typedef struct clientsync_t
+{
+  int pending;
+  long time;
+#ifdef HAVE_X11_EXTENSIONS_SYNC_H
+  XSyncAlarm alarm;
+  XSyncValue value;
+#endif /* HAVE_X11_EXTENSIONS_SYNC_H */
+} ClientSync;
 /* }}} */
 
 /* Private */
@@ -60,6 +72,182 @@ ClientGravity(void)
   return grav;
 } /* }}} */
 
+/* ClientTime {{{ */
+static long
+ClientTime(void)
+{
+  struct timeval tv;
+
+  gettimeofday(&tv, 0);
+
+  return tv.tv_sec * 1000 + tv.tv_usec / 1000;
+} /* }}} */
+
+/* ClientInterval {{{ */
+static long
+ClientInterval(void)
+{
+  int rate = 0;
+
+#ifdef HAVE_X11_EXTENSIONS_XRANDR_H
+  /* Get refresh rate of current mode */
+  if(subtle->flags & SUB_SUBTLE_XRANDR)
+    {
+      XRRScreenConfiguration *conf = NULL;
+
+      if((conf = XRRGetScreenInfo(subtle->dpy, ROOT)))
+        {
+          rate = XRRConfigCurrentRate(conf);
+
+          XRRFreeScreenConfigInfo(conf);
+        }
+    }
+#endif /* HAVE_X11_EXTENSIONS_XRANDR_H */
+
+  return 1000 / (0 < rate ? rate : DRAGRATE);
+} /* }}} */
+
+/* ClientWait {{{ */
+static void
+ClientWait(long msecs)
+{
+  int fd = ConnectionNumber(subtle->dpy);
+  fd_set fdset;
+  struct timeval tv;
+
+  /* Wait for new events or timeout */
+  FD_ZERO(&fdset);
+  FD_SET(fd, &fdset);
+
+  if(0 > msecs) msecs = 0;
+
+  tv.tv_sec  = msecs / 1000;
+  tv.tv_usec = (msecs % 1000) * 1000;
+
+  select(fd + 1, &fdset, NULL, NULL, &tv);
+} /* }}} */
+
+/* ClientSyncInit {{{ */
+static void
+ClientSyncInit(SubClient *c,
+  ClientSync *sync)
+{
+  sync->pending = False;
+  sync->time    = 0;
+
+#ifdef HAVE_X11_EXTENSIONS_SYNC_H
+  sync->alarm = None;
+
+  /* Start with current counter value */
+  if(subtle->flags & SUB_SUBTLE_XSYNC && c->counter)
+    {
+      if(XSyncQueryCounter(subtle->dpy, c->counter, &sync->value))
+        {
+          XSyncAlarmAttributes attrs;
+
+          /* Create alarm that fires once the client caught up */
+          attrs.trigger.counter    = c->counter;
+          attrs.trigger.value_type = XSyncAbsolute;
+          attrs.trigger.wait_value = sync->value;
+          attrs.trigger.test_type  = XSyncPositiveComparison;
+          attrs.events             = True;
+
+          XSyncIntToValue(&attrs.delta, 0);
+
+          sync->alarm = XSyncCreateAlarm(subtle->dpy, XSyncCACounter|
+            XSyncCAValueType|XSyncCAValue|XSyncCATestType|XSyncCADelta|
+            XSyncCAEvents, &attrs);
+        }
+      else c->counter = None;
+    }
+#endif /* HAVE_X11_EXTENSIONS_SYNC_H */
+} /* }}} */
+
+/* ClientSyncFinish {{{ */
+static void
+ClientSyncFinish(ClientSync *sync)
+{
+#ifdef HAVE_X11_EXTENSIONS_SYNC_H
+  if(None != sync->alarm)
+    {
+      XSyncDestroyAlarm(subtle->dpy, sync->alarm);
+
+      sync->alarm = None;
+    }
+#endif /* HAVE_X11_EXTENSIONS_SYNC_H */
+} /* }}} */
+
+/* ClientSyncRequest {{{ */
+static void
+ClientSyncRequest(SubClient *c,
+  ClientSync *sync)
+{
+#ifdef HAVE_X11_EXTENSIONS_SYNC_H
+  if(subtle->flags & SUB_SUBTLE_XSYNC && c->counter && None != sync->alarm)
+    {
+      int overflow = 0;
+      XEvent ev;
+      XSyncValue one;
+      XSyncAlarmAttributes attrs;
+
+      /* Increase expected counter value */
+      XSyncIntToValue(&one, 1);
+      XSyncValueAdd(&sync->value, sync->value, one, &overflow);
+
+      /* Re-arm alarm for new value */
+      attrs.trigger.wait_value = sync->value;
+
+      XSyncChangeAlarm(subtle->dpy, sync->alarm, XSyncCAValue, &attrs);
+
+      /* Assemble event */
+      ev.xclient.type         = ClientMessage;
+      ev.xclient.window       = c->win;
+      ev.xclient.message_type = subEwmhGet(SUB_EWMH_WM_PROTOCOLS);
+      ev.xclient.format       = 32;
+      ev.xclient.data.l[0]    = subEwmhGet(SUB_EWMH_NET_WM_SYNC_REQUEST);
+      ev.xclient.data.l[1]    = CurrentTime;
+      ev.xclient.data.l[2]    = XSyncValueLow32(sync->value);
+      ev.xclient.data.l[3]    = XSyncValueHigh32(sync->value);
+      ev.xclient.data.l[4]    = 0;
+
+      XSendEvent(subtle->dpy, c->win, False, NoEventMask, &ev);
+
+      sync->pending = True;
+      sync->time    = ClientTime();
+    }
+#endif /* HAVE_X11_EXTENSIONS_SYNC_H */
+} /* }}} */
+
+/* ClientSyncDone {{{ */
+static int
+ClientSyncDone(ClientSync *sync)
+{
+#ifdef HAVE_X11_EXTENSIONS_SYNC_H
+  if(sync->pending)
+    {
+      XEvent ev;
+
+      /* Check queued alarm events without a round trip */
+      while(XCheckTypedEvent(subtle->dpy,
+          subtle->xsync + XSyncAlarmNotify, &ev))
+        {
+          XSyncAlarmNotifyEvent *aev = (XSyncAlarmNotifyEvent *)&ev;
+
+          /* Skip late alarms of earlier requests */
+          if(aev->alarm == sync->alarm &&
+              XSyncValueGreaterOrEqual(aev->counter_value, sync->value))
+            sync->pending = False;
+        }
+
+      /* Give up when client took too long */
+      if(SYNCTIME < ClientTime() - sync->time)
+        sync->pending = False;
+    }
+#endif /* HAVE_X11_EXTENSIONS_SYNC_H */
+
+  return !sync->pending;
+} /* }}} */
+
 /* ClientBounds {{{ */
 static void
 ClientBounds(SubClient *c,
@@ -497,6 +685,8 @@ subClientFocus(SubClient *c,
 
   if(!VISIBLE(c)) return;
 
+  subtle->flags |= SUB_SUBTLE_DIRTY; ///< Update state mirror
+
   /* Remove urgent after getting focus */
   if(c->flags & SUB_CLIENT_MODE_URGENT)
     {
@@ -653,9 +843,12 @@ subClientDrag(SubClient *c,
   Window root = None, win = None;
   unsigned int mask = 0;
   int loop = True, edge = 0, fx = 0, fy = 0, dx = 0, dy = 0;
-  int wx = 0, wy = 0, ww = 0, wh = 0, rx = 0, ry = 0;
+  int wx = 0, wy = 0, ww = 0, wh = 0, rx = 0, ry = 0, dirty = False;
+  int opaque = (subtle->flags & SUB_SUBTLE_OPAQUE);
+  long last = 0, interval = 0;
   SubScreen *s = NULL;
   XRectangle geom = { 0 };
+  ClientSync sync = { 0 };
   Cursor cursor;
 
   DEAD(c);
@@ -708,10 +901,9 @@ subClientDrag(SubClient *c,
         break;
     } /* }}} */
 
-  /* Grab pointer server */
+  /* Grab pointer */
   XGrabPointer(subtle->dpy, c->win, True, GRABMASK, GrabModeAsync,
     GrabModeAsync, None, cursor, CurrentTime);
-  XGrabServer(subtle->dpy);
 
   switch(direction)
     {
@@ -754,12 +946,60 @@ subClientDrag(SubClient *c,
         ClientBounds(c, &(s->geom), &c->geom, False, False);
         break; /* }}}*/
       default: /* {{{ */
-        ClientMask(&geom);
+        /* Either move window live or draw mask on grabbed server */
+        if(opaque)
+          {
+            interval = ClientInterval();
+
+            ClientSyncInit(c, &sync);
+          }
+        else
+          {
+            XGrabServer(subtle->dpy);
+            ClientMask(&geom);
+          }
 
         /* Start event loop */
         while(loop)
           {
-            XMaskEvent(subtle->dpy, DRAGMASK, &ev);
+            /* Apply latest geometry once per frame */
+            if(dirty && ClientSyncDone(&sync) &&
+                ClientTime() >= last + interval)
+              {
+                XRectangle r = geom;
+
+                /* Subtract border width */
+                if(!(c->flags & SUB_CLIENT_MODE_BORDERLESS))
+                  {
+                    r.x -= subtle->styles.clients.border.top;
+                    r.y -= subtle->styles.clients.border.top;
+                  }
+
+                if(SUB_DRAG_RESIZE == mode) ClientSyncRequest(c, &sync);
+
+                XMoveResizeWindow(subtle->dpy, c->win, r.x, r.y,
+                  r.width, r.height);
+                XFlush(subtle->dpy);
+
+                last  = ClientTime();
+                dirty = False;
+              }
+
+            /* Wait for events or until next frame is due */
+            if(dirty)
+              {
+                if(!XCheckMaskEvent(subtle->dpy, DRAGMASK, &ev))
+                  {
+                    /* Sleep until next frame or sync alarm/timeout */
+                    if(ClientSyncDone(&sync))
+                      ClientWait(last + interval - ClientTime());
+                    else ClientWait(sync.time + SYNCTIME - ClientTime());
+
+                    continue;
+                  }
+              }
+            else XMaskEvent(subtle->dpy, DRAGMASK, &ev);
+
             switch(ev.type)
               {
                 case EnterNotify:   win = ev.xcrossing.window; break; ///< Find destination window
@@ -769,12 +1009,16 @@ subClientDrag(SubClient *c,
                 case MotionNotify: /* {{{ */
                   if(mode & (SUB_DRAG_MOVE|SUB_DRAG_RESIZE))
                     {
+                      /* Compress motion to latest position */
+                      if(opaque)
+                        while(XCheckTypedEvent(subtle->dpy, MotionNotify, &ev));
+
                       /* Check values */
                       if(!XYINRECT(ev.xmotion.x_root - dx,
                           ev.xmotion.y_root - dy, s->geom))
                         continue;
 
-                      ClientMask(&geom);
+                      if(!opaque) ClientMask(&geom);
 
                       /* Calculate selection rect */
                       switch(mode)
@@ -814,13 +1058,19 @@ subClientDrag(SubClient *c,
                             break; /* }}} */
                         }
 
-                      ClientMask(&geom);
+                      if(opaque) dirty = True;
+                      else ClientMask(&geom);
                     }
                   break; /* }}} */
               }
           }
 
-        ClientMask(&geom); ///< Erase mask
+        if(!opaque)
+          {
+            ClientMask(&geom); ///< Erase mask
+            XUngrabServer(subtle->dpy);
+          }
+        else ClientSyncFinish(&sync);
 
         /* Subtract border width */
         if(!(c->flags & SUB_CLIENT_MODE_BORDERLESS))
@@ -835,9 +1085,10 @@ subClientDrag(SubClient *c,
   XMoveResizeWindow(subtle->dpy, c->win, c->geom.x, c->geom.y,
     c->geom.width, c->geom.height);
 
-  /* Remove grabs */
+  subtle->flags |= SUB_SUBTLE_DIRTY; ///< Update state mirror
+
+  /* Remove grab */
   XUngrabPointer(subtle->dpy, CurrentTime);
-  XUngrabServer(subtle->dpy);
 } /* }}} */
 
  /** subClientTag {{{
@@ -858,6 +1109,8 @@ subClientTag(SubClient *c,
   DEAD(c);
   assert(c);
 
+  subtle->flags |= SUB_SUBTLE_DIRTY; ///< Update state mirror
+
   /* Update flags and tags */
   if((t = TAG(subArrayGet(subtle->tags, tag))))
     {
@@ -920,6 +1173,8 @@ subClientRetag(SubClient *c,
   DEAD(c);
   assert(c);
 
+  subtle->flags |= SUB_SUBTLE_DIRTY; ///< Update state mirror
+
   c->tags = 0; ///< Reset tags
 
   /* Check matching tags */
@@ -966,6 +1221,8 @@ subClientResize(SubClient *c,
   DEAD(c);
   assert(c);
 
+  subtle->flags |= SUB_SUBTLE_DIRTY; ///< Update state mirror
+
   /* Honor size hints */
   if(size_hints) ClientBounds(c, bounds, &c->geom, False, False);
 
@@ -1042,6 +1299,8 @@ subClientArrange(SubClient *c,
   DEAD(c);
   assert(c && s);
 
+  subtle->flags |= SUB_SUBTLE_DIRTY; ///< Update state mirror
+
   /* Check flags */
   if(c->flags & SUB_CLIENT_MODE_FULL)
     {
@@ -1162,6 +1421,8 @@ subClientToggle(SubClient *c,
   DEAD(c);
   assert(c);
 
+  subtle->flags |= SUB_SUBTLE_DIRTY; ///< Update state mirror
+
   /* Set arrange flags for certain modes */
   if(flags & (SUB_CLIENT_MODE_FLOAT|SUB_CLIENT_MODE_STICK|SUB_CLIENT_MODE_FULL|
       SUB_CLIENT_MODE_ZAPHOD|SUB_CLIENT_MODE_BORDERLESS|SUB_CLIENT_MODE_CENTER))
@@ -1396,6 +1657,21 @@ subClientSetProtocols(SubClient *c)
             {
               case SUB_EWMH_WM_TAKE_FOCUS:    c->flags |= SUB_CLIENT_FOCUS; break;
               case SUB_EWMH_WM_DELETE_WINDOW: c->flags |= SUB_CLIENT_CLOSE; break;
+              case SUB_EWMH_NET_WM_SYNC_REQUEST: /* {{{ */
+                {
+                  XID *counter = NULL;
+
+                  /* Get sync request counter */
+                  if((counter = (XID *)subSharedPropertyGet(subtle->dpy,
+                      c->win, XA_CARDINAL,
+                      subEwmhGet(SUB_EWMH_NET_WM_SYNC_REQUEST_COUNTER), NULL)))
+                    {
+                      c->counter = *counter;
+
+                      free(counter);
+                    }
+                }
+                break; /* }}} */
               default: break;
             }
          }
@@ -1795,6 +2071,7 @@ subClientKill(SubClient *c)
   /* Hook: Kill */
   subHookCall((SUB_HOOK_TYPE_CLIENT|SUB_HOOK_ACTION_KILL),
     (void *)c);
+  subRubyReleaseObject((void *)c);
 
   /* Remove _NET_WM_STATE (see EWMH 1.3) */
   subSharedPropertyDelete(subtle->dpy, c->win,
@@ -1842,6 +2119,8 @@ subClientPublish(int restack)
   Window *wins = (Window *)subSharedMemoryAlloc(subtle->clients->ndata,
     sizeof(Window));
 
+  subtle->flags |= SUB_SUBTLE_DIRTY; ///< Update state mirror
+
   /* Sort clients from top (=> 0) to bottom */
   for(i = 0; i < subtle->clients->ndata; i++)
     wins[subtle->clients->ndata - 1 - i] = CLIENT(subtle->clients->data[i])->win;
@@ -129,9 +129,11 @@ subDisplayInit(const char *display)
   XSetWindowAttributes sattrs;
   unsigned long mask = 0;
 
-#if defined HAVE_X11_EXTENSIONS_XINERAMA_H || defined HAVE_X11_EXTENSIONS_XRANDR_H
+#if defined HAVE_X11_EXTENSIONS_XINERAMA_H || \
+  defined HAVE_X11_EXTENSIONS_XRANDR_H || defined HAVE_X11_EXTENSIONS_SYNC_H
   int event = 0, junk = 0;
-#endif /* HAVE_X11_EXTENSIONS_XINERAMA_H HAVE_X11_EXTENSIONS_XRANDR_H */
+#endif /* HAVE_X11_EXTENSIONS_XINERAMA_H HAVE_X11_EXTENSIONS_XRANDR_H
+  HAVE_X11_EXTENSIONS_SYNC_H */
 
   assert(subtle);
 
@@ -223,6 +225,15 @@ subDisplayInit(const char *display)
 #endif /* HAVE_X11_EXTENSIONS_XRANDR_H */
     subtle->flags &= ~SUB_SUBTLE_XRANDR;
 
+#ifdef HAVE_X11_EXTENSIONS_SYNC_H
+  if(XSyncQueryExtension(subtle->dpy, &event, &junk) &&
+      XSyncInitialize(subtle->dpy, &junk, &junk))
+    {
+      subtle->flags |= SUB_SUBTLE_XSYNC;
+      subtle->xsync  = event;
+    }
+#endif /* HAVE_X11_EXTENSIONS_SYNC_H */
+
   XSync(subtle->dpy, False);
 
   printf("Display (%s) is %dx%d\n", DisplayString(subtle->dpy),
@@ -16,7 +16,8 @@
 #include "subtle.h"
 
 #ifdef HAVE_SYS_INOTIFY_H
-#define BUFLEN (sizeof(struct inotify_event))
+#include <limits.h>
+#define BUFLEN (sizeof(struct inotify_event) + NAME_MAX + 1)
 #endif /* HAVE_SYS_INOTIFY_H */
 
 #ifdef HAVE_X11_EXTENSIONS_XRANDR_H
@@ -308,6 +309,9 @@ EventCrossing(XCrossingEvent *ev)
   SubClient *c = NULL;
   SubScreen *s = NULL;
 
+  /* Pointer may have moved the current screen */
+  if(1 < subtle->screens->ndata) subtle->flags |= SUB_SUBTLE_DIRTY;
+
   /* Handle both crossing events */
   switch(ev->type)
     {
@@ -395,7 +399,12 @@ EventDestroy(XDestroyWindowEvent *ev)
 static void
 EventExpose(XExposeEvent *ev)
 {
-  if(0 == ev->count) subScreenRender(); ///< Render once
+  SubScreen *s = NULL;
+
+  /* Repaint damaged panel area or render once */
+  if((s = SCREEN(subSubtleFind(ev->window, SCREENID))))
+    subScreenExpose(s, ev);
+  else if(0 == ev->count) subScreenRender();
 
   subSubtleLogDebugEvents("Expose: win=%#lx\n", ev->window);
 } /* }}} */
@@ -1488,6 +1497,8 @@ EventProperty(XPropertyEvent *ev)
             if(c->name) free(c->name);
             subSharedPropertyName(subtle->dpy, c->win, &c->name, c->klass);
 
+            subtle->flags |= SUB_SUBTLE_DIRTY; ///< Update state mirror
+
             if(subtle->windows.focus[0] == c->win)
               {
                 subScreenUpdate();
@@ -1656,6 +1667,43 @@ EventUnmap(XUnmapEvent *ev)
   subSubtleLogDebugEvents("Unmap: win=%#lx\n", ev->window);
 } /* }}} */
 
+/* EventDispatch {{{ */
+static void
+EventDispatch(void)
+{
+  XEvent ev;
+
+  subRubyBusy(True); ///< Defer GC during handlers
+
+  while(XPending(subtle->dpy)) ///< X events
+    {
+      XNextEvent(subtle->dpy, &ev);
+      switch(ev.type)
+        {
+          case ColormapNotify:    EventColormap(&ev.xcolormap);                 break;
+          case ConfigureNotify:   EventConfigure(&ev.xconfigure);               break;
+          case ConfigureRequest:  EventConfigureRequest(&ev.xconfigurerequest); break;
+          case EnterNotify:
+          case LeaveNotify:       EventCrossing(&ev.xcrossing);                 break;
+          case DestroyNotify:     EventDestroy(&ev.xdestroywindow);             break;
+          case Expose:            EventExpose(&ev.xexpose);                     break;
+          case FocusIn:           EventFocus(&ev.xfocus);                       break;
+          case ButtonPress:
+          case KeyPress:          EventGrab(&ev);                               break;
+          case MapNotify:         EventMap(&ev.xmap);                           break;
+          case MappingNotify:     EventMapping(&ev.xmapping);                   break;
+          case MapRequest:        EventMapRequest(&ev.xmaprequest);             break;
+          case ClientMessage:     EventMessage(&ev.xclient);                    break;
+          case PropertyNotify:    EventProperty(&ev.xproperty);                 break;
+          case SelectionClear:    EventSelection(&ev.xselectionclear);          break;
+          case UnmapNotify:       EventUnmap(&ev.xunmap);                       break;
+          default: break;
+        }
+    }
+
+  subRubyBusy(False);
+} /* }}} */
+
 /* Public */
 
  /** subEventWatchAdd {{{
@@ -1700,6 +1748,28 @@ subEventWatchDel(int fd)
     nwatches * sizeof(struct pollfd));
 } /* }}} */
 
+ /** subEventWatchWrite {{{
+  * @brief Toggle write readiness for fd in watch list
+  * @param[in]  fd      File descriptor
+  * @param[in]  enable  Whether to wait for POLLOUT
+  **/
+
+void
+subEventWatchWrite(int fd,
+  int enable)
+{
+  int i;
+
+  for(i = 0; i < nwatches; i++)
+    {
+      if(watches[i].fd == fd)
+        {
+          watches[i].events = enable ? POLLIN|POLLOUT : POLLIN;
+          break;
+        }
+    }
+} /* }}} */
+
  /** subEventLoop {{{
   * @brief Event all X events
   **/
@@ -1708,7 +1778,6 @@ void
 subEventLoop(void)
 {
   int i, timeout = 1, nevents = 0;
-  XEvent ev;
   time_t now;
   SubPanel *p = NULL;
   SubClient *c = NULL;
@@ -1728,6 +1797,7 @@ subEventLoop(void)
 #ifdef HAVE_SYS_INOTIFY_H
   subEventWatchAdd(subtle->notify);
 #endif /* HAVE_SYS_INOTIFY_H */
+  subRpcInit();
 
   /* Set tray selection */
   if(subtle->flags & SUB_SUBTLE_TRAY) subTraySelect();
@@ -1763,6 +1833,13 @@ subEventLoop(void)
             subTraySelect();
         }
 
+      /* Handle events put back into the queue */
+      if(0 < XQLength(subtle->dpy)) EventDispatch();
+
+      /* Publish state and collect garbage before waiting */
+      subRpcPublish();
+      if(!XPending(subtle->dpy)) subRubyIdle();
+
       /* Data ready on any connection */
       if(0 < (nevents = poll(watches, nwatches, timeout * 1000)))
         {
@@ -1772,43 +1849,29 @@ subEventLoop(void)
                 {
                   if(watches[i].fd == ConnectionNumber(subtle->dpy)) ///< X events {{{
                     {
-                      while(XPending(subtle->dpy)) ///< X events
-                        {
-                          XNextEvent(subtle->dpy, &ev);
-                          switch(ev.type)
-                            {
-                              case ColormapNotify:    EventColormap(&ev.xcolormap);                 break;
-                              case ConfigureNotify:   EventConfigure(&ev.xconfigure);               break;
-                              case ConfigureRequest:  EventConfigureRequest(&ev.xconfigurerequest); break;
-                              case EnterNotify:
-                              case LeaveNotify:       EventCrossing(&ev.xcrossing);                 break;
-                              case DestroyNotify:     EventDestroy(&ev.xdestroywindow);             break;
-                              case Expose:            EventExpose(&ev.xexpose);                     break;
-                              case FocusIn:           EventFocus(&ev.xfocus);                       break;
-                              case ButtonPress:
-                              case KeyPress:          EventGrab(&ev);                               break;
-                              case MapNotify:         EventMap(&ev.xmap);                           break;
-                              case MappingNotify:     EventMapping(&ev.xmapping);                   break;
-                              case MapRequest:        EventMapRequest(&ev.xmaprequest);             break;
-                              case ClientMessage:     EventMessage(&ev.xclient);                    break;
-                              case PropertyNotify:    EventProperty(&ev.xproperty);                 break;
-                              case SelectionClear:    EventSelection(&ev.xselectionclear);          break;
-                              case UnmapNotify:       EventUnmap(&ev.xunmap);                       break;
-                              default: break;
-                            }
-                        }
+                      EventDispatch();
                     } /* }}} */
 #ifdef HAVE_SYS_INOTIFY_H
                   else if(watches[i].fd == subtle->notify) ///< Inotify {{{
                     {
-                      if(0 < read(subtle->notify, buf, BUFLEN)) ///< Inotify events
-                        {
-                          struct inotify_event *event = (struct inotify_event *)&buf[0];
+                      ssize_t len = 0, off = 0;
 
-                          /* Skip unwatch events */
-                          if(event && IN_IGNORED != event->mask)
+                      if(0 < (len = read(subtle->notify, buf, BUFLEN))) ///< Inotify events
+                        {
+                          for(off = 0; off < len; off += sizeof(struct inotify_event) +
+                              ((struct inotify_event *)&buf[off])->len)
                             {
-                              if((p = PANEL(subSubtleFind(
+                              struct inotify_event *event = (struct inotify_event *)&buf[off];
+
+                              /* Skip unwatch events */
+                              if(IN_IGNORED == event->mask) continue;
+
+                              /* Changed sublet file */
+                              if(event->wd == subtle->watch)
+                                {
+                                  if(0 < event->len) subRubyReloadSublet(event->name);
+                                }
+                              else if((p = PANEL(subSubtleFind(
                                   subtle->windows.support, event->wd))))
                                 {
                                   subRubyCall(SUB_CALL_WATCH,
@@ -1820,6 +1883,11 @@ subEventLoop(void)
                         }
                     } /* }}} */
 #endif /* HAVE_SYS_INOTIFY_H */
+                  else if(subRpcHandle(watches[i].fd)) ///< RPC {{{
+                    {
+                      /* Handle messages before next request */
+                      if(0 < XQLength(subtle->dpy)) EventDispatch();
+                    } /* }}} */
                   else ///< Socket {{{
                     {
                       if((p = PANEL(subSubtleFind(subtle->windows.support,
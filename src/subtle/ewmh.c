@@ -30,8 +30,9 @@ typedef struct xembedinfo_t
 void
 subEwmhInit(void)
 {
-  int len = 0;
+  int i, len = 0, nsupported = 0;
   long data[2] = { 0, 0 }, pid = (long)getpid();
+  Atom supported[SUB_EWMH_TOTAL];
   char *selection = NULL, *names[] =
   {
     /* ICCCM */
@@ -44,7 +45,8 @@ subEwmhInit(void)
     "_NET_NUMBER_OF_DESKTOPS", "_NET_DESKTOP_NAMES", "_NET_DESKTOP_GEOMETRY",
     "_NET_DESKTOP_VIEWPORT", "_NET_CURRENT_DESKTOP", "_NET_ACTIVE_WINDOW",
     "_NET_WORKAREA", "_NET_SUPPORTING_WM_CHECK", "_NET_WM_FULL_PLACEMENT",
-    "_NET_FRAME_EXTENTS",
+    "_NET_FRAME_EXTENTS", "_NET_WM_SYNC_REQUEST",
+    "_NET_WM_SYNC_REQUEST_COUNTER",
 
     /* Client */
     "_NET_CLOSE_WINDOW", "_NET_RESTACK_WINDOW", "_NET_MOVERESIZE_WINDOW",
@@ -101,9 +103,19 @@ subEwmhInit(void)
 
   free(selection);
 
-  /* EWMH: Supported hints */
+  /* EWMH: Supported hints, sync requests only with XSync */
+  for(i = 0; i < SUB_EWMH_TOTAL; i++)
+    {
+      if(!(subtle->flags & SUB_SUBTLE_XSYNC) &&
+          (SUB_EWMH_NET_WM_SYNC_REQUEST == i ||
+          SUB_EWMH_NET_WM_SYNC_REQUEST_COUNTER == i))
+        continue;
+
+      supported[nsupported++] = atoms[i];
+    }
+
   XChangeProperty(subtle->dpy, ROOT, atoms[SUB_EWMH_NET_SUPPORTED], XA_ATOM,
-    32, PropModeReplace, (unsigned char *)&atoms, SUB_EWMH_TOTAL);
+    32, PropModeReplace, (unsigned char *)supported, nsupported);
 
   /* EWMH: Window manager information */
   subEwmhSetWindows(ROOT, SUB_EWMH_NET_SUPPORTING_WM_CHECK,
@@ -80,6 +80,8 @@ subGravityKill(SubGravity *g)
 {
   assert(g);
 
+  subRubyReleaseObject((void *)g);
+
   free(g);
 
   subSubtleLogDebugSubtle("Kill\n");
@@ -12,6 +12,34 @@
 
 #include "subtle.h"
 
+/* Private */
+
+/* HookSlot {{{ */
+static int
+HookSlot(int type)
+{
+  int i, j;
+
+  /* Generic hooks: start, reload, exit and tile */
+  for(i = 0; i < SUB_SLOT_GENERIC; i++)
+    if(type == (SUB_HOOK_START << i)) return SUB_SLOT_START + i;
+
+  /* Object hooks: client, view and tag with their actions */
+  for(i = 0; i < SUB_SLOT_TYPES; i++)
+    {
+      if(type & (SUB_HOOK_TYPE_CLIENT << i))
+        {
+          for(j = 0; j < SUB_SLOT_ACTIONS; j++)
+            if(type & (SUB_HOOK_ACTION_CREATE << j))
+              return SUB_SLOT(SUB_SLOT_CLIENT + i, SUB_SLOT_CREATE + j);
+        }
+    }
+
+  return -1;
+} /* }}} */
+
+/* Public */
+
  /** subHookNew {{{
   * @brief Create new hook
   * @param[in]  type  Type of hook
@@ -29,14 +57,59 @@ subHookNew(int type,
 
   /* Create new hook */
   h = HOOK(subSharedMemoryAlloc(1, sizeof(SubHook)));
-  h->flags = (SUB_TYPE_HOOK|type);
-  h->proc  = proc;
+  h->flags  = (SUB_TYPE_HOOK|type);
+  h->proc   = proc;
+  h->filter = NULL;
 
   subSubtleLogDebugSubtle("new=hook, type=%d, proc=%ld\n", type, proc);
 
   return h;
 } /* }}} */
 
+ /** subHookAdd {{{
+  * @brief Add hook to hook list and type index
+  * @param[in]  h  A #SubHook
+  **/
+
+void
+subHookAdd(SubHook *h)
+{
+  int slot = -1;
+
+  assert(h);
+
+  subArrayPush(subtle->hooks, (void *)h);
+
+  /* Add to index */
+  if(-1 != (slot = HookSlot(h->flags & ~SUB_TYPE_HOOK)))
+    {
+      /* Create on demand to safe memory */
+      if(NULL == subtle->hookmap[slot])
+        subtle->hookmap[slot] = subArrayNew();
+
+      subArrayPush(subtle->hookmap[slot], (void *)h);
+    }
+} /* }}} */
+
+ /** subHookRemove {{{
+  * @brief Remove hook from hook list and type index
+  * @param[in]  h  A #SubHook
+  **/
+
+void
+subHookRemove(SubHook *h)
+{
+  int slot = -1;
+
+  assert(h);
+
+  subArrayRemove(subtle->hooks, (void *)h);
+
+  if(-1 != (slot = HookSlot(h->flags & ~SUB_TYPE_HOOK)) &&
+      subtle->hookmap[slot])
+    subArrayRemove(subtle->hookmap[slot], (void *)h);
+} /* }}} */
+
  /** subHookCall {{{
   * @brief Emit a hook
   * @param[in]  type  Type of hook
@@ -47,20 +120,30 @@ void
 subHookCall(int type,
   void *data)
 {
-  int i;
+  int i, slot = -1;
+  SubArray *hooks = NULL;
+
+  if(subtle->flags & SUB_SUBTLE_MUTE || -1 == (slot = HookSlot(type)))
+    return;
+
+  subRpcEvent(slot, data); ///< Notify external subscribers
+
+  if(NULL == (hooks = subtle->hookmap[slot])) return;
 
   /* Call matching hooks */
-  for(i = 0; i < subtle->hooks->ndata; i++)
+  for(i = 0; i < hooks->ndata; i++)
     {
-      SubHook *h = HOOK(subtle->hooks->data[i]);
+      SubHook *h = HOOK(hooks->data[i]);
 
-      if((h->flags & ~SUB_TYPE_HOOK) == type)
-        {
-          subRubyCall(SUB_CALL_HOOKS, h->proc, data);
+      /* Check client filter before entering ruby */
+      if(h->filter && !(data && subTagMatcherCheck(h->filter,
+          CLIENT(data))))
+        continue;
 
-          subSubtleLogDebug("call=hook, type=%d, proc=%ld, data=%p\n",
-            type, h->proc, data);
-        }
+      subRubyCall(SUB_CALL_HOOK, (unsigned long)h, data);
+
+      subSubtleLogDebug("call=hook, type=%d, proc=%ld, data=%p\n",
+        type, h->proc, data);
     }
 } /* }}} */
 
@@ -74,6 +157,14 @@ subHookKill(SubHook *h)
 {
   assert(h);
 
+  /* Remove filter */
+  if(h->filter)
+    {
+      subTagMatcherClear(h->filter);
+      free(h->filter->name);
+      free(h->filter);
+    }
+
   free(h);
 
   subSubtleLogDebugSubtle("kill=hook\n");
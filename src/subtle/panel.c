@@ -480,6 +480,54 @@ subPanelRender(SubPanel *p,
   subSubtleLogDebugSubtle("Render\n");
 } /* }}} */
 
+ /** subPanelRenderGraph {{{
+  * @brief Render only the graph of a sublet on all of its panels
+  * @param[in]  sublet  A #SubSublet
+  **/
+
+void
+subPanelRenderGraph(SubSublet *sublet)
+{
+  int i, j;
+  SubGraph *g = NULL;
+
+  assert(sublet);
+
+  if(!(g = sublet->text->graph) || 0 == g->geom.width) return;
+
+  /* Find panels of sublet and its clones */
+  for(i = 0; i < subtle->screens->ndata; i++)
+    {
+      SubScreen *s = SCREEN(subtle->screens->data[i]);
+
+      for(j = 0; s->drawable && s->panels && j < s->panels->ndata; j++)
+        {
+          SubPanel *p = PANEL(s->panels->data[j]);
+
+          if(p->flags & SUB_PANEL_SUBLET && p->sublet == sublet &&
+              !(p->flags & SUB_PANEL_HIDDEN))
+            {
+              int x = 0, y = 0;
+              SubStyle *style = PanelSubletStyle(p);
+
+              /* Top panel is kept below the render area of the drawable */
+              x = p->x + STYLE_LEFT((*style));
+              y = p->flags & SUB_PANEL_BOTTOM ? 0 : subtle->ph;
+
+              subTextGraphRender(sublet->text, subtle->gcs.draw,
+                s->drawable, x, y);
+
+              XCopyArea(subtle->dpy, s->drawable, p->flags & SUB_PANEL_BOTTOM ?
+                s->panel2 : s->panel1, subtle->gcs.draw, x + g->geom.x,
+                y + g->geom.y, g->geom.width, g->geom.height,
+                x + g->geom.x, g->geom.y);
+            }
+        }
+    }
+
+  XFlush(subtle->dpy);
+} /* }}} */
+
  /** subPanelCompare {{{
   * @brief Compare two panels
   * @param[in]  a  A #SubPanel
@@ -747,6 +795,7 @@ subPanelKill(SubPanel *p)
                 printf("Unloaded sublet (%s)\n", p->sublet->name);
                 free(p->sublet->name);
               }
+            if(p->sublet->path) free(p->sublet->path);
             if(p->sublet->text) subTextKill(p->sublet->text);
 
             free(p->sublet);
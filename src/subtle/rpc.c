@@ -0,0 +1,919 @@
+
+ /**
+  * @package subtle
+  *
+  * @file RPC functions
+  * @copyright (c) 2005-2012 Christoph Kappel <unexist@subforge.org>
+  * @version $Id$
+  *
+  * This program can be distributed under the terms of the GNU GPLv2.
+  * See the file COPYING for details.
+  **/
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/un.h>
+#include "subtle.h"
+
+/* Typedef {{{ */
+typedef struct rpcbuffer_t
+{
+  char *data;
+  int  len, size;
+} RpcBuffer;
+
+typedef struct rpcconn_t
+{
+  int       fd;
+  RpcBuffer in, out;
+} RpcConn;
+
+typedef struct rpcsubscriber_t
+{
+  int fd, mask;
+} RpcSubscriber;
+/* }}} */
+
+/* Globals {{{ */
+static SubBackend backend = { NULL };
+static XEvent *messages = NULL;
+static int nmessages = 0, server = -1, nconns = 0;
+static RpcConn *conns = NULL;
+static char path[sizeof(((struct sockaddr_un *)0)->sun_path)] = { 0 };
+static SubMirror *mirror = NULL;
+static int mirrorfd = -1;
+static unsigned int generation = 0;
+static char statepath[sizeof(path)] = { 0 };
+static RpcBuffer state = { NULL };
+static RpcSubscriber *subs = NULL;
+static int nsubs = 0;
+/* }}} */
+
+/* Backend */
+
+/* RpcClient {{{ */
+static int
+RpcClient(Window win,
+  SubBackendClient *rec)
+{
+  SubClient *c = NULL;
+
+  if(!(c = CLIENT(subSubtleFind(win, CLIENTID)))) return False;
+
+  /* Borrow values, they stay valid during the call */
+  rec->win      = c->win;
+  rec->flags    = 0;
+  rec->tags     = c->tags;
+  rec->gravity  = c->gravityid;
+  rec->name     = c->name;
+  rec->instance = c->instance;
+  rec->klass    = c->klass;
+  rec->role     = c->role;
+  rec->geom     = c->geom;
+
+  subEwmhTranslateClientMode(c->flags, &rec->flags);
+
+  return True;
+} /* }}} */
+
+/* RpcList {{{ */
+static int
+RpcList(SubBackendClient **recs)
+{
+  int i, nclients = subtle->clients->ndata;
+
+  *recs = (SubBackendClient *)subSharedMemoryAlloc(MAX(1, nclients),
+    sizeof(SubBackendClient));
+
+  /* Same order as _NET_CLIENT_LIST */
+  for(i = 0; i < nclients; i++)
+    RpcClient(CLIENT(subtle->clients->data[i])->win,
+      &(*recs)[nclients - 1 - i]);
+
+  return nclients;
+} /* }}} */
+
+/* RpcCurrent {{{ */
+static Window
+RpcCurrent(void)
+{
+  return subtle->windows.focus[0];
+} /* }}} */
+
+/* RpcView {{{ */
+static int
+RpcView(char **name)
+{
+  SubScreen *s = NULL;
+  SubView *v = NULL;
+
+  if((s = subScreenCurrent(NULL)) &&
+      (v = VIEW(subArrayGet(subtle->views, s->viewid))))
+    {
+      *name = v->name;
+
+      return s->viewid;
+    }
+
+  return -1;
+} /* }}} */
+
+/* RpcMessage {{{ */
+static int
+RpcMessage(Window win,
+  char *type,
+  SubMessageData data)
+{
+  XClientMessageEvent *ev = NULL;
+
+  /* Queue message until control returns to the event loop */
+  messages = (XEvent *)subSharedMemoryRealloc(messages,
+    (nmessages + 1) * sizeof(XEvent));
+  ev = &messages[nmessages++].xclient;
+
+  ev->type         = ClientMessage;
+  ev->serial       = 0;
+  ev->send_event   = True;
+  ev->display      = subtle->dpy;
+  ev->window       = win;
+  ev->message_type = XInternAtom(subtle->dpy, type, False);
+  ev->format       = 32;
+
+  memcpy(&ev->data, &data, sizeof(SubMessageData));
+
+  return True;
+} /* }}} */
+
+/* RpcTags {{{ */
+static int
+RpcTags(char ***names)
+{
+  int i;
+
+  *names = (char **)subSharedMemoryAlloc(MAX(1, subtle->tags->ndata),
+    sizeof(char *));
+
+  for(i = 0; i < subtle->tags->ndata; i++)
+    (*names)[i] = TAG(subtle->tags->data[i])->name;
+
+  return subtle->tags->ndata;
+} /* }}} */
+
+/* RpcViews {{{ */
+static int
+RpcViews(char ***names,
+  int **tags)
+{
+  int i;
+
+  *names = (char **)subSharedMemoryAlloc(MAX(1, subtle->views->ndata),
+    sizeof(char *));
+  *tags  = (int *)subSharedMemoryAlloc(MAX(1, subtle->views->ndata),
+    sizeof(int));
+
+  for(i = 0; i < subtle->views->ndata; i++)
+    {
+      (*names)[i] = VIEW(subtle->views->data[i])->name;
+      (*tags)[i]  = VIEW(subtle->views->data[i])->tags;
+    }
+
+  return subtle->views->ndata;
+} /* }}} */
+
+/* RpcGeneration {{{ */
+static unsigned int
+RpcGeneration(void)
+{
+  return generation;
+} /* }}} */
+
+/* Protocol */
+
+/* RpcWrite {{{ */
+static void
+RpcWrite(RpcBuffer *buf,
+  const void *data,
+  int len)
+{
+  /* Grow buffer */
+  if(buf->len + len > buf->size)
+    {
+      buf->size = MAX(buf->size * 2, buf->len + len);
+      buf->data = (char *)subSharedMemoryRealloc(buf->data, buf->size);
+    }
+
+  memcpy(buf->data + buf->len, data, len);
+  buf->len += len;
+} /* }}} */
+
+/* RpcWriteInt {{{ */
+static void
+RpcWriteInt(RpcBuffer *buf,
+  int value)
+{
+  RpcWrite(buf, &value, sizeof(int));
+} /* }}} */
+
+/* RpcWriteString {{{ */
+static void
+RpcWriteString(RpcBuffer *buf,
+  const char *str)
+{
+  int len = str ? strlen(str) + 1 : 0; ///< Include terminator
+
+  RpcWriteInt(buf, len);
+  if(0 < len) RpcWrite(buf, str, len);
+} /* }}} */
+
+/* RpcWriteClient {{{ */
+static void
+RpcWriteClient(RpcBuffer *buf,
+  SubBackendClient *rec)
+{
+  RpcWriteInt(buf, (int)rec->win);
+  RpcWriteInt(buf, rec->flags);
+  RpcWriteInt(buf, rec->tags);
+  RpcWriteInt(buf, rec->gravity);
+  RpcWriteInt(buf, rec->geom.x);
+  RpcWriteInt(buf, rec->geom.y);
+  RpcWriteInt(buf, rec->geom.width);
+  RpcWriteInt(buf, rec->geom.height);
+  RpcWriteString(buf, rec->name);
+  RpcWriteString(buf, rec->instance);
+  RpcWriteString(buf, rec->klass);
+  RpcWriteString(buf, rec->role);
+} /* }}} */
+
+/* RpcWriteState {{{ */
+static void
+RpcWriteState(RpcBuffer *buf,
+  int *sections)
+{
+  int i, nrecs = 0;
+  char *name = NULL;
+  SubBackendClient *recs = NULL;
+
+  /* Current view */
+  sections[SUB_MIRROR_VIEW] = buf->len;
+  RpcWriteInt(buf, RpcView(&name));
+
+  /* Focus history */
+  sections[SUB_MIRROR_HISTORY] = buf->len;
+  RpcWriteInt(buf, HISTORYSIZE);
+  for(i = 0; i < HISTORYSIZE; i++)
+    RpcWriteInt(buf, (int)subtle->windows.focus[i]);
+
+  /* Tags */
+  sections[SUB_MIRROR_TAGS] = buf->len;
+  RpcWriteInt(buf, subtle->tags->ndata);
+  for(i = 0; i < subtle->tags->ndata; i++)
+    RpcWriteString(buf, TAG(subtle->tags->data[i])->name);
+
+  /* Views */
+  sections[SUB_MIRROR_VIEWS] = buf->len;
+  RpcWriteInt(buf, subtle->views->ndata);
+  for(i = 0; i < subtle->views->ndata; i++)
+    {
+      RpcWriteString(buf, VIEW(subtle->views->data[i])->name);
+      RpcWriteInt(buf, VIEW(subtle->views->data[i])->tags);
+    }
+
+  /* Clients */
+  sections[SUB_MIRROR_CLIENTS] = buf->len;
+  nrecs = RpcList(&recs);
+
+  RpcWriteInt(buf, nrecs);
+  for(i = 0; i < nrecs; i++)
+    RpcWriteClient(buf, &recs[i]);
+
+  free(recs);
+} /* }}} */
+
+/* RpcMirrorMap {{{ */
+static int
+RpcMirrorMap(int size)
+{
+  /* Readers remap when the size grows */
+  if(mirror) munmap(mirror, mirror->size);
+
+  if(-1 == ftruncate(mirrorfd, size) ||
+      MAP_FAILED == (mirror = (SubMirror *)mmap(NULL, size,
+      PROT_READ|PROT_WRITE, MAP_SHARED, mirrorfd, 0)))
+    {
+      subSubtleLogWarn("Failed mapping state mirror: %s\n",
+        strerror(errno));
+
+      close(mirrorfd);
+      unlink(statepath);
+
+      mirror   = NULL;
+      mirrorfd = -1;
+
+      return False;
+    }
+
+  mirror->size = size;
+
+  return True;
+} /* }}} */
+
+/* RpcClose {{{ */
+static void
+RpcClose(int fd)
+{
+  int i, j;
+
+  for(i = 0; i < nconns; i++)
+    {
+      if(conns[i].fd == fd)
+        {
+          free(conns[i].in.data);
+          if(conns[i].out.data) free(conns[i].out.data);
+
+          for(j = i; j < nconns - 1; j++)
+            conns[j] = conns[j + 1];
+
+          nconns--;
+          break;
+        }
+    }
+
+  /* Drop subscription */
+  for(i = 0; i < nsubs; i++)
+    {
+      if(subs[i].fd == fd)
+        {
+          for(j = i; j < nsubs - 1; j++)
+            subs[j] = subs[j + 1];
+
+          nsubs--;
+          break;
+        }
+    }
+
+  subEventWatchDel(fd);
+  close(fd);
+} /* }}} */
+
+/* RpcAccept {{{ */
+static void
+RpcAccept(void)
+{
+  int fd = -1;
+
+  if(-1 != (fd = accept(server, NULL, NULL)))
+    {
+      fcntl(fd, F_SETFD, FD_CLOEXEC);
+      fcntl(fd, F_SETFL, O_NONBLOCK);
+
+      conns = (RpcConn *)subSharedMemoryRealloc(conns,
+        (nconns + 1) * sizeof(RpcConn));
+
+      /* Room for one complete request */
+      conns[nconns].fd      = fd;
+      conns[nconns].in.len  = 0;
+      conns[nconns].in.size = sizeof(SubRpcHeader) + RPCSIZE;
+      conns[nconns].in.data = (char *)subSharedMemoryAlloc(
+        conns[nconns].in.size, sizeof(char));
+
+      /* Output is queued on demand */
+      conns[nconns].out.data = NULL;
+      conns[nconns].out.len  = conns[nconns].out.size = 0;
+      nconns++;
+
+      subEventWatchAdd(fd);
+    }
+} /* }}} */
+
+/* RpcFind {{{ */
+static RpcConn *
+RpcFind(int fd)
+{
+  int i;
+
+  for(i = 0; i < nconns; i++)
+    if(conns[i].fd == fd) return &conns[i];
+
+  return NULL;
+} /* }}} */
+
+/* RpcFlush {{{ */
+static int
+RpcFlush(RpcConn *conn)
+{
+  ssize_t sent = 0;
+
+  /* Send as much as the peer takes right now */
+  while(0 < conn->out.len)
+    {
+      if(0 < (sent = send(conn->fd, conn->out.data, conn->out.len,
+          MSG_DONTWAIT|MSG_NOSIGNAL)))
+        {
+          memmove(conn->out.data, conn->out.data + sent,
+            conn->out.len - sent);
+          conn->out.len -= sent;
+        }
+      else if(-1 == sent && EINTR == errno) continue;
+      else if(-1 == sent && (EAGAIN == errno || EWOULDBLOCK == errno))
+        break;
+      else return False;
+    }
+
+  /* Wait for the peer only while output is pending */
+  subEventWatchWrite(conn->fd, 0 < conn->out.len);
+
+  return True;
+} /* }}} */
+
+/* RpcSend {{{ */
+static int
+RpcSend(RpcConn *conn,
+  const char *data,
+  int len)
+{
+  /* Drop peers that don't read their data */
+  if(RPCQUEUE < conn->out.len + len) return False;
+
+  RpcWrite(&conn->out, data, len);
+
+  return RpcFlush(conn);
+} /* }}} */
+
+/* RpcDispatch {{{ */
+static int
+RpcDispatch(RpcConn *conn,
+  SubRpcHeader head,
+  char *payload)
+{
+  int fd = conn->fd, ret = True;
+  RpcBuffer buf = { NULL };
+
+  /* Reserve space for response header */
+  RpcWrite(&buf, &head, sizeof(SubRpcHeader));
+
+  switch(head.type)
+    {
+      case SUB_RPC_LIST: /* {{{ */
+        {
+          int i, nclients = 0;
+          SubBackendClient *recs = NULL;
+
+          nclients = RpcList(&recs);
+
+          RpcWriteInt(&buf, nclients);
+          for(i = 0; i < nclients; i++)
+            RpcWriteClient(&buf, &recs[i]);
+
+          free(recs);
+        }
+        break; /* }}} */
+      case SUB_RPC_CURRENT: /* {{{ */
+        RpcWriteInt(&buf, (int)RpcCurrent());
+        break; /* }}} */
+      case SUB_RPC_CLIENT: /* {{{ */
+        if((int)sizeof(int) == head.len)
+          {
+            int win = 0;
+            SubBackendClient rec = { 0 };
+
+            /* Empty response for unknown clients */
+            memcpy(&win, payload, sizeof(int));
+
+            if(RpcClient(win, &rec))
+              RpcWriteClient(&buf, &rec);
+          }
+        else head.type = -1;
+        break; /* }}} */
+      case SUB_RPC_VIEW: /* {{{ */
+        {
+          char *name = NULL;
+          int id = RpcView(&name);
+
+          RpcWriteInt(&buf, id);
+          RpcWriteString(&buf, -1 != id ? name : NULL);
+        }
+        break; /* }}} */
+      case SUB_RPC_MESSAGE: /* {{{ */
+        /* Payload: window, data and terminated type */
+        if((int)(sizeof(int) + sizeof(SubMessageData)) < head.len &&
+            '\0' == payload[head.len - 1])
+          {
+            int win = 0;
+            SubMessageData data;
+
+            memcpy(&win,  payload, sizeof(int));
+            memcpy(&data, payload + sizeof(int), sizeof(SubMessageData));
+
+            RpcMessage(win,
+              payload + sizeof(int) + sizeof(SubMessageData), data);
+            subRpcFlush();
+          }
+        else head.type = -1;
+        break; /* }}} */
+      case SUB_RPC_SUBSCRIBE: /* {{{ */
+        /* Payload: mask of hook slots, connection only receives events */
+        if((int)sizeof(int) == head.len)
+          {
+            int i;
+
+            for(i = 0; i < nsubs && subs[i].fd != fd; i++);
+
+            if(i == nsubs)
+              {
+                subs = (RpcSubscriber *)subSharedMemoryRealloc(subs,
+                  (nsubs + 1) * sizeof(RpcSubscriber));
+                subs[nsubs++].fd = fd;
+              }
+
+            memcpy(&subs[i].mask, payload, sizeof(int));
+          }
+        else head.type = -1;
+        break; /* }}} */
+      default: head.type = -1;
+    }
+
+  /* Finish response header */
+  head.len  = buf.len - sizeof(SubRpcHeader);
+  head.type = -1 == head.type ? -1 : 0;
+  memcpy(buf.data, &head, sizeof(SubRpcHeader));
+
+  subSubtleLogDebugEvents("RPC: fd=%d, type=%d, len=%d\n",
+    fd, head.type, head.len);
+
+  /* Drop clients that can't keep up */
+  if(!(ret = RpcSend(conn, buf.data, buf.len))) RpcClose(fd);
+
+  free(buf.data);
+
+  return ret;
+} /* }}} */
+
+
+/* RpcRequest {{{ */
+static void
+RpcRequest(RpcConn *conn)
+{
+  int fd = conn->fd, size = 0;
+  ssize_t len = 0;
+  SubRpcHeader head = { 0 };
+
+  /* Read what is there, requests may arrive in pieces */
+  len = recv(fd, conn->in.data + conn->in.len,
+    conn->in.size - conn->in.len, 0);
+
+  if(0 == len || (-1 == len && EAGAIN != errno &&
+      EWOULDBLOCK != errno && EINTR != errno))
+    {
+      RpcClose(fd);
+
+      return;
+    }
+  else if(0 < len) conn->in.len += len;
+
+  /* Handle complete requests */
+  while((int)sizeof(SubRpcHeader) <= conn->in.len)
+    {
+      memcpy(&head, conn->in.data, sizeof(SubRpcHeader));
+
+      if(0 > head.len || RPCSIZE < head.len)
+        {
+          RpcClose(fd);
+
+          return;
+        }
+
+      size = sizeof(SubRpcHeader) + head.len;
+      if(conn->in.len < size) break;
+
+      /* Connection is gone when the response failed */
+      if(!RpcDispatch(conn, head, conn->in.data + sizeof(SubRpcHeader)))
+        return;
+
+      memmove(conn->in.data, conn->in.data + size, conn->in.len - size);
+      conn->in.len -= size;
+    }
+} /* }}} */
+
+/* Public */
+
+ /** subRpcInit {{{
+  * @brief Create RPC socket and state mirror
+  **/
+
+void
+subRpcInit(void)
+{
+  mode_t mask = 0;
+  struct sockaddr_un addr = { 0 };
+
+  /* Create socket in private directory */
+  if(!subSharedRuntimePath(DisplayString(subtle->dpy), "rpc",
+      path, sizeof(path), True))
+    {
+      subSubtleLogWarn("Unsafe runtime directory `%s'\n", path);
+
+      return;
+    }
+
+  addr.sun_family = AF_UNIX;
+  strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+
+  unlink(path); ///< Remove stale socket
+
+  /* Create socket without access for others right away */
+  mask = umask(S_IRWXG|S_IRWXO);
+
+  if(-1 == (server = socket(AF_UNIX, SOCK_STREAM, 0)) ||
+      -1 == bind(server, (struct sockaddr *)&addr, sizeof(addr)) ||
+      -1 == listen(server, 8))
+    {
+      umask(mask);
+
+      subSubtleLogWarn("Failed creating RPC socket `%s': %s\n",
+        path, strerror(errno));
+
+      if(-1 != server) close(server);
+      server = -1;
+
+      return;
+    }
+
+  umask(mask);
+
+  fcntl(server, F_SETFD, FD_CLOEXEC);
+  fcntl(server, F_SETFL, O_NONBLOCK);
+
+  subEventWatchAdd(server);
+
+  /* Create state mirror */
+  subSharedRuntimePath(DisplayString(subtle->dpy), "state",
+    statepath, sizeof(statepath), False);
+
+  unlink(statepath); ///< Remove stale mirror
+
+  if(-1 != (mirrorfd = open(statepath, O_RDWR|O_CREAT|O_EXCL,
+      S_IRUSR|S_IWUSR)))
+    {
+      fcntl(mirrorfd, F_SETFD, FD_CLOEXEC);
+
+      subtle->flags |= SUB_SUBTLE_DIRTY;
+
+      if(RpcMirrorMap(MIRRORSIZE)) subRpcPublish();
+    }
+  else subSubtleLogWarn("Failed creating state mirror `%s': %s\n",
+    statepath, strerror(errno));
+
+  subSubtleLogDebugSubtle("Init\n");
+} /* }}} */
+
+ /** subRpcBackend {{{
+  * @brief Get in-process backend
+  * @return Returns the #SubBackend
+  **/
+
+SubBackend *
+subRpcBackend(void)
+{
+  backend.display    = DisplayString(subtle->dpy);
+  backend.list       = RpcList;
+  backend.current    = RpcCurrent;
+  backend.client     = RpcClient;
+  backend.view       = RpcView;
+  backend.message    = RpcMessage;
+  backend.tags       = RpcTags;
+  backend.views      = RpcViews;
+  backend.generation = RpcGeneration;
+
+  return &backend;
+} /* }}} */
+
+ /** subRpcHandle {{{
+  * @brief Handle data on RPC descriptors
+  * @param[in]  fd  File descriptor
+  * @retval  True   Descriptor belongs to RPC
+  * @retval  False  Unknown descriptor
+  **/
+
+int
+subRpcHandle(int fd)
+{
+  int i;
+
+  if(-1 == fd) return False;
+
+  /* Check server and connections */
+  if(fd == server)
+    {
+      RpcAccept();
+
+      return True;
+    }
+
+  for(i = 0; i < nconns; i++)
+    {
+      if(conns[i].fd == fd)
+        {
+          /* Send pending output before reading new requests */
+          if(RpcFlush(&conns[i])) RpcRequest(&conns[i]);
+          else RpcClose(fd);
+
+          return True;
+        }
+    }
+
+  return False;
+} /* }}} */
+
+ /** subRpcFlush {{{
+  * @brief Hand queued messages over to the event loop
+  **/
+
+void
+subRpcFlush(void)
+{
+  int i;
+
+  if(0 == nmessages) return;
+
+  /* Put events back in order */
+  for(i = nmessages - 1; 0 <= i; i--)
+    XPutBackEvent(subtle->dpy, &messages[i]);
+
+  free(messages);
+  messages  = NULL;
+  nmessages = 0;
+} /* }}} */
+
+ /** subRpcPublish {{{
+  * @brief Publish state to the mirror when it was marked dirty
+  **/
+
+void
+subRpcPublish(void)
+{
+  int sections[SUB_MIRROR_TOTAL] = { 0 };
+  RpcBuffer buf = { NULL };
+  volatile unsigned int *seq = NULL;
+
+  /* Skip when nothing changed since last publish */
+  if(!(subtle->flags & SUB_SUBTLE_DIRTY)) return;
+
+  subtle->flags &= ~SUB_SUBTLE_DIRTY;
+
+  RpcWriteState(&buf, sections);
+
+  /* Skip unchanged state */
+  if(buf.len == state.len && 0 == memcmp(buf.data, state.data, buf.len))
+    {
+      free(buf.data);
+
+      return;
+    }
+
+  if(state.data) free(state.data);
+  state = buf;
+  generation++;
+
+  /* Grow segment if necessary */
+  if(mirror && (int)sizeof(SubMirror) + buf.len > mirror->size)
+    RpcMirrorMap(2 * (sizeof(SubMirror) + buf.len));
+
+  if(!mirror) return;
+
+  /* Write with sequence lock, readers retry on odd or changed sequence */
+  seq = &mirror->seq;
+
+  (*seq)++;
+  __sync_synchronize();
+
+  memcpy(mirror->sections, sections, sizeof(sections));
+  memcpy((char *)mirror + sizeof(SubMirror), buf.data, buf.len);
+  mirror->len        = buf.len;
+  mirror->generation = generation;
+
+  __sync_synchronize();
+  (*seq)++;
+} /* }}} */
+
+ /** subRpcEvent {{{
+  * @brief Send hook event to subscribers
+  * @param[in]  slot  Hook slot of event
+  * @param[in]  data  Object of event or \p NULL
+  **/
+
+void
+subRpcEvent(int slot,
+  void *data)
+{
+  int i;
+  RpcConn *conn = NULL;
+  SubRpcHeader head = { 0 };
+  RpcBuffer buf = { NULL };
+
+  /* Skip when nobody listens */
+  for(i = 0; i < nsubs && !(subs[i].mask & (1L << slot)); i++);
+  if(i == nsubs) return;
+
+  /* Payload: slot, object id and name */
+  RpcWrite(&buf, &head, sizeof(SubRpcHeader));
+  RpcWriteInt(&buf, slot);
+
+  if(data && CLIENT(data)->flags & SUB_TYPE_CLIENT)
+    {
+      RpcWriteInt(&buf, (int)CLIENT(data)->win);
+      RpcWriteString(&buf, CLIENT(data)->name);
+    }
+  else if(data && VIEW(data)->flags & SUB_TYPE_VIEW)
+    {
+      RpcWriteInt(&buf, subArrayIndex(subtle->views, data));
+      RpcWriteString(&buf, VIEW(data)->name);
+    }
+  else if(data && TAG(data)->flags & SUB_TYPE_TAG)
+    {
+      RpcWriteInt(&buf, subArrayIndex(subtle->tags, data));
+      RpcWriteString(&buf, TAG(data)->name);
+    }
+  else
+    {
+      RpcWriteInt(&buf, -1);
+      RpcWriteString(&buf, NULL);
+    }
+
+  head.type = SUB_RPC_EVENT;
+  head.len  = buf.len - sizeof(SubRpcHeader);
+  memcpy(buf.data, &head, sizeof(SubRpcHeader));
+
+  /* Drop subscribers that can't keep up, backwards due to removal */
+  for(i = nsubs - 1; 0 <= i; i--)
+    {
+      if(subs[i].mask & (1L << slot) && (!(conn = RpcFind(subs[i].fd)) ||
+          !RpcSend(conn, buf.data, buf.len)))
+        RpcClose(subs[i].fd);
+    }
+
+  free(buf.data);
+
+  subSubtleLogDebugEvents("RPC: event=%d, data=%p\n", slot, data);
+} /* }}} */
+
+ /** subRpcFinish {{{
+  * @brief Close RPC socket, connections and state mirror
+  **/
+
+void
+subRpcFinish(void)
+{
+  int i;
+
+  for(i = 0; i < nconns; i++)
+    {
+      close(conns[i].fd);
+      free(conns[i].in.data);
+      if(conns[i].out.data) free(conns[i].out.data);
+    }
+
+  if(conns) free(conns);
+  if(subs) free(subs);
+  if(messages) free(messages);
+
+  conns     = NULL;
+  subs      = NULL;
+  messages  = NULL;
+  nconns    = 0;
+  nsubs     = 0;
+  nmessages = 0;
+
+  if(state.data) free(state.data);
+  state.data = NULL;
+  state.len  = state.size = 0;
+
+  if(mirror)
+    {
+      /* Mark mirror closed and leave the sequence odd for readers */
+      mirror->flags |= SUB_MIRROR_CLOSED;
+      __sync_synchronize();
+      mirror->seq |= 1;
+
+      munmap(mirror, mirror->size);
+      close(mirrorfd);
+      unlink(statepath);
+
+      mirror   = NULL;
+      mirrorfd = -1;
+    }
+
+  if(-1 != server)
+    {
+      close(server);
+      unlink(path);
+
+      server = -1;
+    }
+
+  subSubtleLogDebugSubtle("Finish\n");
+} /* }}} */
+
+// vim:ts=2:bs=2:sw=2:et:fdm=marker
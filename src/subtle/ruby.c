@@ -13,6 +13,7 @@
 #include <stdarg.h>
 #include <unistd.h>
 #include <sys/types.h>
+#include <sys/stat.h>
 #include <dirent.h>
 #include <fnmatch.h>
 #include <fcntl.h>
@@ -29,11 +30,14 @@
 /* Macros {{{ */
 #define CHAR2SYM(name) ID2SYM(rb_intern(name))
 #define SYM2CHAR(sym)  rb_id2name(SYM2ID(sym))
-/* }}} */
 
-/* Globals {{{ */
-static VALUE shelter = Qnil, mod = Qnil, config_sublets = Qnil;
-static VALUE config_instance = Qnil, config_methods = Qnil;
+#define SNAPSHOTMAGIC   "subtle-snapshot"                         ///< Snapshot magic
+#define SNAPSHOTVERSION 3                                         ///< Snapshot format version
+#define SNAPSHOTFLAGS   (SUB_SUBTLE_URGENT|SUB_SUBTLE_RESIZE|SUB_SUBTLE_TILING| \
+  SUB_SUBTLE_FOCUS_CLICK|SUB_SUBTLE_SKIP_WARP|SUB_SUBTLE_SKIP_URGENT_WARP| \
+  SUB_SUBTLE_OPAQUE)                                              ///< Snapshot option flags
+
+#define GCBUDGET        20000                                     ///< Default GC budget (objects)
 /* }}} */
 
 /* Typedef {{{ */
@@ -48,6 +52,42 @@ typedef struct rubymethods_t
   VALUE sym, real;
   int   flags, arity;
 } RubyMethods;
+
+typedef struct rubysnapshot_t
+{
+  char   *data;
+  size_t len, size, pos;
+  int    error;
+} RubySnapshot;
+
+typedef struct rubysubtlext_t
+{
+  VALUE client, screen, tag, view, geometry, gravity;
+  ID    id_new, iv_id, iv_win, iv_flags, iv_tags, iv_name, iv_instance,
+    iv_klass, iv_role, iv_geometry, iv_gravity, id_loaded, id_x, id_y,
+    id_width, id_height;
+} RubySubtlext;
+
+typedef struct rubycalls_t
+{
+  ID configure, run, data, watch, down, over, out, unload, call;
+} RubyCalls;
+
+typedef struct rubygc_t
+{
+  int    busy;
+  VALUE  options, allocated;
+  size_t base, count;
+} RubyGC;
+/* }}} */
+
+/* Globals {{{ */
+static VALUE shelter = Qnil, mod = Qnil, config_sublets = Qnil;
+static VALUE config_instance = Qnil, config_methods = Qnil;
+static VALUE config_files = Qnil, wrappers = Qnil;
+static RubySubtlext ext = { Qnil };
+static RubyCalls calls = { 0 };
+static RubyGC gc = { Qnil };
 /* }}} */
 
 /* RubyBacktrace {{{ */
@@ -99,6 +139,130 @@ RubyReceiver(unsigned long instance,
   return receiver == instance;
 } /* }}} */
 
+/* RubyCallable {{{ */
+static int
+RubyCallable(int type,
+  unsigned long instance)
+{
+  FLAGS flags = 0;
+  SubPanel *p = NULL;
+
+  /* Check sublet callbacks only */
+  if(!(type & (SUB_CALL_RUN|SUB_CALL_DATA|SUB_CALL_WATCH|SUB_CALL_UNLOAD|
+      SUB_CALL_DOWN|SUB_CALL_OVER|SUB_CALL_OUT)))
+    return True;
+
+  Data_Get_Struct(instance, SubPanel, p);
+  if(!p || !p->sublet) return False;
+
+  /* Map call types to flags set by on */
+  switch(type)
+    {
+      case SUB_CALL_RUN:    flags = p->sublet->flags & SUB_SUBLET_RUN;    break;
+      case SUB_CALL_DATA:   flags = p->sublet->flags & SUB_SUBLET_DATA;   break;
+      case SUB_CALL_WATCH:  flags = p->sublet->flags & SUB_SUBLET_WATCH;  break;
+      case SUB_CALL_UNLOAD: flags = p->sublet->flags & SUB_SUBLET_UNLOAD; break;
+      case SUB_CALL_DOWN:   flags = p->flags & SUB_PANEL_DOWN;            break;
+      case SUB_CALL_OVER:   flags = p->flags & SUB_PANEL_OVER;            break;
+      case SUB_CALL_OUT:    flags = p->flags & SUB_PANEL_OUT;             break;
+    }
+
+  return 0 != flags;
+} /* }}} */
+
+/* RubySubletOwner {{{ */
+static SubPanel *
+RubySubletOwner(unsigned long meth)
+{
+  int i;
+
+  /* Find sublet that owns this method */
+  for(i = 0; i < subtle->sublets->ndata; i++)
+    {
+      SubPanel *p = PANEL(subtle->sublets->data[i]);
+
+      if(RubyReceiver(p->sublet->instance, meth)) return p;
+    }
+
+  return NULL;
+} /* }}} */
+
+/* RubySubletStyle {{{ */
+static void
+RubySubletStyle(SubSublet *s)
+{
+  VALUE hash = Qnil, value = Qnil;
+
+  /* Set sublet style */
+  if(s->name && T_HASH == rb_type(hash = rb_hash_lookup(config_sublets,
+      CHAR2SYM(s->name))) && T_SYMBOL == rb_type(value =
+      rb_hash_lookup(hash, CHAR2SYM("style"))))
+    {
+      value = rb_sym_to_s(value);
+
+      subStyleFind(&subtle->styles.sublets, RSTRING_PTR(value),
+        &s->styleid);
+    }
+
+  /* Check if there is a matching style */
+  if(s->name) subStyleFind(&subtle->styles.sublets, s->name, &s->styleid);
+} /* }}} */
+
+/* RubySubletGrabs {{{ */
+static void
+RubySubletGrabs(SubPanel *p)
+{
+  int i;
+
+  /* Attach grabs to grab methods of sublet */
+  for(i = 0; i < subtle->grabs->ndata; i++)
+    {
+      char buf[64] = { 0 };
+      SubGrab *g = GRAB(subtle->grabs->data[i]);
+
+      if(g->flags & SUB_RUBY_DATA && SYMBOL_P(g->data.num))
+        {
+          snprintf(buf, sizeof(buf), "__grab_%s", SYM2CHAR(g->data.num));
+
+          if(rb_respond_to(p->sublet->instance, rb_intern(buf)))
+            {
+              VALUE meth = rb_obj_method(p->sublet->instance, CHAR2SYM(buf));
+
+              g->flags    ^= (SUB_RUBY_DATA|SUB_GRAB_PROC);
+              g->data.num  = (unsigned long)meth;
+
+              rb_ary_push(shelter, meth); ///< Protect from GC
+            }
+        }
+    }
+} /* }}} */
+
+/* RubySubletPath {{{ */
+static int
+RubySubletPath(char *buf,
+  size_t size)
+{
+  int len = 0;
+
+  /* Check path */
+  if(subtle->paths.sublets)
+    len += snprintf(buf, size, "%s", subtle->paths.sublets);
+  else
+    {
+      char *home = NULL;
+
+      if((home = getenv("XDG_DATA_HOME")))
+        {
+          len += snprintf(buf, size, "%s/%s/sublets",
+            home, PKG_NAME);
+        }
+      else len += snprintf(buf, size, "%s/.local/share/%s/sublets",
+        getenv("HOME"), PKG_NAME);
+    }
+
+  return len;
+} /* }}} */
+
 /* RubyFont {{{ */
 static SubFont *
 RubyFont(const char *fontname)
@@ -124,8 +288,155 @@ RubyFont(const char *fontname)
   return f;
 } /* }}} */
 
+/* RubyResetStyles {{{ */
+static void
+RubyResetStyles(void)
+{
+  /* Reset styles */
+  subStyleReset(&subtle->styles.all,        0); ///< Ensure sane base values
+  subStyleReset(&subtle->styles.views,     -1);
+  subStyleReset(&subtle->styles.title,     -1);
+  subStyleReset(&subtle->styles.sublets,   -1);
+  subStyleReset(&subtle->styles.separator, -1);
+  subStyleReset(&subtle->styles.clients,    0);
+  subStyleReset(&subtle->styles.subtle,     0);
+
+  /* Reset values */
+  subtle->gravity           = -1;
+  subtle->styles.subtle.bg  = -1; ///< Must be -1 for wallpaper
+  subtle->styles.urgent     = NULL;
+  subtle->styles.occupied   = NULL;
+  subtle->styles.focus      = NULL;
+  subtle->styles.viewsep    = NULL;
+  subtle->styles.subletsep  = NULL;
+} /* }}} */
+
+/* RubyFindConfig {{{ */
+static void
+RubyFindConfig(const char *file,
+  char *buf,
+  size_t size)
+{
+  /* Check if file exists otherwise try to find it */
+  if(-1 == access(file, R_OK))
+    {
+      int len = 0;
+      char *home = NULL, *dirs = NULL, *tok = NULL,
+        tokens[200] = { 0 }, *tokensp = tokens;
+
+      /* Combine XDG paths */
+      if((home = getenv("XDG_CONFIG_HOME")))
+        len += snprintf(tokens, sizeof(tokens), "%s", home);
+      else len += snprintf(tokens, sizeof(tokens), "%s/.config",
+        getenv("HOME"));
+
+      if((dirs = getenv("XDG_CONFIG_DIRS")))
+        len += snprintf(tokens + len, sizeof(tokens), ":%s", dirs);
+      else len += snprintf(tokens + len, sizeof(tokens), ":%s/%s",
+        "/etc/xdg", PKG_NAME);
+
+      if((home = getenv("XDG_DATA_HOME")))
+        {
+          snprintf(buf, size, "%s:%s/%s/sublets",
+            tokens, home, PKG_NAME);
+        }
+      else snprintf(buf, size, "%s:%s/.local/share/%s/sublets",
+        tokens, getenv("HOME"), PKG_NAME);
+
+      /* Search file in XDG paths */
+      while((tok = strsep(&tokensp, ":")))
+        {
+          /* Check if config file exists in tok or tok/subtle */
+          snprintf(buf, size, "%s/%s", tok, file);
+
+          if(-1 != access(buf, R_OK)) break;
+          else
+            {
+              snprintf(buf, size, "%s/%s/%s",
+                tok, PKG_NAME, file);
+
+              if(-1 != access(buf, R_OK)) break;
+            }
+        }
+    }
+  else snprintf(buf, size, "%s", file);
+} /* }}} */
+
 /* Type converter */
 
+/* RubySubtlextClasses {{{ */
+static void
+RubySubtlextClasses(void)
+{
+  VALUE subtlext = Qnil;
+
+  /* Resolve classes once, this loads subtlext on demand */
+  subtlext = rb_const_get(rb_mKernel, rb_intern("Subtlext"));
+
+  ext.client   = rb_const_get(subtlext, rb_intern("Client"));
+  ext.screen   = rb_const_get(subtlext, rb_intern("Screen"));
+  ext.tag      = rb_const_get(subtlext, rb_intern("Tag"));
+  ext.view     = rb_const_get(subtlext, rb_intern("View"));
+  ext.geometry = rb_const_get(subtlext, rb_intern("Geometry"));
+  ext.gravity  = rb_const_get(subtlext, rb_intern("Gravity"));
+} /* }}} */
+
+/* RubySubtlextObject {{{ */
+static VALUE
+RubySubtlextObject(void *data,
+  VALUE klass,
+  int id,
+  const char *name)
+{
+  VALUE key = LONG2NUM((long)data), object = Qnil;
+
+  /* Create wrapper once per object, by name if any */
+  if(NIL_P(object = rb_hash_lookup(wrappers, key)))
+    {
+      object = rb_funcall(klass, ext.id_new, 1,
+        name ? rb_str_new2(name) : INT2FIX(id));
+
+      rb_hash_aset(wrappers, key, object);
+    }
+
+  return object;
+} /* }}} */
+
+/* RubySubtlextString {{{ */
+static void
+RubySubtlextString(VALUE object,
+  ID ivar,
+  const char *string)
+{
+  VALUE value = rb_ivar_get(object, ivar);
+
+  /* Replace string only when changed */
+  if(!string) rb_ivar_set(object, ivar, Qnil);
+  else if(T_STRING != rb_type(value) || strcmp(RSTRING_PTR(value), string))
+    rb_ivar_set(object, ivar, rb_str_new2(string));
+} /* }}} */
+
+/* RubySubtlextGeometry {{{ */
+static void
+RubySubtlextGeometry(VALUE object,
+  XRectangle *geom)
+{
+  VALUE value = rb_ivar_get(object, ext.iv_geometry);
+
+  /* Replace changed geometry, users may still hold the old one */
+  if(!rb_obj_is_instance_of(value, ext.geometry) ||
+      geom->x      != FIX2INT(rb_funcall(value, ext.id_x,      0)) ||
+      geom->y      != FIX2INT(rb_funcall(value, ext.id_y,      0)) ||
+      geom->width  != FIX2INT(rb_funcall(value, ext.id_width,  0)) ||
+      geom->height != FIX2INT(rb_funcall(value, ext.id_height, 0)))
+    {
+      value = rb_funcall(ext.geometry, ext.id_new, 4, INT2FIX(geom->x),
+        INT2FIX(geom->y), INT2FIX(geom->width), INT2FIX(geom->height));
+
+      rb_ivar_set(object, ext.iv_geometry, value);
+    }
+} /* }}} */
+
 /* RubySubtleToSubtlext {{{ */
 static VALUE
 RubySubtleToSubtlext(void *data)
@@ -137,102 +448,84 @@ RubySubtleToSubtlext(void *data)
   if((c = CLIENT(data)))
     {
       int id = 0;
-      VALUE subtlext = Qnil, klass = Qnil;
-
-      XSync(subtle->dpy, False); ///< Sync before going on
 
-      subtlext = rb_const_get(rb_mKernel, rb_intern("Subtlext"));
+      if(NIL_P(ext.client)) RubySubtlextClasses();
 
       if(c->flags & SUB_TYPE_CLIENT) /* {{{ */
         {
           int flags = 0;
           VALUE value = Qnil;
 
-          /* Create client instance */
+          /* Get client instance */
           id     = subArrayIndex(subtle->clients, (void *)c);
-          klass  = rb_const_get(subtlext, rb_intern("Client"));
-          object = rb_funcall(klass, rb_intern("new"), 1, INT2FIX(id));
+          object = RubySubtlextObject(c, ext.client, id, NULL);
 
           /* Translate flags */
           subEwmhTranslateClientMode(c->flags, &flags);
 
           /* Set properties */
-          rb_iv_set(object, "@win",      LONG2NUM(c->win));
-          rb_iv_set(object, "@flags",    INT2FIX(flags));
-          rb_iv_set(object, "@tags",     INT2FIX(c->tags));
-          rb_iv_set(object, "@name",     rb_str_new2(c->name));
-          rb_iv_set(object, "@instance", rb_str_new2(c->instance));
-          rb_iv_set(object, "@klass",    rb_str_new2(c->klass));
-          rb_iv_set(object, "@role",     c->role ? rb_str_new2(c->role) :
-            Qnil);
-
-          /* Create and set geometry */
-          klass = rb_const_get(subtlext, rb_intern("Geometry"));
-          value = rb_funcall(klass, rb_intern("new"), 4, INT2FIX(c->geom.x),
-            INT2FIX(c->geom.y), INT2FIX(c->geom.width),
-            INT2FIX(c->geom.height));
-
-          rb_iv_set(object, "@geometry", value);
-
-          /* Create and set gravity if any */
+          rb_ivar_set(object, ext.iv_id,    INT2FIX(id));
+          rb_ivar_set(object, ext.iv_win,   LONG2NUM(c->win));
+          rb_ivar_set(object, ext.iv_flags, INT2FIX(flags));
+          rb_ivar_set(object, ext.iv_tags,  INT2FIX(c->tags));
+
+          RubySubtlextString(object, ext.iv_name,     c->name);
+          RubySubtlextString(object, ext.iv_instance, c->instance);
+          RubySubtlextString(object, ext.iv_klass,    c->klass);
+          RubySubtlextString(object, ext.iv_role,     c->role);
+          RubySubtlextGeometry(object, &c->geom);
+
+          rb_funcall(object, ext.id_loaded, 1, INT2FIX(-1)); ///< Nothing to load
+
+          /* Get gravity if any */
           if(-1 != c->gravityid)
             {
               SubGravity *g = GRAVITY(subArrayGet(subtle->gravities,
                 c->gravityid));
 
-              klass = rb_const_get(subtlext, rb_intern("Gravity"));
-              value = rb_funcall(klass, rb_intern("new"), 1,
-                rb_str_new2(XrmQuarkToString(g->quark)));
+              value = RubySubtlextObject(g, ext.gravity, -1,
+                XrmQuarkToString(g->quark));
 
-              rb_funcall(value, rb_intern("geometry="), 4, INT2FIX(g->geom.x),
-                INT2FIX(g->geom.y), INT2FIX(g->geom.width),
-                INT2FIX(g->geom.height));
+              RubySubtlextGeometry(value, &g->geom);
             }
           else value = Qnil;
 
-          rb_iv_set(object, "@gravity", value);
+          rb_ivar_set(object, ext.iv_gravity, value);
         } /* }}} */
       else if(c->flags & SUB_TYPE_SCREEN) /* {{{ */
         {
           SubScreen *s = SCREEN(c);
-          VALUE klass_geom, geom = Qnil;
 
-          /* Create tag instance */
-          id         = subArrayIndex(subtle->screens, (void *)s);
-          klass      = rb_const_get(subtlext, rb_intern("Screen"));
-          klass_geom = rb_const_get(subtlext, rb_intern("Geometry"));
-          object     = rb_funcall(klass, rb_intern("new"), 1, INT2FIX(id));
-          geom       = rb_funcall(klass_geom, rb_intern("new"), 4,
-            INT2FIX(s->geom.x), INT2FIX(s->geom.y),
-            INT2FIX(s->geom.width), INT2FIX(s->geom.height));
+          /* Get screen instance */
+          id     = subArrayIndex(subtle->screens, (void *)s);
+          object = RubySubtlextObject(s, ext.screen, id, NULL);
 
           /* Set properties */
-          rb_iv_set(object, "@geometry", geom);
+          rb_ivar_set(object, ext.iv_id, INT2FIX(id));
+          RubySubtlextGeometry(object, &s->geom);
         } /* }}} */
       else if(c->flags & SUB_TYPE_TAG) /* {{{ */
         {
           SubTag *t = TAG(c);
 
-          /* Create tag instance */
+          /* Get tag instance */
           id     = subArrayIndex(subtle->tags, (void *)t);
-          klass  = rb_const_get(subtlext, rb_intern("Tag"));
-          object = rb_funcall(klass, rb_intern("new"), 1, rb_str_new2(t->name));
+          object = RubySubtlextObject(t, ext.tag, -1, t->name);
 
           /* Set properties */
-          rb_iv_set(object, "@id", INT2FIX(id));
+          rb_ivar_set(object, ext.iv_id, INT2FIX(id));
         } /* }}} */
       else if(c->flags & SUB_TYPE_VIEW) /* {{{ */
         {
           SubView *v = VIEW(c);
 
-          /* Create view instance */
+          /* Get view instance */
           id     = subArrayIndex(subtle->views, (void *)v);
-          klass  = rb_const_get(subtlext, rb_intern("View"));
-          object = rb_funcall(klass, rb_intern("new"), 1, rb_str_new2(v->name));
+          object = RubySubtlextObject(v, ext.view, -1, v->name);
 
           /* Set properties */
-          rb_iv_set(object, "@id",   INT2FIX(id));
-          rb_iv_set(object, "@tags", INT2FIX(v->tags));
+          rb_ivar_set(object, ext.iv_id,   INT2FIX(id));
+          rb_ivar_set(object, ext.iv_tags, INT2FIX(v->tags));
         } /* }}} */
     }
 
@@ -548,7 +841,7 @@ RubyHashToSides(VALUE params,
 /* Eval */
 
 /* RubyEvalHook {{{ */
-static void
+static SubHook *
 RubyEvalHook(VALUE event,
   VALUE proc)
 {
@@ -573,7 +866,7 @@ RubyEvalHook(VALUE event,
     { CHAR2SYM("view_kill"),      (SUB_HOOK_TYPE_VIEW|SUB_HOOK_ACTION_KILL)      }
   };
 
-  if(subtle->flags & SUB_SUBTLE_CHECK) return; ///< Skip on check
+  if(subtle->flags & SUB_SUBTLE_CHECK) return NULL; ///< Skip on check
 
   /* Generic hooks */
   for(i = 0; LENGTH(hooks) > i; i++)
@@ -583,13 +876,27 @@ RubyEvalHook(VALUE event,
           /* Create new hook */
           if((h = subHookNew(hooks[i].flags, proc)))
             {
-              subArrayPush(subtle->hooks, (void *)h);
+              /* Resolve receiver, method and arity once */
+              if(rb_obj_is_instance_of(proc, rb_cMethod))
+                {
+                  h->receiver = rb_funcall(proc, rb_intern("receiver"),
+                    0, NULL);
+                  h->method   = SYM2ID(rb_funcall(proc, rb_intern("name"),
+                    0, NULL));
+                  h->arity    = rb_obj_method_arity(h->receiver, h->method);
+                  h->arity    = -1 == h->arity ? 2 : MINMAX(h->arity, 1, 2);
+                }
+              else h->arity = MINMAX(rb_proc_arity(proc), 0, 1);
+
+              subHookAdd(h);
               rb_ary_push(shelter, proc); ///< Protect from GC
             }
 
           break;
         }
     }
+
+  return h;
 } /* }}} */
 
 /* RubyEvalGrab {{{ */
@@ -600,6 +907,10 @@ RubyEvalGrab(VALUE keys,
   int type = -1;
   SubData data = { None };
 
+  /* Skip grabs restored from snapshot, procs can't be stored */
+  if(subtle->flags & SUB_SUBTLE_SNAPSHOT && T_DATA != rb_type(value))
+    return;
+
   /* Check value type */
   switch(rb_type(value))
     {
@@ -835,7 +1146,8 @@ RubyEvalGrab(VALUE keys,
                           SUB_GRAB_KEY|SUB_GRAB_MOUSE|SUB_GRAB_CHAIN_LINK)))
                         g->flags |= SUB_GRAB_CHAIN_LINK;
 
-                      subArrayPush(prev->keys, (void *)g);
+                      if(-1 == subArrayIndex(prev->keys, (void *)g))
+                        subArrayPush(prev->keys, (void *)g);
                     }
 
                   prev = g;
@@ -1370,72 +1682,882 @@ RubyForeachStyle(VALUE key,
   return ST_CONTINUE;
 } /* }}} */
 
-/* Wrap */
+/* Snapshot */
 
-/* RubyWrapLoadSubtlext {{{ */
-static VALUE
-RubyWrapLoadSubtlext(VALUE data)
+/* RubySnapshotWrite {{{ */
+static void
+RubySnapshotWrite(RubySnapshot *snap,
+  const void *data,
+  size_t len)
 {
-  return rb_require("subtle/subtlext");
-}/* }}} */
+  /* Grow buffer on demand */
+  if(snap->len + len > snap->size)
+    {
+      snap->size = MAX(2 * snap->size, snap->len + len + 1024);
+      snap->data = (char *)subSharedMemoryRealloc(snap->data, snap->size);
+    }
 
-/* RubyWrapLoadPanels {{{ */
-static VALUE
-RubyWrapLoadPanels(VALUE data)
-{
-  int i;
+  memcpy(snap->data + snap->len, data, len);
+  snap->len += len;
+} /* }}} */
 
-  /* Pass 1: Load actual panels */
-  for(i = 0; i < subtle->screens->ndata; i++)
+/* RubySnapshotRead {{{ */
+static void
+RubySnapshotRead(RubySnapshot *snap,
+  void *data,
+  size_t len)
+{
+  /* Check bounds */
+  if(snap->error || snap->pos + len > snap->len)
     {
-      SubScreen *s = SCREEN(subtle->screens->data[i]);
-
-      if(!s->panels) s->panels = subArrayNew();
+      memset(data, 0, len);
+      snap->error = True;
 
-      RubyEvalPanel(s->top,    SUB_SCREEN_PANEL1, s);
-      RubyEvalPanel(s->bottom, SUB_SCREEN_PANEL2, s);
+      return;
     }
 
-  /* Pass 2: Add remaining sublets if any */
-  if(0 < subtle->sublets->ndata)
-    {
-      int j, k, pos;
+  memcpy(data, snap->data + snap->pos, len);
+  snap->pos += len;
+} /* }}} */
 
-      for(i = 0; i < subtle->screens->ndata; i++)
-        {
-          SubScreen *s = SCREEN(subtle->screens->data[i]);
-          Window panel = s->panel1;
+/* RubySnapshotWriteLong {{{ */
+static void
+RubySnapshotWriteLong(RubySnapshot *snap,
+  long value)
+{
+  RubySnapshotWrite(snap, &value, sizeof(long));
+} /* }}} */
 
-          for(j = 0; j < s->panels->ndata; j++)
-            {
-              SubPanel *p = PANEL(s->panels->data[j]);
+/* RubySnapshotReadLong {{{ */
+static long
+RubySnapshotReadLong(RubySnapshot *snap)
+{
+  long value = 0;
 
-              if(panel != s->panel2 && p->flags & SUB_PANEL_BOTTOM)
-                panel = s->panel2;
+  RubySnapshotRead(snap, &value, sizeof(long));
 
-              /* Find dummy panel */
-              if(p->flags & SUB_PANEL_SUBLETS)
-                {
-                  SubPanel *sublet = NULL;
+  return value;
+} /* }}} */
 
-                  pos = j;
+/* RubySnapshotWriteString {{{ */
+static void
+RubySnapshotWriteString(RubySnapshot *snap,
+  const char *string)
+{
+  long len = string ? strlen(string) : -1;
 
-                  subArrayRemove(s->panels, (void *)p);
+  RubySnapshotWriteLong(snap, len);
+  if(0 < len) RubySnapshotWrite(snap, string, len);
+} /* }}} */
 
-                  /* Find sublets not on any panel so far */
-                  for(k = 0; k < subtle->sublets->ndata; k++)
-                    {
-                      sublet = PANEL(subtle->sublets->data[k]);
+/* RubySnapshotReadString {{{ */
+static char *
+RubySnapshotReadString(RubySnapshot *snap)
+{
+  char *string = NULL;
+  long len = RubySnapshotReadLong(snap);
 
-                      /* Check if screen is empty */
-                      if(NULL == sublet->screen)
-                        {
-                          sublet->flags  |= SUB_PANEL_SEPARATOR2;
-                          sublet->screen  = s;
+  /* Check length */
+  if(0 <= len && !snap->error)
+    {
+      if(snap->pos + len > snap->len)
+        snap->error = True;
+      else
+        {
+          string = (char *)subSharedMemoryAlloc(len + 1, sizeof(char));
 
-                          /* Mark for bottom panel */
-                          if(p->flags & SUB_PANEL_BOTTOM)
-                            sublet->flags |= SUB_PANEL_BOTTOM;
+          RubySnapshotRead(snap, string, len);
+        }
+    }
+
+  return string;
+} /* }}} */
+
+/* RubySnapshotWriteValue {{{ */
+static void
+RubySnapshotWriteValue(RubySnapshot *snap,
+  VALUE value)
+{
+  int i;
+
+  /* Store lazy values only */
+  switch(rb_type(value))
+    {
+      case T_FIXNUM:
+        RubySnapshotWriteLong(snap, T_FIXNUM);
+        RubySnapshotWriteLong(snap, FIX2LONG(value));
+        break;
+      case T_SYMBOL:
+        RubySnapshotWriteLong(snap, T_SYMBOL);
+        RubySnapshotWriteString(snap, SYM2CHAR(value));
+        break;
+      case T_ARRAY:
+        RubySnapshotWriteLong(snap, T_ARRAY);
+        RubySnapshotWriteLong(snap, RARRAY_LEN(value));
+
+        for(i = 0; i < RARRAY_LEN(value); i++)
+          RubySnapshotWriteValue(snap, rb_ary_entry(value, i));
+        break;
+      default:
+        RubySnapshotWriteLong(snap, T_NIL);
+    }
+} /* }}} */
+
+/* RubySnapshotReadValue {{{ */
+static VALUE
+RubySnapshotReadValue(RubySnapshot *snap)
+{
+  long i, len = 0;
+  char *string = NULL;
+  VALUE value = Qnil;
+
+  switch(RubySnapshotReadLong(snap))
+    {
+      case T_FIXNUM:
+        value = LONG2FIX(RubySnapshotReadLong(snap));
+        break;
+      case T_SYMBOL:
+        if((string = RubySnapshotReadString(snap)))
+          {
+            value = CHAR2SYM(string);
+
+            free(string);
+          }
+        break;
+      case T_ARRAY:
+        len   = RubySnapshotReadLong(snap);
+        value = rb_ary_new();
+
+        for(i = 0; i < len && !snap->error; i++)
+          rb_ary_push(value, RubySnapshotReadValue(snap));
+
+        rb_ary_push(shelter, value); ///< Protect from GC
+        break;
+    }
+
+  return value;
+} /* }}} */
+
+/* RubySnapshotWriteStyle {{{ */
+static void
+RubySnapshotWriteStyle(RubySnapshot *snap,
+  SubStyle *s)
+{
+  int i;
+  long values[] =
+  {
+    s->flags, s->min, s->fg, s->bg, s->icon, s->top, s->right, s->bottom,
+    s->left, s->border.top, s->border.right, s->border.bottom, s->border.left,
+    s->padding.top, s->padding.right, s->padding.bottom, s->padding.left,
+    s->margin.top, s->margin.right, s->margin.bottom, s->margin.left
+  };
+
+  RubySnapshotWriteString(snap, s->name);
+  RubySnapshotWrite(snap, values, sizeof(values));
+
+  /* Font and separator */
+  RubySnapshotWriteString(snap, s->flags & SUB_STYLE_FONT && s->font ?
+    s->font->name : NULL);
+  RubySnapshotWriteString(snap, s->flags & SUB_STYLE_SEPARATOR &&
+    s->separator ? s->separator->string : NULL);
+
+  /* Style states */
+  RubySnapshotWriteLong(snap, s->styles ? s->styles->ndata : 0);
+
+  for(i = 0; s->styles && i < s->styles->ndata; i++)
+    RubySnapshotWriteStyle(snap, STYLE(s->styles->data[i]));
+} /* }}} */
+
+/* RubySnapshotReadStyle {{{ */
+static void
+RubySnapshotReadStyle(RubySnapshot *snap,
+  SubStyle *s)
+{
+  long i, nstyles = 0, values[21] = { 0 };
+  char *name = NULL, *font = NULL, *separator = NULL;
+
+  /* Base styles have no name */
+  if((name = RubySnapshotReadString(snap)))
+    {
+      if(s->name) free(s->name);
+      s->name = name;
+    }
+
+  RubySnapshotRead(snap, values, sizeof(values));
+
+  s->flags          = values[0] & ~(SUB_STYLE_FONT|SUB_STYLE_SEPARATOR);
+  s->min            = values[1];
+  s->fg             = values[2];
+  s->bg             = values[3];
+  s->icon           = values[4];
+  s->top            = values[5];
+  s->right          = values[6];
+  s->bottom         = values[7];
+  s->left           = values[8];
+  s->border.top     = values[9];
+  s->border.right   = values[10];
+  s->border.bottom  = values[11];
+  s->border.left    = values[12];
+  s->padding.top    = values[13];
+  s->padding.right  = values[14];
+  s->padding.bottom = values[15];
+  s->padding.left   = values[16];
+  s->margin.top     = values[17];
+  s->margin.right   = values[18];
+  s->margin.bottom  = values[19];
+  s->margin.left    = values[20];
+
+  /* Load font */
+  if((font = RubySnapshotReadString(snap)))
+    {
+      s->flags |= SUB_STYLE_FONT;
+      s->font   = RubyFont(font);
+
+      /* EWMH: Font */
+      if(&subtle->styles.all == s)
+        subEwmhSetString(ROOT, SUB_EWMH_SUBTLE_FONT, font);
+
+      free(font);
+    }
+
+  /* Create separator */
+  if((separator = RubySnapshotReadString(snap)))
+    {
+      s->flags     |= SUB_STYLE_SEPARATOR;
+      s->separator  = (SubSeparator *)subSharedMemoryAlloc(1,
+        sizeof(SubSeparator));
+      s->separator->string = separator;
+    }
+
+  /* Style states */
+  nstyles = RubySnapshotReadLong(snap);
+
+  for(i = 0; i < nstyles && !snap->error; i++)
+    {
+      SubStyle *style = subStyleNew();
+
+      RubySnapshotReadStyle(snap, style);
+
+      /* Ease access to sub-styles */
+      if(style->name)
+        {
+          if(&subtle->styles.views == s)
+            {
+              if(!strcmp("urgent",         style->name)) subtle->styles.urgent   = style;
+              else if(!strcmp("occupied",  style->name)) subtle->styles.occupied = style;
+              else if(!strcmp("focus",     style->name)) subtle->styles.focus    = style;
+              else if(!strcmp("visible",   style->name)) subtle->styles.visible  = style;
+              else if(!strcmp("separator", style->name)) subtle->styles.viewsep  = style;
+            }
+          else if(&subtle->styles.sublets == s &&
+              !strcmp("separator", style->name))
+            subtle->styles.subletsep = style;
+        }
+
+      if(!s->styles) s->styles = subArrayNew();
+      subArrayPush(s->styles, (void *)style);
+    }
+} /* }}} */
+
+/* RubySnapshotHash {{{ */
+static unsigned long
+RubySnapshotHash(const char *data,
+  size_t len,
+  unsigned long hash)
+{
+  size_t i;
+
+  /* FNV-1a */
+  for(i = 0; i < len; i++)
+    {
+      hash ^= (unsigned char)data[i];
+      hash *= 1099511628211UL;
+    }
+
+  return hash;
+} /* }}} */
+
+/* RubyFileHash {{{ */
+static int
+RubyFileHash(const char *path,
+  unsigned long *hash)
+{
+  int fd = -1;
+  ssize_t len = 0;
+  char buf[4096];
+
+  /* Get content hash */
+  if(-1 == (fd = open(path, O_RDONLY))) return False;
+
+  *hash = 14695981039346656037UL;
+
+  while(0 < (len = read(fd, buf, sizeof(buf))))
+    *hash = RubySnapshotHash(buf, len, *hash);
+
+  close(fd);
+
+  return True;
+} /* }}} */
+
+/* RubySnapshotKey {{{ */
+static void
+RubySnapshotKey(RubySnapshot *snap,
+  const char *config)
+{
+  int min = 0, max = 0, per = 0;
+  unsigned long keymap = 0;
+  KeySym *syms = NULL;
+  Visual *visual = DefaultVisual(subtle->dpy, SCRN);
+
+  /* Hash keyboard mapping, grabs store key codes */
+  XDisplayKeycodes(subtle->dpy, &min, &max);
+  if((syms = XGetKeyboardMapping(subtle->dpy, min, max - min + 1, &per)))
+    {
+      keymap = RubySnapshotHash((char *)syms,
+        (max - min + 1) * per * sizeof(KeySym), 14695981039346656037UL);
+
+      XFree(syms);
+    }
+
+  RubySnapshotWriteString(snap, SNAPSHOTMAGIC);
+  RubySnapshotWriteLong(snap, SNAPSHOTVERSION);
+  RubySnapshotWriteString(snap, PKG_VERSION);
+  RubySnapshotWriteString(snap, config);
+  RubySnapshotWriteLong(snap, XVisualIDFromVisual(visual));
+  RubySnapshotWriteLong(snap, DefaultDepth(subtle->dpy, SCRN));
+  RubySnapshotWriteLong(snap, keymap);
+} /* }}} */
+
+/* RubySnapshotPath {{{ */
+static void
+RubySnapshotPath(char *buf,
+  size_t len,
+  int create)
+{
+  char *home = NULL;
+
+  /* Use XDG cache dir */
+  if((home = getenv("XDG_CACHE_HOME")))
+    snprintf(buf, len, "%s", home);
+  else snprintf(buf, len, "%s/.cache", getenv("HOME"));
+
+  if(create) mkdir(buf, 0700);
+
+  strncat(buf, "/" PKG_NAME, len - strlen(buf) - 1);
+
+  if(create) mkdir(buf, 0700);
+
+  strncat(buf, "/snapshot", len - strlen(buf) - 1);
+} /* }}} */
+
+/* RubySnapshotSave {{{ */
+static void
+RubySnapshotSave(const char *config)
+{
+  int i, j;
+  FILE *fp = NULL;
+  char path[255] = { 0 }, tmp[260] = { 0 };
+  unsigned long hash = 0;
+  RubySnapshot snap = { NULL };
+
+  /* Colors are stored as pixels */
+  if(TrueColor != DefaultVisual(subtle->dpy, SCRN)->class) return;
+
+  RubySnapshotKey(&snap, config);
+
+  /* Loaded config files */
+  RubySnapshotWriteLong(&snap, RARRAY_LEN(config_files));
+
+  for(i = 0; i < RARRAY_LEN(config_files); i++)
+    {
+      const char *file = RSTRING_PTR(rb_ary_entry(config_files, i));
+
+      if(!RubyFileHash(file, &hash))
+        {
+          free(snap.data);
+
+          return;
+        }
+
+      RubySnapshotWriteString(&snap, file);
+      RubySnapshotWriteLong(&snap, hash);
+    }
+
+  /* Options */
+  RubySnapshotWriteLong(&snap, subtle->flags & SNAPSHOTFLAGS);
+  RubySnapshotWriteLong(&snap, subtle->step);
+  RubySnapshotWriteLong(&snap, subtle->snap);
+  RubySnapshotWriteLong(&snap, subtle->gc_budget);
+  RubySnapshotWriteValue(&snap, subtle->gravity);
+
+  /* Gravities */
+  RubySnapshotWriteLong(&snap, subtle->gravities->ndata);
+
+  for(i = 0; i < subtle->gravities->ndata; i++)
+    {
+      SubGravity *g = GRAVITY(subtle->gravities->data[i]);
+
+      RubySnapshotWriteString(&snap, XrmQuarkToString(g->quark));
+      RubySnapshotWriteLong(&snap, g->flags);
+      RubySnapshotWrite(&snap, &g->geom, sizeof(XRectangle));
+    }
+
+  /* Tags without default tag */
+  RubySnapshotWriteLong(&snap, subtle->tags->ndata - 1);
+
+  for(i = 1; i < subtle->tags->ndata; i++)
+    {
+      int type = 0;
+      char *pattern = NULL;
+      SubTag *t = TAG(subtle->tags->data[i]);
+
+      RubySnapshotWriteString(&snap, t->name);
+      RubySnapshotWriteLong(&snap, t->flags & ~SUB_TAG_PROC); ///< Proc stays live
+      if(t->flags & SUB_TAG_GRAVITY)
+        RubySnapshotWriteValue(&snap, t->gravityid);
+      RubySnapshotWriteLong(&snap, t->screenid);
+      RubySnapshotWrite(&snap, &t->geom, sizeof(XRectangle));
+
+      /* Matcher */
+      RubySnapshotWriteLong(&snap, t->matcher ? t->matcher->ndata : 0);
+
+      for(j = 0; subTagMatcherGet(t, j, &type, &pattern); j++)
+        {
+          RubySnapshotWriteLong(&snap, type);
+          RubySnapshotWriteString(&snap, pattern);
+        }
+    }
+
+  /* Views */
+  RubySnapshotWriteLong(&snap, subtle->views->ndata);
+
+  for(i = 0; i < subtle->views->ndata; i++)
+    {
+      SubView *v = VIEW(subtle->views->data[i]);
+
+      RubySnapshotWriteString(&snap, v->name);
+      RubySnapshotWriteLong(&snap, v->flags & ~SUB_VIEW_ICON); ///< Icon stays live
+      RubySnapshotWriteLong(&snap, v->tags);
+    }
+
+  /* Grabs without procs */
+  for(i = 0, j = 0; i < subtle->grabs->ndata; i++)
+    if(!(GRAB(subtle->grabs->data[i])->flags & SUB_GRAB_PROC)) j++;
+
+  RubySnapshotWriteLong(&snap, j);
+
+  for(i = 0; i < subtle->grabs->ndata; i++)
+    {
+      SubGrab *g = GRAB(subtle->grabs->data[i]);
+
+      if(g->flags & SUB_GRAB_PROC) continue;
+
+      RubySnapshotWriteLong(&snap, g->flags);
+      RubySnapshotWriteLong(&snap, g->code);
+      RubySnapshotWriteLong(&snap, g->state);
+
+      /* Grab data */
+      if(g->flags & SUB_GRAB_SPAWN)
+        RubySnapshotWriteString(&snap, g->data.string);
+      else if(g->flags & SUB_RUBY_DATA)
+        RubySnapshotWriteValue(&snap, g->data.num);
+      else RubySnapshotWriteLong(&snap, g->data.num);
+
+      /* Chain keys by grab code and state */
+      RubySnapshotWriteLong(&snap, g->keys ? g->keys->ndata : 0);
+
+      for(j = 0; g->keys && j < g->keys->ndata; j++)
+        {
+          SubGrab *k = GRAB(g->keys->data[j]);
+
+          RubySnapshotWriteLong(&snap, k->code);
+          RubySnapshotWriteLong(&snap, k->state);
+        }
+    }
+
+  /* Styles */
+  RubySnapshotWriteStyle(&snap, &subtle->styles.all);
+  RubySnapshotWriteStyle(&snap, &subtle->styles.views);
+  RubySnapshotWriteStyle(&snap, &subtle->styles.title);
+  RubySnapshotWriteStyle(&snap, &subtle->styles.sublets);
+  RubySnapshotWriteStyle(&snap, &subtle->styles.separator);
+  RubySnapshotWriteStyle(&snap, &subtle->styles.clients);
+  RubySnapshotWriteStyle(&snap, &subtle->styles.subtle);
+
+  /* Checksum */
+  hash = RubySnapshotHash(snap.data, snap.len, 14695981039346656037UL);
+  RubySnapshotWriteLong(&snap, hash);
+
+  /* Write to temp file and rename atomically */
+  RubySnapshotPath(path, sizeof(path), True);
+  snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+
+  if((fp = fopen(tmp, "w")))
+    {
+      int written = (1 == fwrite(snap.data, snap.len, 1, fp));
+
+      /* Always close file, even after a failed write */
+      if(0 == fclose(fp) && written) rename(tmp, path);
+      else unlink(tmp);
+
+      subSubtleLogDebugRuby("Snapshot: save file=%s, len=%zu\n",
+        path, snap.len);
+    }
+
+  free(snap.data);
+} /* }}} */
+
+/* RubySnapshotLoad {{{ */
+static int
+RubySnapshotLoad(const char *config)
+{
+  int fd = -1, step = 0, snap_size = 0, gc_budget = 0;
+  long i, j, n = 0;
+  char path[255] = { 0 };
+  unsigned long hash = 0;
+  struct stat st;
+  RubySnapshot snap = { NULL }, key = { NULL };
+
+  if(TrueColor != DefaultVisual(subtle->dpy, SCRN)->class) return False;
+
+  /* Read snapshot file */
+  RubySnapshotPath(path, sizeof(path), False);
+
+  if(-1 == (fd = open(path, O_RDONLY))) return False;
+
+  if(-1 == fstat(fd, &st) || st.st_size < (off_t)sizeof(long))
+    {
+      close(fd);
+
+      return False;
+    }
+
+  snap.len  = st.st_size;
+  snap.data = (char *)subSharedMemoryAlloc(snap.len, sizeof(char));
+
+  if((ssize_t)snap.len != read(fd, snap.data, snap.len)) snap.error = True;
+
+  close(fd);
+
+  /* Check checksum */
+  memcpy(&hash, snap.data + snap.len - sizeof(long), sizeof(long));
+  snap.len -= sizeof(long);
+
+  if(snap.error || hash != RubySnapshotHash(snap.data, snap.len,
+      14695981039346656037UL))
+    {
+      free(snap.data);
+
+      return False;
+    }
+
+  /* Compare snapshot key */
+  RubySnapshotKey(&key, config);
+
+  if(snap.len < key.len || memcmp(snap.data, key.data, key.len))
+    {
+      subSubtleLogDebugRuby("Snapshot: key mismatch\n");
+
+      free(key.data);
+      free(snap.data);
+
+      return False;
+    }
+
+  snap.pos = key.len;
+  free(key.data);
+
+  /* Check config files by content hash */
+  n = RubySnapshotReadLong(&snap);
+
+  for(i = 0; i < n && !snap.error; i++)
+    {
+      char *file = RubySnapshotReadString(&snap);
+      unsigned long shash = RubySnapshotReadLong(&snap);
+
+      if(!file || !RubyFileHash(file, &hash) || hash != shash)
+        snap.error = True;
+
+      if(file) free(file);
+    }
+
+  if(snap.error)
+    {
+      subSubtleLogDebugRuby("Snapshot: config changed\n");
+
+      free(snap.data);
+
+      return False;
+    }
+
+  /* Options */
+  step              = subtle->step;
+  snap_size         = subtle->snap;
+  gc_budget         = subtle->gc_budget;
+  subtle->flags    |= (RubySnapshotReadLong(&snap) & SNAPSHOTFLAGS);
+  subtle->step      = RubySnapshotReadLong(&snap);
+  subtle->snap      = RubySnapshotReadLong(&snap);
+  subtle->gc_budget = RubySnapshotReadLong(&snap);
+  subtle->gravity   = RubySnapshotReadValue(&snap);
+
+  /* Gravities */
+  n = RubySnapshotReadLong(&snap);
+
+  for(i = 0; i < n && !snap.error; i++)
+    {
+      long flags = 0;
+      char *name = RubySnapshotReadString(&snap);
+      XRectangle geom = { 0 };
+      SubGravity *g = NULL;
+
+      flags = RubySnapshotReadLong(&snap);
+      RubySnapshotRead(&snap, &geom, sizeof(XRectangle));
+
+      if(name && (g = subGravityNew(name, &geom)))
+        {
+          g->flags = flags;
+
+          subArrayPush(subtle->gravities, (void *)g);
+        }
+
+      if(name) free(name);
+    }
+
+  /* Tags */
+  n = RubySnapshotReadLong(&snap);
+
+  for(i = 0; i < n && !snap.error; i++)
+    {
+      long nmatcher = 0;
+      char *name = RubySnapshotReadString(&snap);
+      SubTag *t = NULL;
+
+      if(!name)
+        {
+          snap.error = True;
+
+          break;
+        }
+
+      t = subTagNew(name, NULL);
+      t->flags = RubySnapshotReadLong(&snap);
+      if(t->flags & SUB_TAG_GRAVITY)
+        t->gravityid = RubySnapshotReadValue(&snap);
+      t->screenid = RubySnapshotReadLong(&snap);
+      RubySnapshotRead(&snap, &t->geom, sizeof(XRectangle));
+
+      /* Matcher */
+      nmatcher = RubySnapshotReadLong(&snap);
+
+      for(j = 0; j < nmatcher && !snap.error; j++)
+        {
+          int type = RubySnapshotReadLong(&snap);
+          char *pattern = RubySnapshotReadString(&snap);
+
+          subTagMatcherAdd(t, type & ~SUB_TAG_MATCH_AND, pattern,
+            type & SUB_TAG_MATCH_AND);
+
+          if(pattern) free(pattern);
+        }
+
+      subArrayPush(subtle->tags, (void *)t);
+      free(name);
+    }
+
+  /* Views */
+  n = RubySnapshotReadLong(&snap);
+
+  for(i = 0; i < n && !snap.error; i++)
+    {
+      char *name = RubySnapshotReadString(&snap);
+      SubView *v = NULL;
+
+      if(!name)
+        {
+          snap.error = True;
+
+          break;
+        }
+
+      v = subViewNew(name, NULL);
+      v->flags = RubySnapshotReadLong(&snap);
+      v->tags  = RubySnapshotReadLong(&snap);
+
+      subArrayPush(subtle->views, (void *)v);
+      free(name);
+    }
+
+  /* Grabs */
+  n = RubySnapshotReadLong(&snap);
+
+  for(i = 0; i < n && !snap.error; i++)
+    {
+      SubGrab *g = GRAB(subSharedMemoryAlloc(1, sizeof(SubGrab)));
+
+      g->flags = RubySnapshotReadLong(&snap);
+      g->code  = RubySnapshotReadLong(&snap);
+      g->state = RubySnapshotReadLong(&snap);
+
+      /* Grab data */
+      if(g->flags & SUB_GRAB_SPAWN)
+        g->data.string = RubySnapshotReadString(&snap);
+      else if(g->flags & SUB_RUBY_DATA)
+        g->data.num = RubySnapshotReadValue(&snap);
+      else g->data.num = RubySnapshotReadLong(&snap);
+
+      /* Store chain keys as plain pairs until all grabs exist */
+      if(0 < (j = RubySnapshotReadLong(&snap)))
+        {
+          g->keys = subArrayNew();
+
+          for(; 0 < j && !snap.error; j--)
+            {
+              long *pair = (long *)subSharedMemoryAlloc(2, sizeof(long));
+
+              pair[0] = RubySnapshotReadLong(&snap);
+              pair[1] = RubySnapshotReadLong(&snap);
+
+              subArrayPush(g->keys, (void *)pair);
+            }
+        }
+
+      subArrayPush(subtle->grabs, (void *)g);
+    }
+
+  subArraySort(subtle->grabs, subGrabCompare);
+
+  /* Resolve chain keys */
+  for(i = 0; i < subtle->grabs->ndata; i++)
+    {
+      SubGrab *g = GRAB(subtle->grabs->data[i]);
+      SubArray *pairs = g->keys;
+
+      if(!pairs) continue;
+
+      g->keys = subArrayNew();
+
+      for(j = 0; j < pairs->ndata; j++)
+        {
+          long *pair = (long *)pairs->data[j];
+          SubGrab *k = NULL;
+
+          /* Links to proc grabs are added again by the config */
+          if((k = subGrabFind(pair[0], pair[1])))
+            subArrayPush(g->keys, (void *)k);
+
+          free(pair);
+        }
+
+      subArrayKill(pairs, False);
+    }
+
+  /* Styles */
+  RubySnapshotReadStyle(&snap, &subtle->styles.all);
+  RubySnapshotReadStyle(&snap, &subtle->styles.views);
+  RubySnapshotReadStyle(&snap, &subtle->styles.title);
+  RubySnapshotReadStyle(&snap, &subtle->styles.sublets);
+  RubySnapshotReadStyle(&snap, &subtle->styles.separator);
+  RubySnapshotReadStyle(&snap, &subtle->styles.clients);
+  RubySnapshotReadStyle(&snap, &subtle->styles.subtle);
+
+  free(snap.data);
+
+  subSubtleLogDebugRuby("Snapshot: load file=%s, error=%d\n",
+    path, snap.error);
+
+  /* Roll back partial restore */
+  if(snap.error)
+    {
+      subArrayClear(subtle->gravities, True);
+      subArrayClear(subtle->views,     True);
+      subArrayClear(subtle->grabs,     True);
+
+      /* Keep default tag */
+      while(1 < subtle->tags->ndata)
+        {
+          SubTag *t = TAG(subtle->tags->data[subtle->tags->ndata - 1]);
+
+          subArrayRemove(subtle->tags, (void *)t);
+          subTagKill(t);
+        }
+
+      subtle->flags    &= ~SNAPSHOTFLAGS;
+      subtle->step      = step;
+      subtle->snap      = snap_size;
+      subtle->gc_budget = gc_budget;
+
+      RubyResetStyles();
+    }
+
+  return !snap.error;
+} /* }}} */
+
+/* Wrap */
+
+/* RubyWrapLoadSubtlext {{{ */
+static VALUE
+RubyWrapLoadSubtlext(VALUE data)
+{
+  return rb_require("subtle/subtlext");
+}/* }}} */
+
+/* RubyWrapLoadPanels {{{ */
+static VALUE
+RubyWrapLoadPanels(VALUE data)
+{
+  int i;
+
+  /* Pass 1: Load actual panels */
+  for(i = 0; i < subtle->screens->ndata; i++)
+    {
+      SubScreen *s = SCREEN(subtle->screens->data[i]);
+
+      if(!s->panels) s->panels = subArrayNew();
+
+      RubyEvalPanel(s->top,    SUB_SCREEN_PANEL1, s);
+      RubyEvalPanel(s->bottom, SUB_SCREEN_PANEL2, s);
+    }
+
+  /* Pass 2: Add remaining sublets if any */
+  if(0 < subtle->sublets->ndata)
+    {
+      int j, k, pos;
+
+      for(i = 0; i < subtle->screens->ndata; i++)
+        {
+          SubScreen *s = SCREEN(subtle->screens->data[i]);
+          Window panel = s->panel1;
+
+          for(j = 0; j < s->panels->ndata; j++)
+            {
+              SubPanel *p = PANEL(s->panels->data[j]);
+
+              if(panel != s->panel2 && p->flags & SUB_PANEL_BOTTOM)
+                panel = s->panel2;
+
+              /* Find dummy panel */
+              if(p->flags & SUB_PANEL_SUBLETS)
+                {
+                  SubPanel *sublet = NULL;
+
+                  pos = j;
+
+                  subArrayRemove(s->panels, (void *)p);
+
+                  /* Find sublets not on any panel so far */
+                  for(k = 0; k < subtle->sublets->ndata; k++)
+                    {
+                      sublet = PANEL(subtle->sublets->data[k]);
+
+                      /* Check if screen is empty */
+                      if(NULL == sublet->screen)
+                        {
+                          sublet->flags  |= SUB_PANEL_SEPARATOR2;
+                          sublet->screen  = s;
+
+                          /* Mark for bottom panel */
+                          if(p->flags & SUB_PANEL_BOTTOM)
+                            sublet->flags |= SUB_PANEL_BOTTOM;
 
                           subArrayInsert(s->panels, pos++, (void *)sublet);
                         }
@@ -1487,17 +2609,20 @@ RubyWrapCall(VALUE data)
   switch((int)rargs[0])
     {
       case SUB_CALL_CONFIGURE: /* {{{ */
-        rb_funcall(rargs[1], rb_intern("__configure"), 1, rargs[1]);
+        rb_funcall(rargs[1], calls.configure, 1, rargs[1]);
         break; /* }}} */
       case SUB_CALL_RUN: /* {{{ */
-        rb_funcall(rargs[1], rb_intern("__run"), 1, rargs[1]);
+        rb_funcall(rargs[1], calls.run, 1, rargs[1]);
         break; /* }}} */
       case SUB_CALL_DATA: /* {{{ */
           {
             int nlist = 0;
             char **list = NULL;
             Atom prop = subEwmhGet(SUB_EWMH_SUBTLE_DATA);
-            VALUE meth = rb_intern("__data"), str = Qnil;
+            VALUE str = Qnil;
+            SubPanel *p = NULL;
+
+            Data_Get_Struct(rargs[1], SubPanel, p);
 
             /* Fetch data or create empty string */
             if((list = subSharedPropertyGetStrings(subtle->dpy, ROOT,
@@ -1513,32 +2638,52 @@ RubyWrapCall(VALUE data)
             subSharedPropertyDelete(subtle->dpy, ROOT, prop);
 
             /* Finally call method */
-            rb_funcall(rargs[1], meth,
-              MINMAX(rb_obj_method_arity(rargs[1], meth), 1, 2),
+            rb_funcall(rargs[1], calls.data, p->sublet->data_arity,
               rargs[1], str);
           }
         break; /* }}} */
       case SUB_CALL_WATCH: /* {{{ */
-        rb_funcall(rargs[1], rb_intern("__watch"), 1, rargs[1]);
+        rb_funcall(rargs[1], calls.watch, 1, rargs[1]);
         break; /* }}} */
       case SUB_CALL_DOWN: /* {{{ */
           {
             int *args = (int *)rargs[2];
-            VALUE meth = rb_intern("__down");
+            SubPanel *p = NULL;
+
+            Data_Get_Struct(rargs[1], SubPanel, p);
 
-            rb_funcall(rargs[1], meth,
-              MINMAX(rb_obj_method_arity(rargs[1], meth), 1, 4),
+            rb_funcall(rargs[1], calls.down, p->sublet->down_arity,
               rargs[1], INT2FIX(args[0]), INT2FIX(args[1]), INT2FIX(args[2]));
           }
         break; /* }}} */
       case SUB_CALL_OVER: /* {{{ */
-        rb_funcall(rargs[1], rb_intern("__over"), 1, rargs[1]);
+        rb_funcall(rargs[1], calls.over, 1, rargs[1]);
         break; /* }}} */
       case SUB_CALL_OUT: /* {{{ */
-        rb_funcall(rargs[1], rb_intern("__out"), 1, rargs[1]);
+        rb_funcall(rargs[1], calls.out, 1, rargs[1]);
         break; /* }}} */
       case SUB_CALL_UNLOAD: /* {{{ */
-        rb_funcall(rargs[1], rb_intern("__unload"), 1, rargs[1]);
+        rb_funcall(rargs[1], calls.unload, 1, rargs[1]);
+        break; /* }}} */
+      case SUB_CALL_HOOK: /* {{{ */
+          {
+            SubHook *h = HOOK(rargs[1]);
+
+            /* Call receiver directly or just the proc */
+            if(h->method)
+              {
+                rb_funcall(h->receiver, h->method, h->arity, h->receiver,
+                  RubySubtleToSubtlext((VALUE *)rargs[2]));
+
+                subScreenUpdate();
+                subScreenRender();
+              }
+            else
+              {
+                rb_funcall(h->proc, calls.call, h->arity,
+                  RubySubtleToSubtlext((VALUE *)rargs[2]));
+              }
+          }
         break; /* }}} */
       default: /* {{{ */
         /* Call instance methods or just a proc */
@@ -1553,7 +2698,7 @@ RubyWrapCall(VALUE data)
               0, NULL));
             arity    = -1 == arity ? 2 : MINMAX(arity, 1, 2);
 
-            rb_funcall(rargs[1], rb_intern("call"), arity, receiver,
+            rb_funcall(rargs[1], calls.call, arity, receiver,
               RubySubtleToSubtlext((VALUE *)rargs[2]));
 
             subScreenUpdate();
@@ -1561,7 +2706,7 @@ RubyWrapCall(VALUE data)
           }
         else
           {
-            rb_funcall(rargs[1], rb_intern("call"),
+            rb_funcall(rargs[1], calls.call,
               MINMAX(rb_proc_arity(rargs[1]), 0, 1),
               RubySubtleToSubtlext((VALUE *)rargs[2]));
           }
@@ -1571,6 +2716,26 @@ RubyWrapCall(VALUE data)
   return Qnil;
 } /* }}} */
 
+#ifdef HAVE_RB_GC_STAT
+/* RubyWrapCollect {{{ */
+static VALUE
+RubyWrapCollect(VALUE data)
+{
+  return rb_funcall(rb_mGC, rb_intern("start"), 1, gc.options);
+} /* }}} */
+#endif /* HAVE_RB_GC_STAT */
+
+/* RubyGCBudget {{{ */
+static int
+RubyGCBudget(void)
+{
+#ifdef HAVE_RB_GC_STAT
+  return rb_gc_stat(gc.allocated) - gc.base < (size_t)subtle->gc_budget;
+#else /* HAVE_RB_GC_STAT */
+  return False; ///< Allocations can't be counted, keep GC enabled
+#endif /* HAVE_RB_GC_STAT */
+} /* }}} */
+
 /* RubyWrapRelease {{{ */
 static VALUE
 RubyWrapRelease(VALUE value)
@@ -1613,20 +2778,9 @@ RubyWrapSubletConfig(VALUE data)
       /* Set sublet interval */
       if(FIXNUM_P(value = rb_hash_lookup(hash, CHAR2SYM("interval"))))
         s->interval = FIX2INT(value);
-
-      /* Set sublet style */
-      if(T_SYMBOL == rb_type(value = rb_hash_lookup(hash,
-          CHAR2SYM("style"))))
-        {
-          value = rb_sym_to_s(value);
-
-          subStyleFind(&subtle->styles.sublets, RSTRING_PTR(value),
-            &s->styleid);
-        }
     }
 
-  /* Check if there is a matching style */
-  subStyleFind(&subtle->styles.sublets, s->name, &s->styleid);
+  RubySubletStyle(s);
 
   return Qnil;
 } /* }}} */
@@ -1921,6 +3075,10 @@ RubyConfigSet(VALUE self,
   VALUE option,
   VALUE value)
 {
+  /* Skip options restored from snapshot */
+  if(subtle->flags & SUB_SUBTLE_SNAPSHOT && T_STRING != rb_type(value))
+    return Qnil;
+
   /* Check value type */
   if(T_SYMBOL == rb_type(option))
     {
@@ -1939,6 +3097,11 @@ RubyConfigSet(VALUE self,
                 if(!(subtle->flags & SUB_SUBTLE_CHECK))
                   subtle->snap = FIX2INT(value);
               }
+            else if(CHAR2SYM("gc_budget") == option)
+              {
+                if(!(subtle->flags & SUB_SUBTLE_CHECK))
+                  subtle->gc_budget = MAX(0, FIX2INT(value));
+              }
             else if(CHAR2SYM("gravity") == option ||
                 CHAR2SYM("default_gravity") == option)
               {
@@ -1991,6 +3154,11 @@ RubyConfigSet(VALUE self,
                 if(!(subtle->flags & SUB_SUBTLE_CHECK) && Qtrue == value)
                   subtle->flags |= SUB_SUBTLE_SKIP_URGENT_WARP;
               }
+            else if(CHAR2SYM("opaque_drag") == option)
+              {
+                if(!(subtle->flags & SUB_SUBTLE_CHECK) && Qtrue == value)
+                  subtle->flags |= SUB_SUBTLE_OPAQUE;
+              }
             else subSubtleLogWarn("Unknown option `:%s'\n", SYM2CHAR(option));
             break; /* }}} */
           case T_STRING: /* {{{ */
@@ -2048,8 +3216,8 @@ RubyConfigGravity(int argc,
 
       RubyArrayToGeometry(value, &geometry);
 
-      /* Skip on checking only */
-      if(!(subtle->flags & SUB_SUBTLE_CHECK))
+      /* Skip on checking only or when restored from snapshot */
+      if(!(subtle->flags & (SUB_SUBTLE_CHECK|SUB_SUBTLE_SNAPSHOT)))
         {
           SubGravity *g = NULL;
 
@@ -2228,8 +3396,28 @@ RubyConfigTag(int argc,
   /* Check value type */
   if(T_STRING == rb_type(name))
     {
-      /* Skip on checking only */
-      if(!(subtle->flags & SUB_SUBTLE_CHECK))
+      /* Just attach proc to tag restored from snapshot */
+      if(subtle->flags & SUB_SUBTLE_SNAPSHOT)
+        {
+          int i;
+
+          for(i = 0; flags & SUB_TAG_PROC && i < subtle->tags->ndata; i++)
+            {
+              SubTag *t = TAG(subtle->tags->data[i]);
+
+              if(!strcmp(t->name, RSTRING_PTR(name)))
+                {
+                  if(!(t->flags & SUB_TAG_PROC))
+                    {
+                      t->flags |= SUB_TAG_PROC;
+                      t->proc   = proc;
+                    }
+
+                  break;
+                }
+            }
+        }
+      else if(!(subtle->flags & SUB_SUBTLE_CHECK))
         {
           int duplicate = False;
           SubTag *t = NULL;
@@ -2326,8 +3514,32 @@ RubyConfigView(int argc,
   /* Check value type */
   if(T_STRING == rb_type(name))
     {
-      /* Skip on checking only */
-      if(!(subtle->flags & SUB_SUBTLE_CHECK))
+      /* Just attach icon to view restored from snapshot */
+      if(subtle->flags & SUB_SUBTLE_SNAPSHOT)
+        {
+          int i;
+
+          for(i = 0; !NIL_P(icon) && i < subtle->views->ndata; i++)
+            {
+              SubView *v = VIEW(subtle->views->data[i]);
+
+              if(!strcmp(v->name, RSTRING_PTR(name)))
+                {
+                  if(!(v->flags & SUB_VIEW_ICON))
+                    {
+                      v->flags |= SUB_VIEW_ICON;
+                      v->icon   = ICON(subSharedMemoryAlloc(1, sizeof(SubIcon)));
+
+                      RubyIconToIcon(icon, v->icon);
+
+                      rb_ary_push(shelter, icon); ///< Protect from GC
+                    }
+
+                  break;
+                }
+            }
+        }
+      else if(!(subtle->flags & SUB_SUBTLE_CHECK))
         {
           SubView *v = NULL;
           char *re = NULL;
@@ -2370,13 +3582,19 @@ RubyConfigView(int argc,
 
 /* RubyConfigOn {{{ */
 /*
- * call-seq: on(event, &block) -> nil
+ * call-seq: on(event, &block)         -> nil
+ *           on(event, filter, &block) -> nil
  *
- * Event block for hooks
+ * Event block for hooks, client hooks can be filtered with the matcher
+ * syntax of tags to skip calls for other clients
  *
  *  on :event do |s|
  *    puts s.name
  *  end
+ *
+ *  on :client_create, :class => "Firefox" do |c|
+ *    puts c.name
+ *  end
  */
 
 static VALUE
@@ -2384,18 +3602,46 @@ RubyConfigOn(int argc,
   VALUE *argv,
   VALUE self)
 {
-  VALUE event = Qnil, value = Qnil;
+  VALUE event = Qnil, value = Qnil, filter = Qnil;
+
+  rb_scan_args(argc, argv, "12", &event, &value, &filter);
 
-  rb_scan_args(argc, argv, "11", &event, &value);
+  /* Check for filter */
+  if(T_HASH == rb_type(value))
+    {
+      filter = value;
+      value  = Qnil;
+    }
 
   /* Check value type */
   if(T_SYMBOL == rb_type(event))
     {
+      SubHook *h = NULL;
+
       if(subtle->flags & SUB_SUBTLE_CHECK) return Qnil; ///< Skip on check
 
       if(rb_block_given_p()) value = rb_block_proc(); ///< Get proc
 
-      RubyEvalHook(event, value);
+      /* Add filter */
+      if((h = RubyEvalHook(event, value)) && T_HASH == rb_type(filter))
+        {
+          VALUE rargs[2] = { 0 };
+
+          h->filter = subTagNew("filter", NULL);
+          rargs[0]  = (VALUE)h->filter;
+
+          rb_hash_foreach(filter, RubyForeachMatcher, (VALUE)&rargs);
+
+          /* Filters need a client and at least one matcher */
+          if(!(h->flags & SUB_HOOK_TYPE_CLIENT) || !h->filter->matcher)
+            {
+              subHookRemove(h);
+              subRubyRelease(h->proc);
+              subHookKill(h);
+
+              rb_raise(rb_eArgError, "Unknown filter for on");
+            }
+        }
     }
   else rb_raise(rb_eArgError, "Unknown value type for on");
 
@@ -2558,7 +3804,8 @@ RubyConfigStyle(VALUE self,
           return Qnil;
         }
 
-      if(subtle->flags & SUB_SUBTLE_CHECK) return Qnil; ///< Skip on check
+      /* Skip on check or when restored from snapshot */
+      if(subtle->flags & (SUB_SUBTLE_CHECK|SUB_SUBTLE_SNAPSHOT)) return Qnil;
 
       /* Collect options */
       klass   = rb_const_get(mod, rb_intern("Options"));
@@ -2579,67 +3826,25 @@ RubyConfigStyle(VALUE self,
   return Qnil;
 } /* }}} */
 
-/* RubyConfigLoadConfig {{{ */
-/*
- * call-seq: load_config(file) -> true or false
- *
- * Load config file
- *
- *  load_config "gravities.rb"
- *  => true
- */
-
-static VALUE
-RubyConfigLoadConfig(VALUE self,
-  VALUE file)
-{
-  int state = 0;
-  char buf[100] = { 0 };
-  VALUE rargs[2] = { Qnil };
-
-  /* Check if file exists otherwise try to find it */
-  if(-1 == access(RSTRING_PTR(file), R_OK))
-    {
-      int len = 0;
-      char *home = NULL, *dirs = NULL, *tok = NULL,
-        tokens[200] = { 0 }, *tokensp = tokens;
-
-      /* Combine XDG paths */
-      if((home = getenv("XDG_CONFIG_HOME")))
-        len += snprintf(tokens, sizeof(tokens), "%s", home);
-      else len += snprintf(tokens, sizeof(tokens), "%s/.config",
-        getenv("HOME"));
-
-      if((dirs = getenv("XDG_CONFIG_DIRS")))
-        len += snprintf(tokens + len, sizeof(tokens), ":%s", dirs);
-      else len += snprintf(tokens + len, sizeof(tokens), ":%s/%s",
-        "/etc/xdg", PKG_NAME);
-
-      if((home = getenv("XDG_DATA_HOME")))
-        {
-          snprintf(buf, sizeof(buf), "%s:%s/%s/sublets",
-            tokens, home, PKG_NAME);
-        }
-      else snprintf(buf, sizeof(buf), "%s:%s/.local/share/%s/sublets",
-        tokens, getenv("HOME"), PKG_NAME);
-
-      /* Search file in XDG paths */
-      while((tok = strsep(&tokensp, ":")))
-        {
-          /* Check if config file exists in tok or tok/subtle */
-          snprintf(buf, sizeof(buf), "%s/%s", tok, RSTRING_PTR(file));
+/* RubyConfigLoadConfig {{{ */
+/*
+ * call-seq: load_config(file) -> true or false
+ *
+ * Load config file
+ *
+ *  load_config "gravities.rb"
+ *  => true
+ */
 
-          if(-1 != access(buf, R_OK)) break;
-          else
-            {
-              snprintf(buf, sizeof(buf), "%s/%s/%s",
-                tok, PKG_NAME, RSTRING_PTR(file));
+static VALUE
+RubyConfigLoadConfig(VALUE self,
+  VALUE file)
+{
+  int state = 0;
+  char buf[100] = { 0 };
+  VALUE rargs[2] = { Qnil };
 
-              if(-1 != access(buf, R_OK)) break;
-            }
-        }
-    }
-  else snprintf(buf, sizeof(buf), "%s", RSTRING_PTR(file));
+  RubyFindConfig(RSTRING_PTR(file), buf, sizeof(buf));
 
   printf("Reading file `%s'\n", buf);
 
@@ -2647,6 +3852,10 @@ RubyConfigLoadConfig(VALUE self,
   rargs[0] = rb_str_new2(buf);
   rargs[1] = self;
 
+  /* Track config files for snapshot */
+  if(config_instance == self && !NIL_P(config_files))
+    rb_ary_push(config_files, rargs[0]);
+
   rb_protect(RubyWrapEvalFile, (VALUE)&rargs, &state);
   if(state)
     {
@@ -2860,6 +4069,12 @@ RubySubletOn(VALUE self,
                         p->flags |= methods[i].flags;
                       else p->sublet->flags |= methods[i].flags;
 
+                      /* Store arity for optional arguments */
+                      if(methods[i].flags & SUB_SUBLET_DATA)
+                        p->sublet->data_arity = MINMAX(arity, 1, 2);
+                      else if(methods[i].flags & SUB_PANEL_DOWN)
+                        p->sublet->down_arity = MINMAX(arity, 1, 4);
+
                       /* Create instance method from proc */
                       rb_funcall(sing, meth, 2, methods[i].real, proc);
 
@@ -3060,6 +4275,8 @@ RubySubletDataReader(VALUE self)
             {
               SubTextItem *item = (SubTextItem *)p->sublet->text->items[i];
 
+              if(item->flags & SUB_TEXT_GRAPH) continue;
+
               if(Qnil == string) rb_str_new2(item->data.string);
               else rb_str_cat(string, item->data.string, strlen(item->data.string));
             }
@@ -3107,6 +4324,75 @@ RubySubletDataWriter(VALUE self,
   return Qnil;
 } /* }}} */
 
+/* RubySubletGraph {{{ */
+/*
+ * call-seq: graph(size, max) -> nil
+ *
+ * Set number of samples and scale of the graph of a Sublet. The graph is
+ * placed with ^%^ or with ^%width^ in the data of the Sublet and scales to
+ * the peak of the samples unless a max value is given.
+ *
+ *  sublet.graph(60, 100)
+ *  => nil
+ */
+
+static VALUE
+RubySubletGraph(int argc,
+  VALUE *argv,
+  VALUE self)
+{
+  SubPanel *p = NULL;
+  VALUE size = Qnil, max = Qnil;
+
+  rb_scan_args(argc, argv, "11", &size, &max);
+
+  Data_Get_Struct(self, SubPanel, p);
+  if(p)
+    {
+      /* Check value types */
+      if(FIXNUM_P(size) && 0 < FIX2INT(size) &&
+          (NIL_P(max) || rb_obj_is_kind_of(max, rb_cNumeric)))
+        {
+          subTextGraph(p->sublet->text, FIX2INT(size),
+            NIL_P(max) ? 0 : NUM2DBL(max));
+        }
+      else rb_raise(rb_eArgError, "Unknown value type");
+    }
+
+  return Qnil;
+} /* }}} */
+
+/* RubySubletPush {{{ */
+/*
+ * call-seq: push(value) -> nil
+ *
+ * Append a sample to the graph of a Sublet and redraw only the graph
+ *
+ *  sublet.push(42)
+ *  => nil
+ */
+
+static VALUE
+RubySubletPush(VALUE self,
+  VALUE value)
+{
+  SubPanel *p = NULL;
+
+  Data_Get_Struct(self, SubPanel, p);
+  if(p)
+    {
+      /* Check value type */
+      if(rb_obj_is_kind_of(value, rb_cNumeric))
+        {
+          if(subTextGraphPush(p->sublet->text, NUM2DBL(value)))
+            subPanelRenderGraph(p->sublet);
+        }
+      else rb_raise(rb_eArgError, "Unknown value type");
+    }
+
+  return Qnil;
+} /* }}} */
+
 /* RubySubletGeometryReader {{{ */
 /*
  * call-seq: geometry -> Subtlext::Geometry
@@ -3556,6 +4842,8 @@ subRubyInit(void)
   rb_define_method(sublet, "interval=",      RubySubletIntervalWriter,    1);
   rb_define_method(sublet, "data",           RubySubletDataReader,        0);
   rb_define_method(sublet, "data=",          RubySubletDataWriter,        1);
+  rb_define_method(sublet, "graph",          RubySubletGraph,            -1);
+  rb_define_method(sublet, "push",           RubySubletPush,              1);
   rb_define_method(sublet, "geometry",       RubySubletGeometryReader,    0);
   rb_define_method(sublet, "screen",         RubySubletScreenReader,      0);
   rb_define_method(sublet, "show",           RubySubletShow,              0);
@@ -3565,9 +4853,63 @@ subRubyInit(void)
   rb_define_method(sublet, "unwatch",        RubySubletUnwatch,           0);
   rb_define_method(sublet, "warn",           RubySubletWarn,              1);
 
+  /* Backend for in-process subtlext */
+  if(subtle->dpy)
+    {
+      rb_define_const(mod, "Backend",
+        Data_Wrap_Struct(rb_cObject, NULL, NULL, subRpcBackend()));
+      rb_funcall(mod, rb_intern("private_constant"), 1, CHAR2SYM("Backend"));
+    }
+
   /* Bypassing garbage collection */
-  shelter = rb_ary_new();
+  shelter  = rb_ary_new();
+  wrappers = rb_hash_new();
   rb_gc_register_address(&shelter);
+  rb_gc_register_address(&wrappers);
+
+  /* Resolve ids for subtlext objects once */
+  ext.id_new      = rb_intern("new");
+  ext.iv_id       = rb_intern("@id");
+  ext.iv_win      = rb_intern("@win");
+  ext.iv_flags    = rb_intern("@flags");
+  ext.iv_tags     = rb_intern("@tags");
+  ext.iv_name     = rb_intern("@name");
+  ext.iv_instance = rb_intern("@instance");
+  ext.iv_klass    = rb_intern("@klass");
+  ext.iv_role     = rb_intern("@role");
+  ext.iv_geometry = rb_intern("@geometry");
+  ext.iv_gravity  = rb_intern("@gravity");
+  ext.id_loaded   = rb_intern("loaded=");
+  ext.id_x        = rb_intern("x");
+  ext.id_y        = rb_intern("y");
+  ext.id_width    = rb_intern("width");
+  ext.id_height   = rb_intern("height");
+
+  /* Resolve ids for sublet calls once */
+  calls.configure = rb_intern("__configure");
+  calls.run       = rb_intern("__run");
+  calls.data      = rb_intern("__data");
+  calls.watch     = rb_intern("__watch");
+  calls.down      = rb_intern("__down");
+  calls.over      = rb_intern("__over");
+  calls.out       = rb_intern("__out");
+  calls.unload    = rb_intern("__unload");
+  calls.call      = rb_intern("call");
+
+  /* Prepare idle GC */
+  subtle->gc_budget = GCBUDGET;
+
+  gc.options   = rb_hash_new();
+  gc.allocated = CHAR2SYM("total_allocated_objects");
+
+#ifdef HAVE_RB_GC_STAT
+  gc.base      = rb_gc_stat(gc.allocated);
+  gc.count     = rb_gc_count();
+
+  rb_hash_aset(gc.options, CHAR2SYM("full_mark"),       Qfalse);
+  rb_hash_aset(gc.options, CHAR2SYM("immediate_sweep"), Qfalse);
+#endif /* HAVE_RB_GC_STAT */
+  rb_gc_register_address(&gc.options);
 
   subSubtleLogDebugSubtle("Init\n");
 } /* }}} */
@@ -3580,6 +4922,7 @@ subRubyInit(void)
 void
 subRubyLoadConfig(void)
 {
+  char path[100] = { 0 };
   VALUE klass = Qnil;
   SubTag *t = NULL;
 
@@ -3588,29 +4931,22 @@ subRubyLoadConfig(void)
       (t = subTagNew("default", NULL)))
     subArrayPush(subtle->tags, (void *)t);
 
-  /* Reset styles */
-  subStyleReset(&subtle->styles.all,        0); ///< Ensure sane base values
-  subStyleReset(&subtle->styles.views,     -1);
-  subStyleReset(&subtle->styles.title,     -1);
-  subStyleReset(&subtle->styles.sublets,   -1);
-  subStyleReset(&subtle->styles.separator, -1);
-  subStyleReset(&subtle->styles.clients,    0);
-  subStyleReset(&subtle->styles.subtle,     0);
-
-  /* Reset values */
-  subtle->gravity           = -1;
-  subtle->styles.subtle.bg  = -1; ///< Must be -1 for wallpaper
-  subtle->styles.urgent     = NULL;
-  subtle->styles.occupied   = NULL;
-  subtle->styles.focus      = NULL;
-  subtle->styles.viewsep    = NULL;
-  subtle->styles.subletsep  = NULL;
+  RubyResetStyles();
 
   /* Create and register config values */
   config_sublets = rb_hash_new();
   config_methods = rb_ary_new();
+  config_files   = rb_ary_new();
   rb_gc_register_address(&config_sublets);
   rb_gc_register_address(&config_methods);
+  rb_gc_register_address(&config_files);
+
+  RubyFindConfig(subtle->paths.config ? subtle->paths.config : PKG_CONFIG,
+    path, sizeof(path));
+
+  /* Restore values from snapshot and just eval procs of config */
+  if(!(subtle->flags & SUB_SUBTLE_CHECK) && RubySnapshotLoad(path))
+    subtle->flags |= SUB_SUBTLE_SNAPSHOT;
 
   /* Load supplied config or default */
   klass           = rb_const_get(mod, rb_intern("Config"));
@@ -3627,10 +4963,20 @@ subRubyLoadConfig(void)
   else if(subtle->flags & SUB_SUBTLE_CHECK) printf("Syntax OK\n");
 
   /* If not check only, lazy eval config values */
-  if(!(subtle->flags & SUB_SUBTLE_CHECK)) RubyEvalConfig();
+  if(!(subtle->flags & SUB_SUBTLE_CHECK))
+    {
+      /* Store values before they are converted */
+      if(!(subtle->flags & SUB_SUBTLE_SNAPSHOT)) RubySnapshotSave(path);
 
-  /* Release methods list */
+      subtle->flags &= ~SUB_SUBTLE_SNAPSHOT;
+
+      RubyEvalConfig();
+    }
+
+  /* Release methods and files list */
   rb_gc_unregister_address(&config_methods);
+  rb_gc_unregister_address(&config_files);
+  config_files = Qnil;
 
   return;
 } /* }}} */
@@ -3642,9 +4988,15 @@ subRubyLoadConfig(void)
 void
 subRubyReloadConfig(void)
 {
-  int i, rx = 0, ry = 0, x = 0, y = 0, *vids = NULL;
+  int i, j, rx = 0, ry = 0, x = 0, y = 0, *vids = NULL, full = False;
+  int ngravities = 0;
   unsigned int mask = 0;
+  char *regravity = NULL;
+  TAGS retag = 0;
   Window root = None, win = None;
+  VALUE sublets = config_sublets;
+  SubArray *tags = subtle->tags, *views = subtle->views,
+    *gravities = subtle->gravities;
   SubClient *c = NULL;
 
   /* Reset panel height */
@@ -3652,9 +5004,11 @@ subRubyReloadConfig(void)
 
   /* Reset flags before reloading */
   subtle->flags &= (SUB_SUBTLE_DEBUG|SUB_SUBTLE_EWMH|SUB_SUBTLE_RUN|
-    SUB_SUBTLE_XINERAMA|SUB_SUBTLE_XRANDR|SUB_SUBTLE_URGENT);
+    SUB_SUBTLE_XINERAMA|SUB_SUBTLE_XRANDR|SUB_SUBTLE_XSYNC|
+    SUB_SUBTLE_URGENT);
 
   /* Unregister config values */
+  rb_ary_push(shelter, sublets); ///< Keep for comparison
   rb_gc_unregister_address(&config_sublets);
   rb_gc_unregister_address(&config_instance);
   rb_gc_unregister_address(&config_methods);
@@ -3680,19 +5034,62 @@ subRubyReloadConfig(void)
       vids[i]   = s->viewid; ///< Store views
       s->flags &= ~(SUB_SCREEN_STIPPLE|SUB_SCREEN_PANEL1|SUB_SCREEN_PANEL2);
 
+      /* Detach sublets to keep them loaded */
+      for(j = 0; s->panels && j < subtle->sublets->ndata; j++)
+        subArrayRemove(s->panels, subtle->sublets->data[j]);
+
       subArrayClear(s->panels, True);
     }
 
-  /* Clear arrays */
-  subArrayClear(subtle->hooks,     True); ///< Must be first
-  subArrayClear(subtle->grabs,     True);
-  subArrayClear(subtle->gravities, True);
-  subArrayClear(subtle->sublets,   False);
-  subArrayClear(subtle->tags,      True);
-  subArrayClear(subtle->views,     True);
+  /* Clear config hooks first, sublet hooks are kept */
+  for(i = 0; i < subtle->hooks->ndata; i++)
+    {
+      SubHook *hook = HOOK(subtle->hooks->data[i]);
+
+      if(!RubySubletOwner(hook->proc))
+        {
+          subHookRemove(hook);
+          subHookKill(hook);
+          i--; ///< Prevent skipping of entries
+        }
+    }
+
+  /* Clear arrays and keep tags, views and gravities to find changes */
+  subArrayClear(subtle->grabs, True);
+
+  subtle->tags      = subArrayNew();
+  subtle->views     = subArrayNew();
+  subtle->gravities = subArrayNew();
 
   /* Load and configure */
   subRubyLoadConfig();
+
+  /* Unload sublets with changed file or config */
+  for(i = 0; i < subtle->sublets->ndata; i++)
+    {
+      unsigned long hash = 0;
+      SubPanel *p = PANEL(subtle->sublets->data[i]);
+      VALUE name = p->sublet->name ? CHAR2SYM(p->sublet->name) : Qnil;
+
+      if(NIL_P(name) || !RubyFileHash(p->sublet->path, &hash) ||
+          hash != p->sublet->hash ||
+          !rb_equal(rb_hash_lookup(sublets, name),
+            rb_hash_lookup(config_sublets, name)))
+        {
+          subRubyUnloadSublet(p);
+          i--; ///< Prevent skipping of entries
+        }
+      else
+        {
+          /* Update style and grabs of kept sublet */
+          p->sublet->styleid = -1;
+          RubySubletStyle(p->sublet);
+          RubySubletGrabs(p);
+        }
+    }
+
+  subRubyRelease(sublets);
+
   subRubyLoadSublets();
   subRubyLoadPanels();
   subDisplayConfigure();
@@ -3704,12 +5101,91 @@ subRubyReloadConfig(void)
         SCREEN(subtle->screens->data[i])->viewid = vids[i];
     }
 
-  /* Update client tags */
+  /* Changed gravity ids require a full update, changed geometries
+   * only affect clients using them */
+  ngravities = gravities->ndata;
+  regravity  = (char *)subSharedMemoryAlloc(MAX(1, ngravities),
+    sizeof(char));
+
+  for(i = 0; !full && i < ngravities; i++)
+    {
+      SubGravity *g1 = GRAVITY(gravities->data[i]);
+      SubGravity *g2 = GRAVITY(subArrayGet(subtle->gravities, i));
+
+      if(!g2 || g1->quark != g2->quark) full = True;
+      else if(g1->flags != g2->flags || g1->geom.x != g2->geom.x ||
+          g1->geom.y != g2->geom.y || g1->geom.width != g2->geom.width ||
+          g1->geom.height != g2->geom.height)
+        regravity[i] = True;
+    }
+
+  /* Collect changed tags */
+  for(i = 0; i < MAX(tags->ndata, subtle->tags->ndata); i++)
+    {
+      SubTag *t1 = TAG(subArrayGet(tags, i));
+      SubTag *t2 = TAG(subArrayGet(subtle->tags, i));
+
+      if(!t1 || !t2 || !subTagEqual(t1, t2)) retag |= (1L << (i + 1));
+    }
+
+  /* Collect tags of changed views */
+  if(views->ndata != subtle->views->ndata) full = True;
+
+  for(i = 0; !full && i < views->ndata; i++)
+    {
+      SubView *v1 = VIEW(views->data[i]), *v2 = VIEW(subtle->views->data[i]);
+
+      if(v1->tags != v2->tags || v1->flags != v2->flags ||
+          strcmp(v1->name, v2->name))
+        retag |= (v1->tags|v2->tags|DEFAULTTAG);
+    }
+
+  /* Kill old objects without calling hooks */
+  subtle->flags |= SUB_SUBTLE_MUTE;
+
+  subArrayKill(tags,      True);
+  subArrayKill(views,     True);
+  subArrayKill(gravities, True);
+
+  subtle->flags &= ~SUB_SUBTLE_MUTE;
+
+  /* Update tags of affected clients */
   for(i = 0; i < subtle->clients->ndata; i++)
     {
       int flags = 0;
 
-      c            = CLIENT(subtle->clients->data[i]);
+      c = CLIENT(subtle->clients->data[i]);
+
+      /* Check if client has or matches a changed tag */
+      if(!full && !(c->tags & retag))
+        {
+          for(j = 0; j < subtle->tags->ndata; j++)
+            if(retag & (1L << (j + 1)) &&
+                subTagMatcherCheck(TAG(subtle->tags->data[j]), c))
+              break;
+
+          /* Check if client uses a changed gravity */
+          if(j == subtle->tags->ndata)
+            {
+              for(j = 0; j < subtle->views->ndata; j++)
+                if(0 <= c->gravities[j] && c->gravities[j] < ngravities &&
+                    regravity[c->gravities[j]])
+                  break;
+
+              if(j == subtle->views->ndata) continue;
+            }
+        }
+
+      /* Resize gravities when view count changed */
+      if(full)
+        {
+          c->gravities = (int *)subSharedMemoryRealloc((void *)c->gravities,
+            subtle->views->ndata * sizeof(int));
+
+          for(j = 0; j < subtle->views->ndata; j++)
+            c->gravities[j] = -1 == subtle->gravity ? 0 : subtle->gravity;
+        }
+
       c->gravityid = -1;
       c->flags     = (c->flags & (SUB_TYPE_CLIENT|SUB_CLIENT_FOCUS|
         SUB_CLIENT_INPUT|SUB_CLIENT_CLOSE)); ///< Reset flags
@@ -3741,6 +5217,7 @@ subRubyReloadConfig(void)
   /* Hook: Reload */
   subHookCall(SUB_HOOK_RELOAD, NULL);
 
+  free(regravity);
   free(vids);
 } /* }}} */
 
@@ -3758,9 +5235,13 @@ subRubyLoadSublet(const char *file)
 
   /* Load sublet */
   p = subPanelNew(SUB_PANEL_SUBLET);
+  p->sublet->path     = strdup(file);
   p->sublet->instance = Data_Wrap_Struct(rb_const_get(mod,
     rb_intern("Sublet")), NULL, NULL, (void *)p);
 
+  /* Store content hash for reload */
+  RubyFileHash(file, &p->sublet->hash);
+
   rb_ary_push(shelter, p->sublet->instance); ///< Protect from GC
 
   if(Qfalse == RubyConfigLoadConfig(p->sublet->instance, rb_str_new2(file)))
@@ -3835,7 +5316,7 @@ subRubyUnloadSublet(SubPanel *p)
 
       if(RubyReceiver(p->sublet->instance, hook->proc))
         {
-          subArrayRemove(subtle->hooks, (void *)hook);
+          subHookRemove(hook);
           subRubyRelease(hook->proc);
           subHookKill(hook);
           i--; ///< Prevent skipping of entries
@@ -3883,6 +5364,113 @@ subRubyLoadPanels(void)
     }
 } /* }}} */
 
+ /** subRubyReloadSublet {{{
+  * @brief Reload changed sublet and keep its panel slot
+  * @param[in]  file  File name in sublet path
+  **/
+
+void
+subRubyReloadSublet(const char *file)
+{
+  int i, j, len = 0;
+  char buf[100] = { 0 };
+  unsigned long hash = 0;
+  SubPanel *p = NULL, *old = NULL;
+
+  assert(file);
+
+  if(fnmatch("*.rb", file, FNM_PATHNAME)) return;
+
+  len = RubySubletPath(buf, sizeof(buf));
+  snprintf(buf + len, sizeof(buf) - len, "/%s", file);
+
+  /* Find loaded sublet */
+  for(i = 0; i < subtle->sublets->ndata; i++)
+    {
+      SubPanel *p2 = PANEL(subtle->sublets->data[i]);
+
+      if(!strcmp(buf, p2->sublet->path))
+        {
+          old = p2;
+          break;
+        }
+    }
+
+  /* Skip new sublets and unchanged files */
+  if(!old || !RubyFileHash(buf, &hash) || hash == old->sublet->hash)
+    return;
+
+  /* Detach grabs to pass them to the new instance */
+  for(i = 0; i < subtle->grabs->ndata; i++)
+    {
+      SubGrab *g = GRAB(subtle->grabs->data[i]);
+
+      if(g->flags & SUB_GRAB_PROC &&
+          RubyReceiver(old->sublet->instance, g->data.num))
+        {
+          VALUE name = rb_funcall(rb_funcall(g->data.num, rb_intern("name"),
+            0, NULL), rb_intern("to_s"), 0, NULL);
+
+          if(!strncmp("__grab_", RSTRING_PTR(name), 7))
+            {
+              subRubyRelease(g->data.num);
+
+              g->flags    ^= (SUB_GRAB_PROC|SUB_RUBY_DATA);
+              g->data.num  = CHAR2SYM(RSTRING_PTR(name) + 7);
+            }
+        }
+    }
+
+  /* Load new instance and keep old one on error */
+  i = subtle->sublets->ndata;
+  subRubyLoadSublet(buf);
+
+  if(i == subtle->sublets->ndata)
+    {
+      RubySubletGrabs(old);
+
+      return;
+    }
+
+  p = PANEL(subtle->sublets->data[subtle->sublets->ndata - 1]);
+
+  /* Move new instance into panel slot */
+  for(i = 0; i < subtle->screens->ndata; i++)
+    {
+      SubScreen *s = SCREEN(subtle->screens->data[i]);
+
+      for(j = 0; s->panels && j < s->panels->ndata; j++)
+        {
+          SubPanel *p2 = PANEL(s->panels->data[j]);
+
+          if(p2 == old)
+            {
+              p->flags  |= (old->flags & (SUB_PANEL_SPACER1|
+                SUB_PANEL_SPACER2|SUB_PANEL_SEPARATOR1|SUB_PANEL_SEPARATOR2|
+                SUB_PANEL_BOTTOM|SUB_PANEL_HIDDEN|SUB_PANEL_CENTER));
+              p->screen  = old->screen;
+              p->x       = old->x;
+              p->width   = old->width; ///< Keep layout unless size changes
+
+              s->panels->data[j] = (void *)p;
+            }
+          else if(p2->flags & SUB_PANEL_COPY && p2->sublet == old->sublet)
+            {
+              p2->flags  = (p2->flags & ~(SUB_PANEL_DOWN|SUB_PANEL_OVER|
+                SUB_PANEL_OUT)) | (p->flags & (SUB_PANEL_DOWN|SUB_PANEL_OVER|
+                SUB_PANEL_OUT));
+              p2->sublet = p->sublet;
+            }
+        }
+    }
+
+  subRubyUnloadSublet(old);
+  subArraySort(subtle->sublets, subPanelCompare);
+
+  /* Update panels */
+  subScreenRenderSublet(p->sublet);
+} /* }}} */
+
  /** subRubyLoadSublets {{{
   * @brief Load sublets from path
   **/
@@ -3890,7 +5478,7 @@ subRubyLoadPanels(void)
 void
 subRubyLoadSublets(void)
 {
-  int i, num, len = 0;
+  int i, j, num, len = 0;
   char buf[100] = { 0 };
   struct dirent **entries = NULL;
 
@@ -3909,21 +5497,14 @@ subRubyLoadSublets(void)
     }
 #endif /* HAVE_SYS_INOTIFY_H */
 
-  /* Check path */
-  if(subtle->paths.sublets)
-    len += snprintf(buf, sizeof(buf), "%s", subtle->paths.sublets);
-  else
-    {
-      char *home = NULL;
+  len = RubySubletPath(buf, sizeof(buf));
 
-      if((home = getenv("XDG_DATA_HOME")))
-        {
-          len += snprintf(buf, sizeof(buf), "%s/%s/sublets",
-            home, PKG_NAME);
-        }
-      else len += snprintf(buf, sizeof(buf), "%s/.local/share/%s/sublets",
-        getenv("HOME"), PKG_NAME);
-    }
+#ifdef HAVE_SYS_INOTIFY_H
+  /* Watch sublet path for changed sublets */
+  if(!subtle->watch && 0 < (subtle->watch = inotify_add_watch(
+      subtle->notify, buf, IN_CLOSE_WRITE|IN_MOVED_TO)))
+    subSubtleLogDebug("Inotify: add watch=%s\n", buf);
+#endif /* HAVE_SYS_INOTIFY_H */
 
   /* Scan directory */
   if(0 < ((num = scandir(buf, &entries, RubyFilter, alphasort))))
@@ -3933,7 +5514,12 @@ subRubyLoadSublets(void)
           /* Temporary append file name to path */
           snprintf(buf + len, sizeof(buf), "/%s", entries[i]->d_name);
 
-          subRubyLoadSublet(buf);
+          /* Skip sublets kept on reload */
+          for(j = 0; j < subtle->sublets->ndata; j++)
+            if(!strcmp(buf, PANEL(subtle->sublets->data[j])->sublet->path))
+              break;
+
+          if(j == subtle->sublets->ndata) subRubyLoadSublet(buf);
 
           /* Restore path */
           buf[strlen(buf) - (strlen(entries[i]->d_name) + 1)] = '\0';
@@ -3963,6 +5549,9 @@ subRubyCall(int type,
   int state = 0;
   VALUE rargs[3] = { Qnil };
 
+  /* Skip undefined sublet callbacks without entering ruby */
+  if(!RubyCallable(type, proc)) return 1;
+
   /* Wrap up data */
   rargs[0] = (VALUE)type;
   rargs[1] = proc;
@@ -3972,14 +5561,70 @@ subRubyCall(int type,
   rb_protect(RubyWrapCall, (VALUE)&rargs, &state);
   if(state) RubyBacktrace();
 
-#ifdef DEBUG
-  subSubtleLogDebugRuby("Call: GC START\n");
-  rb_gc_start();
-#endif /* DEBUG */
+  /* Enable GC again once handlers of this batch used up the budget */
+  if(gc.busy && !RubyGCBudget())
+    {
+      rb_gc_enable();
+      gc.busy = False;
+    }
+
+  /* Hand over actions of in-process subtlext */
+  subRpcFlush();
 
   return !state; ///< Reverse odd logic
 } /* }}} */
 
+ /** subRubyBusy {{{
+  * @brief Defer implicit ruby GC during latency critical handlers
+  * @param[in]  busy  Whether handlers are about to run
+  **/
+
+void
+subRubyBusy(int busy)
+{
+  if(NIL_P(gc.options)) return;
+
+  /* Keep GC enabled when the budget is already used up */
+  if((gc.busy = (busy && RubyGCBudget()))) rb_gc_disable();
+  else rb_gc_enable();
+} /* }}} */
+
+ /** subRubyIdle {{{
+  * @brief Run deferred ruby GC when idle and heap grew over budget
+  **/
+
+void
+subRubyIdle(void)
+{
+#ifdef HAVE_RB_GC_STAT
+  size_t allocated = 0;
+
+  if(NIL_P(gc.options)) return;
+
+  /* Restart budget after implicit runs */
+  allocated = rb_gc_stat(gc.allocated);
+  if(gc.count != rb_gc_count())
+    {
+      gc.base  = allocated;
+      gc.count = rb_gc_count();
+    }
+
+  /* Run minor GC with lazy sweep */
+  if(allocated - gc.base >= (size_t)subtle->gc_budget)
+    {
+      int state = 0;
+
+      rb_protect(RubyWrapCollect, Qnil, &state);
+      if(state) RubyBacktrace();
+
+      gc.base  = rb_gc_stat(gc.allocated);
+      gc.count = rb_gc_count();
+
+      subSubtleLogDebugRuby("Idle: GC count=%zu\n", gc.count);
+    }
+#endif /* HAVE_RB_GC_STAT */
+} /* }}} */
+
  /** subRubyRelease {{{
   * @brief Release value from shelter
   * @param[in]  value  The released value
@@ -3995,6 +5640,17 @@ subRubyRelease(unsigned long value)
   return state;
 } /* }}} */
 
+ /** subRubyReleaseObject {{{
+  * @brief Release cached subtlext object of subtle object
+  * @param[in]  data  Subtle object
+  **/
+
+void
+subRubyReleaseObject(void *data)
+{
+  if(!NIL_P(wrappers)) rb_hash_delete(wrappers, LONG2NUM((long)data));
+} /* }}} */
+
  /** subRubyFinish {{{
   * @brief Finish ruby stack
   **/
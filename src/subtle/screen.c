@@ -68,12 +68,14 @@ ScreenPublish(void)
 /* ScreenClear {{{ */
 static void
 ScreenClear(SubScreen *s,
-  unsigned long col)
+  unsigned long col,
+  int x,
+  int width)
 {
   /* Clear pixmap */
   XSetForeground(subtle->dpy, subtle->gcs.draw, col);
   XFillRectangle(subtle->dpy, s->drawable, subtle->gcs.draw,
-    0, 0, s->base.width, subtle->ph);
+    x, 0, width, subtle->ph);
 
    /* Draw stipple on panels */
   if(s->flags & SUB_SCREEN_STIPPLE)
@@ -84,10 +86,196 @@ ScreenClear(SubScreen *s,
       XChangeGC(subtle->dpy, subtle->gcs.stipple, GCStipple, &gvals);
 
       XFillRectangle(subtle->dpy, s->drawable, subtle->gcs.stipple,
-        0, 0, s->base.width, subtle->ph);
+        x, 0, width, subtle->ph);
     }
 } /* }}} */
 
+/* ScreenCopy {{{ */
+static void
+ScreenCopy(SubScreen *s,
+  Window panel,
+  int x,
+  int width)
+{
+  /* Keep copy of first panel, second one stays in render area */
+  if(panel == s->panel1)
+    {
+      XCopyArea(subtle->dpy, s->drawable, s->drawable, subtle->gcs.draw,
+        x, 0, width, subtle->ph, x, subtle->ph);
+    }
+
+  XCopyArea(subtle->dpy, s->drawable, panel, subtle->gcs.draw,
+    x, 0, width, subtle->ph, x, 0);
+} /* }}} */
+
+/* ScreenLayout {{{ */
+static void
+ScreenLayout(SubScreen *s)
+{
+  SubPanel *p = NULL;
+  int j, npanel = 0, center = False, offset = 0;
+  int x[4] = { 0 }, nspacer[4] = { 0 }; ///< Waste ints but it's easier for the algo
+  int sw[4] = { 0 }, fix[4] = { 0 }, width[4] = { 0 }, spacer[4] = { 0 };
+
+  /* Pass 1: Collect width for spacer sizes */
+  for(j = 0; s->panels && j < s->panels->ndata; j++)
+    {
+      p = PANEL(s->panels->data[j]);
+
+      /* Check flags */
+      if(p->flags & SUB_PANEL_HIDDEN)  continue;
+      if(0 == npanel && p->flags & SUB_PANEL_BOTTOM)
+        {
+          npanel = 1;
+          center = False;
+        }
+      if(p->flags & SUB_PANEL_CENTER) center = !center;
+
+      /* Offset selects panel variables for either center or not */
+      offset = center ? npanel + 2 : npanel;
+
+      if(p->flags & SUB_PANEL_SPACER1) spacer[offset]++;
+      if(p->flags & SUB_PANEL_SPACER2) spacer[offset]++;
+      if(p->flags & SUB_PANEL_SEPARATOR1 &&
+          subtle->styles.separator.separator)
+        width[offset] += subtle->styles.separator.separator->width;
+      if(p->flags & SUB_PANEL_SEPARATOR2 &&
+          subtle->styles.separator.separator)
+        width[offset] += subtle->styles.separator.separator->width;
+
+      width[offset] += p->width;
+    }
+
+  /* Calculate spacer and fix sizes */
+  for(j = 0; j < 4; j++)
+    {
+      if(0 < spacer[j])
+        {
+          sw[j]  = (s->base.width - width[j]) / spacer[j];
+          fix[j] = s->base.width - (width[j] + spacer[j] * sw[j]);
+        }
+    }
+
+  /* Pass 2: Move and resize windows */
+  for(j = 0, npanel = 0, center = False;
+      s->panels && j < s->panels->ndata; j++)
+    {
+      p = PANEL(s->panels->data[j]);
+
+      /* Check flags */
+      if(p->flags & SUB_PANEL_HIDDEN) continue;
+      if(0 == npanel && p->flags & SUB_PANEL_BOTTOM)
+        {
+          /* Reset for new panel */
+          npanel     = 1;
+          nspacer[0] = 0;
+          nspacer[2] = 0;
+          x[0]       = 0;
+          x[2]       = 0;
+          center     = False;
+        }
+      if(p->flags & SUB_PANEL_CENTER) center = !center;
+
+      /* Offset selects panel variables for either center or not */
+      offset = center ? npanel + 2 : npanel;
+
+      /* Set start position of centered panel items */
+      if(center && 0 == x[offset])
+        x[offset] = (s->base.width - width[offset]) / 2;
+
+      /* Add separator before panel item */
+      if(p->flags & SUB_PANEL_SEPARATOR1 &&
+          subtle->styles.separator.separator)
+        x[offset] += subtle->styles.separator.separator->width;
+
+      /* Add spacer before item */
+      if(p->flags & SUB_PANEL_SPACER1)
+        {
+          x[offset] += sw[offset];
+
+          /* Increase last spacer size by rounding fix */
+          if(++nspacer[offset] == spacer[offset])
+            x[offset] += fix[offset];
+        }
+
+      /* Set panel position */
+      if(p->flags & SUB_PANEL_TRAY)
+        XMoveWindow(subtle->dpy, subtle->windows.tray, x[offset], 0);
+      p->x = x[offset];
+
+      /* Add separator after panel item */
+      if(p->flags & SUB_PANEL_SEPARATOR2 &&
+          subtle->styles.separator.separator)
+        x[offset] += subtle->styles.separator.separator->width;
+
+      /* Add spacer after item */
+      if(p->flags & SUB_PANEL_SPACER2)
+        {
+          x[offset] += sw[offset];
+
+          /* Increase last spacer size by rounding fix */
+          if(++nspacer[offset] == spacer[offset])
+            x[offset] += fix[offset];
+        }
+
+      x[offset] += p->width;
+    }
+} /* }}} */
+
+/* ScreenRender {{{ */
+static void
+ScreenRender(SubScreen *s)
+{
+  int j;
+  Window panel = s->panel1;
+
+  ScreenClear(s, subtle->styles.subtle.top, 0, s->base.width);
+
+  /* Render panel items */
+  for(j = 0; s->panels && j < s->panels->ndata; j++)
+    {
+      SubPanel *p = PANEL(s->panels->data[j]);
+
+      if(p->flags & SUB_PANEL_HIDDEN) continue;
+      if(panel != s->panel2 && p->flags & SUB_PANEL_BOTTOM)
+        {
+          ScreenCopy(s, panel, 0, s->base.width);
+          ScreenClear(s, subtle->styles.subtle.bottom, 0, s->base.width);
+          panel = s->panel2;
+        }
+
+      subPanelRender(p, s->drawable);
+    }
+
+  ScreenCopy(s, panel, 0, s->base.width);
+} /* }}} */
+
+/* ScreenRenderPanel {{{ */
+static void
+ScreenRenderPanel(SubScreen *s,
+  SubPanel *p)
+{
+  int x = p->x, width = p->width;
+  Window panel = p->flags & SUB_PANEL_BOTTOM ? s->panel2 : s->panel1;
+
+  /* Include separators of the item */
+  if(subtle->styles.separator.separator)
+    {
+      if(p->flags & SUB_PANEL_SEPARATOR1)
+        {
+          x     -= subtle->styles.separator.separator->width;
+          width += subtle->styles.separator.separator->width;
+        }
+      if(p->flags & SUB_PANEL_SEPARATOR2)
+        width += subtle->styles.separator.separator->width;
+    }
+
+  ScreenClear(s, p->flags & SUB_PANEL_BOTTOM ? subtle->styles.subtle.bottom :
+    subtle->styles.subtle.top, x, width);
+  subPanelRender(p, s->drawable);
+  ScreenCopy(s, panel, x, width);
+} /* }}} */
+
 /* Public */
 
  /** subScreenInit {{{
@@ -416,169 +604,153 @@ subScreenConfigure(void)
 void
 subScreenUpdate(void)
 {
-  int i;
+  int i, j;
 
   /* Update screens */
   for(i = 0; i < subtle->screens->ndata; i++)
     {
       SubScreen *s = SCREEN(subtle->screens->data[i]);
-      SubPanel *p = NULL;
-      int j, npanel = 0, center = False, offset = 0;
-      int x[4] = { 0 }, nspacer[4] = { 0 }; ///< Waste ints but it's easier for the algo
-      int sw[4] = { 0 }, fix[4] = { 0 }, width[4] = { 0 }, spacer[4] = { 0 };
 
-      /* Pass 1: Collect width for spacer sizes */
       for(j = 0; s->panels && j < s->panels->ndata; j++)
-        {
-          p = PANEL(s->panels->data[j]);
+        subPanelUpdate(PANEL(s->panels->data[j]));
 
-          subPanelUpdate(p);
+      ScreenLayout(s);
+    }
 
-          /* Check flags */
-          if(p->flags & SUB_PANEL_HIDDEN)  continue;
-          if(0 == npanel && p->flags & SUB_PANEL_BOTTOM)
-            {
-              npanel = 1;
-              center = False;
-            }
-          if(p->flags & SUB_PANEL_CENTER) center = !center;
+  subSubtleLogDebugSubtle("Update\n");
+} /* }}} */
 
-          /* Offset selects panel variables for either center or not */
-          offset = center ? npanel + 2 : npanel;
+ /** subScreenRender {{{
+  * @brief Render screens
+  **/
 
-          if(p->flags & SUB_PANEL_SPACER1) spacer[offset]++;
-          if(p->flags & SUB_PANEL_SPACER2) spacer[offset]++;
-          if(p->flags & SUB_PANEL_SEPARATOR1 &&
-              subtle->styles.separator.separator)
-            width[offset] += subtle->styles.separator.separator->width;
-          if(p->flags & SUB_PANEL_SEPARATOR2 &&
-              subtle->styles.separator.separator)
-            width[offset] += subtle->styles.separator.separator->width;
+void
+subScreenRender(void)
+{
+  int i;
 
-          width[offset] += p->width;
-        }
+  /* Render all screens */
+  for(i = 0; i < subtle->screens->ndata; i++)
+    ScreenRender(SCREEN(subtle->screens->data[i]));
 
-      /* Calculate spacer and fix sizes */
-      for(j = 0; j < 4; j++)
-        {
-          if(0 < spacer[j])
-            {
-              sw[j]  = (s->base.width - width[j]) / spacer[j];
-              fix[j] = s->base.width - (width[j] + spacer[j] * sw[j]);
-            }
-        }
+  XSync(subtle->dpy, False); ///< Sync before going on
 
-      /* Pass 2: Move and resize windows */
-      for(j = 0, npanel = 0, center = False;
-          s->panels && j < s->panels->ndata; j++)
-        {
-          p = PANEL(s->panels->data[j]);
+  subSubtleLogDebugSubtle("Render\n");
+} /* }}} */
 
-          /* Check flags */
-          if(p->flags & SUB_PANEL_HIDDEN) continue;
-          if(0 == npanel && p->flags & SUB_PANEL_BOTTOM)
-            {
-              /* Reset for new panel */
-              npanel     = 1;
-              nspacer[0] = 0;
-              nspacer[2] = 0;
-              x[0]       = 0;
-              x[2]       = 0;
-              center     = False;
-            }
-          if(p->flags & SUB_PANEL_CENTER) center = !center;
+ /** subScreenRenderSublet {{{
+  * @brief Update and render only panel items of a sublet
+  * @param[in]  sublet  A #SubSublet
+  **/
+
+void
+subScreenRenderSublet(SubSublet *sublet)
+{
+  int i, j;
 
-          /* Offset selects panel variables for either center or not */
-          offset = center ? npanel + 2 : npanel;
+  assert(sublet);
 
-          /* Set start position of centered panel items */
-          if(center && 0 == x[offset])
-            x[offset] = (s->base.width - width[offset]) / 2;
+  for(i = 0; i < subtle->screens->ndata; i++)
+    {
+      SubScreen *s = SCREEN(subtle->screens->data[i]);
+      int found = False, full = False;
 
-          /* Add separator before panel item */
-          if(p->flags & SUB_PANEL_SEPARATOR1 &&
-              subtle->styles.separator.separator)
-            x[offset] += subtle->styles.separator.separator->width;
+      /* Update items of sublet and its clones */
+      for(j = 0; s->panels && j < s->panels->ndata; j++)
+        {
+          SubPanel *p = PANEL(s->panels->data[j]);
 
-          /* Add spacer before item */
-          if(p->flags & SUB_PANEL_SPACER1)
+          if(p->flags & SUB_PANEL_SUBLET && p->sublet == sublet)
             {
-              x[offset] += sw[offset];
+              int width = p->width;
 
-              /* Increase last spacer size by rounding fix */
-              if(++nspacer[offset] == spacer[offset])
-                x[offset] += fix[offset];
+              subPanelUpdate(p);
+
+              if(p->flags & SUB_PANEL_HIDDEN) continue;
+
+              found = True;
+
+              /* Other items move on resize and top items share the
+               * render area with the bottom panel */
+              if(width != p->width || (s->flags & SUB_SCREEN_PANEL2 &&
+                  !(p->flags & SUB_PANEL_BOTTOM)))
+                full = True;
             }
+        }
 
-          /* Set panel position */
-          if(p->flags & SUB_PANEL_TRAY)
-            XMoveWindow(subtle->dpy, subtle->windows.tray, x[offset], 0);
-          p->x = x[offset];
+      if(!found || !s->drawable) continue;
 
-          /* Add separator after panel item */
-          if(p->flags & SUB_PANEL_SEPARATOR2 &&
-              subtle->styles.separator.separator)
-            x[offset] += subtle->styles.separator.separator->width;
+      if(full)
+        {
+          ScreenLayout(s);
+          ScreenRender(s);
 
-          /* Add spacer after item */
-          if(p->flags & SUB_PANEL_SPACER2)
-            {
-              x[offset] += sw[offset];
+          continue;
+        }
 
-              /* Increase last spacer size by rounding fix */
-              if(++nspacer[offset] == spacer[offset])
-                x[offset] += fix[offset];
-            }
+      /* Render items in place */
+      for(j = 0; j < s->panels->ndata; j++)
+        {
+          SubPanel *p = PANEL(s->panels->data[j]);
 
-          x[offset] += p->width;
+          if(p->flags & SUB_PANEL_SUBLET && p->sublet == sublet &&
+              !(p->flags & SUB_PANEL_HIDDEN))
+            ScreenRenderPanel(s, p);
         }
     }
 
-  subSubtleLogDebugSubtle("Update\n");
+  XSync(subtle->dpy, False); ///< Sync before going on
+
+  subSubtleLogDebugSubtle("RenderSublet\n");
 } /* }}} */
 
- /** subScreenRender {{{
-  * @brief Render screens
+ /** subScreenExpose {{{
+  * @brief Collect damage of panel and repaint it from drawable
+  * @param[in]  s   A #SubScreen
+  * @param[in]  ev  A #XExposeEvent
   **/
 
 void
-subScreenRender(void)
+subScreenExpose(SubScreen *s,
+  XExposeEvent *ev)
 {
-  int i, j;
+  int y = 0;
+  Region *damage = NULL;
+  XRectangle r = { 0 };
 
-  /* Render all screens */
-  for(i = 0; i < subtle->screens->ndata; i++)
+  assert(s && ev);
+
+  /* Select panel damage and offset in drawable */
+  if(ev->window == s->panel1)
     {
-      SubScreen *s = SCREEN(subtle->screens->data[i]);
-      Window panel = s->panel1;
+      damage = &s->damage1;
+      y      = subtle->ph;
+    }
+  else damage = &s->damage2;
 
-      ScreenClear(s, subtle->styles.subtle.top);
+  if(!*damage) *damage = XCreateRegion();
 
-      /* Render panel items */
-      for(j = 0; s->panels && j < s->panels->ndata; j++)
-        {
-          SubPanel *p = PANEL(s->panels->data[j]);
+  /* Add exposed area */
+  r.x      = ev->x;
+  r.y      = ev->y;
+  r.width  = ev->width;
+  r.height = ev->height;
 
-          if(p->flags & SUB_PANEL_HIDDEN) continue;
-          if(panel != s->panel2 && p->flags & SUB_PANEL_BOTTOM)
-            {
-              XCopyArea(subtle->dpy, s->drawable, panel, subtle->gcs.draw,
-                0, 0, s->base.width, subtle->ph, 0, 0);
+  XUnionRectWithRegion(&r, *damage, *damage);
 
-              ScreenClear(s, subtle->styles.subtle.bottom);
-              panel = s->panel2;
-            }
+  /* Repaint damaged area once */
+  if(0 == ev->count && s->drawable)
+    {
+      XClipBox(*damage, &r);
+      XSetRegion(subtle->dpy, subtle->gcs.draw, *damage);
 
-          subPanelRender(p, s->drawable);
-        }
+      XCopyArea(subtle->dpy, s->drawable, ev->window, subtle->gcs.draw,
+        r.x, r.y + y, r.width, r.height, r.x, r.y);
 
-      XCopyArea(subtle->dpy, s->drawable, panel, subtle->gcs.draw,
-        0, 0, s->base.width, subtle->ph, 0, 0);
+      XSetClipMask(subtle->dpy, subtle->gcs.draw, None);
+      XDestroyRegion(*damage);
+      *damage = NULL;
     }
-
-  XSync(subtle->dpy, False); ///< Sync before going on
-
-  subSubtleLogDebugSubtle("Render\n");
 } /* }}} */
 
  /** subScreenResize {{{
@@ -629,10 +801,10 @@ subScreenResize(void)
         }
       else XUnmapWindow(subtle->dpy, s->panel2);
 
-      /* Create/update drawable for double buffering */
+      /* Create/update drawable for double buffering and panel backing */
       if(s->drawable) XFreePixmap(subtle->dpy, s->drawable);
-      s->drawable = XCreatePixmap(subtle->dpy, ROOT, s->base.width, subtle->ph,
-        XDefaultDepth(subtle->dpy, DefaultScreen(subtle->dpy)));
+      s->drawable = XCreatePixmap(subtle->dpy, ROOT, s->base.width,
+        2 * subtle->ph, XDefaultDepth(subtle->dpy, DefaultScreen(subtle->dpy)));
     }
 
   ScreenPublish();
@@ -667,6 +839,8 @@ subScreenKill(SubScreen *s)
 {
   assert(s);
 
+  subRubyReleaseObject((void *)s);
+
   if(s->panels) subArrayKill(s->panels, True);
 
   /* Destroy panel windows */
@@ -681,8 +855,10 @@ subScreenKill(SubScreen *s)
       XDestroyWindow(subtle->dpy, s->panel2);
     }
 
-  /* Destroy drawable */
+  /* Destroy drawable and damage */
   if(s->drawable) XFreePixmap(subtle->dpy, s->drawable);
+  if(s->damage1)  XDestroyRegion(s->damage1);
+  if(s->damage2)  XDestroyRegion(s->damage2);
 
   free(s);
 
@@ -703,6 +879,8 @@ subScreenPublish(void)
 
   assert(subtle);
 
+  subtle->flags |= SUB_SUBTLE_DIRTY; ///< Update state mirror
+
   /* EWMH: Views per screen */
   views = (long *)subSharedMemoryAlloc(subtle->screens->ndata,
     sizeof(long));
@@ -229,10 +229,21 @@ subSubtleFinish(void)
       /* Handle hooks first */
       if(subtle->hooks)
         {
+          int i;
+
           /* Hook: Exit */
           subHookCall(SUB_HOOK_EXIT, NULL);
 
           /* Clear hooks first to stop calling */
+          for(i = 0; i < HOOKSLOTS; i++)
+            {
+              if(subtle->hookmap[i])
+                {
+                  subArrayKill(subtle->hookmap[i], False);
+                  subtle->hookmap[i] = NULL;
+                }
+            }
+
           subArrayClear(subtle->hooks, True);
         }
 
@@ -256,6 +267,7 @@ subSubtleFinish(void)
       subStyleReset(&subtle->styles.clients,   0);
       subStyleReset(&subtle->styles.subtle,    0);
 
+      subRpcFinish();
       subEventFinish();
       subRubyFinish();
       subEwmhFinish();
@@ -37,6 +37,10 @@
 #ifdef HAVE_X11_EXTENSIONS_XRANDR_H
 #include <X11/extensions/Xrandr.h>
 #endif /* HAVE_X11_EXTENSIONS_XRANDR_H */
+
+#ifdef HAVE_X11_EXTENSIONS_SYNC_H
+#include <X11/extensions/sync.h>
+#endif /* HAVE_X11_EXTENSIONS_SYNC_H */
 /* }}} */
 
 /* Macros {{{ */
@@ -50,8 +54,14 @@
 #define MINW         1L                                           ///< Client min width
 #define MINH         1L                                           ///< Client min height
 #define WAITTIME     10                                           ///< Max waiting time
+#define DRAGRATE     60                                           ///< Default drag refresh rate
+#define SYNCTIME     100                                          ///< Max sync request time (ms)
 #define HISTORYSIZE  5                                            ///< Size of the focus history
 #define DEFAULTTAG   (1L << 1)                                    ///< Default tag
+#define HOOKSLOTS    SUB_SLOT_TOTAL                               ///< Number of hook types
+#define MIRRORSIZE   (1L << 16)                                   ///< Initial size of state mirror
+#define RPCQUEUE     (1L << 18)                                   ///< Max queued RPC output
+#define GRAPHSIZE    32                                           ///< Default number of graph samples
 
 #define GRAVITYSTRLIMIT 1                                         ///< Gravity string limit to ignore \0
 
@@ -200,6 +210,7 @@
 #define SUB_CALL_OVER                 (1L << 16)                  ///< Call mouse over hook
 #define SUB_CALL_OUT                  (1L << 17)                  ///< Call mouse out hook
 #define SUB_CALL_UNLOAD               (1L << 18)                  ///< Call unload hook
+#define SUB_CALL_HOOK                 (1L << 19)                  ///< Call hook record
 
 /* Hook flags */
 #define SUB_HOOK_START                (1L << 10)                  ///< Start hook
@@ -341,6 +352,11 @@
 #define SUB_SUBTLE_FOCUS_CLICK        (1L << 13)                  ///< Click to focus
 #define SUB_SUBTLE_SKIP_WARP          (1L << 14)                  ///< Skip pointer warp
 #define SUB_SUBTLE_SKIP_URGENT_WARP   (1L << 15)                  ///< Skip urgent warp
+#define SUB_SUBTLE_XSYNC              (1L << 16)                  ///< Using XSync
+#define SUB_SUBTLE_OPAQUE             (1L << 17)                  ///< Opaque move/resize
+#define SUB_SUBTLE_SNAPSHOT           (1L << 18)                  ///< Config restored from snapshot
+#define SUB_SUBTLE_MUTE               (1L << 19)                  ///< Suppress hooks
+#define SUB_SUBTLE_DIRTY              (1L << 20)                  ///< State mirror outdated
 
 /* Tag flags */
 #define SUB_TAG_GRAVITY               (1L << 10)                  ///< Gravity property
@@ -365,6 +381,7 @@
 #define SUB_TEXT_EMPTY                (1L << 0)                   ///< Empty text
 #define SUB_TEXT_BITMAP               (1L << 1)                   ///< Text bitmap
 #define SUB_TEXT_PIXMAP               (1L << 2)                   ///< Text pixmap
+#define SUB_TEXT_GRAPH                (1L << 3)                   ///< Text graph
 
 /* View flags */
 #define SUB_VIEW_ICON                 (1L << 10)                  ///< View icon
@@ -449,6 +466,7 @@ typedef struct subclient_t /* {{{ */
 
   TAGS       tags;                                                ///< Client tags
   Window     win, leader;                                         ///< Client window and leader
+  XID        counter;                                             ///< Client sync request counter
   Colormap   cmap;                                                ///< Client colormap
   XRectangle geom;                                                ///< Client geom
 
@@ -488,6 +506,8 @@ typedef enum subewmh_t /* {{{ */
   SUB_EWMH_NET_SUPPORTING_WM_CHECK,                               ///< Check for compliant window manager
   SUB_EWMH_NET_WM_FULL_PLACEMENT,                                 ///< WM does all placement
   SUB_EWMH_NET_FRAME_EXTENTS,                                     ///< Extents of the client frame
+  SUB_EWMH_NET_WM_SYNC_REQUEST,                                   ///< Sync request protocol
+  SUB_EWMH_NET_WM_SYNC_REQUEST_COUNTER,                           ///< Sync request counter
 
   /* Client */
   SUB_EWMH_NET_CLOSE_WINDOW,                                      ///< Close window
@@ -579,6 +599,14 @@ typedef struct subgrab_t /* {{{ */
   struct subarray_t  *keys;                                    ///< Grab chain keys
 } SubGrab; /* }}} */
 
+typedef struct subgraph_t /* {{{ */
+{
+  int        size, head, count;                                   ///< Graph ring size, head and count
+  double     max, *samples;                                       ///< Graph scale and samples
+  long       color, bg;                                           ///< Graph colors of last render
+  XRectangle geom;                                                ///< Graph geometry of last render
+} SubGraph; /* }}} */
+
 typedef struct subgravity_t /* {{{ */
 {
   FLAGS      flags;                                               ///< Gravity flags
@@ -589,8 +617,10 @@ typedef struct subgravity_t /* {{{ */
 
 typedef struct subhook_t /* {{{ */
 {
-  FLAGS         flags;                                            ///< Hook flags
-  unsigned long proc;                                             ///< Hook proc
+  FLAGS             flags;                                        ///< Hook flags
+  int               arity;                                        ///< Hook call arity
+  unsigned long     proc, receiver, method;                       ///< Hook proc, method receiver and id
+  struct subtag_t   *filter;                                      ///< Hook client filter
 } SubHook; /* }}} */
 
 typedef struct subicon_t /* {{{ */
@@ -621,6 +651,7 @@ typedef struct subscreen_t /* {{{ */
   Pixmap            stipple;                                      ///< Screen stipple
   Drawable          drawable;                                     ///< Screen drawable
   Window            panel1, panel2;                               ///< Screen windows
+  Region            damage1, damage2;                             ///< Screen panel damage
   struct subarray_t *panels;                                      ///< Screen panels
 
   /* FIXME: Cache ruby object during config */
@@ -636,9 +667,11 @@ typedef struct subseparator_t /* {{{ */
 typedef struct subsublet_t { /* {{{ */
   FLAGS             flags;                                        ///< Sublet flags
   int               watch, width, styleid;                        ///< Sublet watch id, width and style id
-  char              *name;                                        ///< Sublet name
+  int               data_arity, down_arity;                       ///< Sublet data and mouse down arity
+  char              *name, *path;                                 ///< Sublet name and file path
   unsigned long     instance;                                     ///< Sublet ruby instance, fg, bg and icon color
   time_t            time, interval;                               ///< Sublet update/interval time
+  unsigned long     hash;                                         ///< Sublet file content hash
 
   struct subtext_t  *text;                                        ///< Sublet text
 } SubSublet; /* }}} */
@@ -666,6 +699,10 @@ typedef struct subsubtle_t /* {{{ */
 
   int                  loglevel, width, height;                   ///< Subtle loglevel and screen size
   int                  ph, step, snap;                            ///< Subtle properties
+  int                  gc_budget;                                 ///< Subtle ruby heap growth budget
+#ifdef HAVE_X11_EXTENSIONS_SYNC_H
+  int                  xsync;                                     ///< Subtle XSync event base
+#endif /* HAVE_X11_EXTENSIONS_SYNC_H */
   int                  visible_tags, visible_views;               ///< Subtle visible tags and views
   int                  client_tags, urgent_tags;                  ///< Subtle clients and urgent tags
   unsigned long        gravity;                                   ///< Subtle default gravity
@@ -678,6 +715,7 @@ typedef struct subsubtle_t /* {{{ */
   struct subarray_t    *grabs;                                    ///< Subtle grabs
   struct subarray_t    *gravities;                                ///< Subtle gravities
   struct subarray_t    *hooks;                                    ///< Subtle hooks
+  struct subarray_t    *hookmap[HOOKSLOTS];                       ///< Subtle hooks per type
   struct subarray_t    *screens;                                  ///< Subtle screens
   struct subarray_t    *sublets;                                  ///< Subtle sublets
   struct subarray_t    *tags;                                     ///< Subtle tags
@@ -685,7 +723,7 @@ typedef struct subsubtle_t /* {{{ */
   struct subarray_t    *views;                                    ///< Subtle views
 
 #ifdef HAVE_SYS_INOTIFY_H
-  int                  notify;                                    ///< Subtle inotify descriptor
+  int                  notify, watch;                             ///< Subtle inotify descriptor and sublets watch
 #endif /* HAVE_SYS_INOTIFY_H */
 
   struct
@@ -745,6 +783,7 @@ typedef struct subtext_t /* {{{ */
 {
   struct subtextitem_t **items;                                   ///< Item text items
   int                  flags, nitems, width;                      ///< Item flags, count, width
+  struct subgraph_t    *graph;                                    ///< Item graph
 } SubText; /* }}} */
 
 typedef struct subtray_t /* {{{ */
@@ -824,6 +863,7 @@ void subDisplayFinish(void);                                      ///< Kill disp
 /* event.c {{{ */
 void subEventWatchAdd(int fd);                                    ///< Add watch fd
 void subEventWatchDel(int fd);                                    ///< Del watch fd
+void subEventWatchWrite(int fd, int enable);                      ///< Toggle POLLOUT
 void subEventLoop(void);                                          ///< Event loop
 void subEventFinish(void);                                        ///< Finish events
 /* }}} */
@@ -871,6 +911,8 @@ void subGravityPublish(void);                                     ///< Publish g
 
 /* hook.c {{{ */
 SubHook *subHookNew(int type, unsigned long proc);                ///< Create hook
+void subHookAdd(SubHook *h);                                      ///< Add hook
+void subHookRemove(SubHook *h);                                   ///< Remove hook
 void subHookCall(int type, void *data);                           ///< Call hook
 void subHookKill(SubHook *h);                                     ///< Kill hook
 /* }}} */
@@ -879,6 +921,7 @@ void subHookKill(SubHook *h);                                     ///< Kill hook
 SubPanel *subPanelNew(int type);                                  ///< Create new panel
 void subPanelUpdate(SubPanel *p);                                 ///< Update panels
 void subPanelRender(SubPanel *p, Drawable drawable);              ///< Render panels
+void subPanelRenderGraph(SubSublet *sublet);                      ///< Render sublet graph only
 int subPanelCompare(const void *a, const void *b);                ///< Compare two panels
 void subPanelAction(SubArray *panels, int type, int x, int y,
   int button, int bottom);                                        ///< Handle panel action
@@ -894,13 +937,27 @@ void subRubyLoadConfig(void);                                     ///< Load conf
 void subRubyReloadConfig(void);                                   ///< Reload config file
 void subRubyLoadSublet(const char *file);                         ///< Load sublet
 void subRubyUnloadSublet(SubPanel *p);                            ///< Unload sublet
+void subRubyReloadSublet(const char *file);                       ///< Reload sublet
 void subRubyLoadSublets(void);                                    ///< Load sublets
 void subRubyLoadPanels(void);                                     ///< Load panels
 int subRubyCall(int type, unsigned long proc, void *data);        ///< Call Ruby script
+void subRubyBusy(int busy);                                       ///< Defer Ruby GC
+void subRubyIdle(void);                                           ///< Run deferred Ruby GC
 int subRubyRelease(unsigned long recv);                           ///< Release receiver
+void subRubyReleaseObject(void *data);                            ///< Release subtlext object
 void subRubyFinish(void);                                         ///< Kill Ruby stack
 /* }}} */
 
+/* rpc.c {{{ */
+void subRpcInit(void);                                            ///< Init RPC socket
+SubBackend *subRpcBackend(void);                                  ///< Get in-process backend
+int subRpcHandle(int fd);                                         ///< Handle RPC descriptor
+void subRpcFlush(void);                                           ///< Hand over queued messages
+void subRpcPublish(void);                                         ///< Publish state mirror
+void subRpcEvent(int slot, void *data);                           ///< Send event to subscribers
+void subRpcFinish(void);                                          ///< Kill RPC socket
+/* }}} */
+
 /* screen.c {{{ */
 void subScreenInit(void);                                         ///< Init screens
 SubScreen *subScreenNew(int x, int y, unsigned int width,
@@ -910,6 +967,8 @@ SubScreen * subScreenCurrent(int *sid);                           ///< Get curre
 void subScreenConfigure(void);                                    ///< Configure screens
 void subScreenUpdate(void);                                       ///< Update screens
 void subScreenRender(void);                                       ///< Render screens
+void subScreenRenderSublet(SubSublet *sublet);                    ///< Render sublet items
+void subScreenExpose(SubScreen *s, XExposeEvent *ev);             ///< Expose screen panel
 void subScreenResize(void);                                       ///< Update screen sizes
 void subScreenWarp(SubScreen *s);                                 ///< Warp pointer to screen
 void subScreenPublish(void);                                      ///< Publish screens
@@ -937,7 +996,11 @@ void subSubtleFinish(void);                                       ///< Finish su
 SubTag *subTagNew(char *name, int *duplicate);                    ///< Create tag
 void subTagMatcherAdd(SubTag *t, int type,
   char *pattern, int and);                                        ///< Add a matcher
+int subTagMatcherGet(SubTag *t, int idx, int *type,
+  char **pattern);                                                ///< Get a matcher
 int subTagMatcherCheck(SubTag *t, SubClient *c);                  ///< Check for match
+void subTagMatcherClear(SubTag *t);                               ///< Remove matchers
+int subTagEqual(SubTag *t1, SubTag *t2);                          ///< Compare tags
 void subTagPublish(void);                                         ///< Publish tags
 void subTagKill(SubTag *t);                                       ///< Delete tag
 /* }}} */
@@ -947,6 +1010,10 @@ SubText *subTextNew(void);                                         ///< Create t
 int subTextParse(SubText *t, SubFont *f, char *text);             ///< Parse string
 void subTextRender(SubText *t, SubFont *f, GC gc, Window win,
   int x, int y, long fg, long icon, long bg);                     ///< Render text
+void subTextGraph(SubText *t, int size, double max);              ///< Configure graph
+int subTextGraphPush(SubText *t, double value);                   ///< Append graph sample
+void subTextGraphRender(SubText *t, GC gc, Drawable drawable,
+  int x, int y);                                                  ///< Render graph only
 void subTextKill(SubText *t);                                     ///< Delete text
 /* }}} */
 
@@ -20,32 +20,12 @@ typedef struct tagmatcher_t
   FLAGS               flags;
   struct tagmatcher_t *and;
   regex_t             *regex;
+  char                *pattern;
 } TagMatcher;
 /* }}} */
 
 /* Private */
 
-/* TagClear {{{ */
-static void
-TagClear(SubTag *t)
-{
-  int i;
-
-  assert(t);
-
-  /* Clear matcher */
-  for(i = 0; t->matcher &&  i < t->matcher->ndata; i++)
-    {
-      TagMatcher *m = (TagMatcher *)t->matcher->data[i];
-
-      if(m->regex) subSharedRegexKill(m->regex);
-
-      free(m);
-    }
-
-  subArrayClear(t->matcher, False);
-} /* }}} */
-
 /* TagFind {{{ */
 static SubTag *
 TagFind(char *name)
@@ -162,8 +142,9 @@ subTagMatcherAdd(SubTag *t,
     {
       /* Create new matcher */
       m = MATCHER(subSharedMemoryAlloc(1, sizeof(TagMatcher)));
-      m->flags = type;
-      m->regex = regex;
+      m->flags   = type;
+      m->regex   = regex;
+      m->pattern = regex ? strdup(pattern) : NULL;
 
       /* Create on demand to safe memory */
       if(NULL == t->matcher) t->matcher = subArrayNew();
@@ -179,6 +160,35 @@ subTagMatcherAdd(SubTag *t,
     }
 } /* }}} */
 
+ /** subTagMatcherGet {{{
+  * @brief Get type and pattern of a matcher
+  * @param[in]   t        A #SubTag
+  * @param[in]   idx      Matcher index
+  * @param[out]  type     Matcher type
+  * @param[out]  pattern  Matcher pattern or \p NULL
+  * @retval  True   Matcher found
+  * @retval  False  Index out of range
+  **/
+
+int
+subTagMatcherGet(SubTag *t,
+  int idx,
+  int *type,
+  char **pattern)
+{
+  TagMatcher *m = NULL;
+
+  assert(t && type && pattern);
+
+  if(!t->matcher || !(m = MATCHER(subArrayGet(t->matcher, idx))))
+    return False;
+
+  *type    = m->flags;
+  *pattern = m->pattern;
+
+  return True;
+} /* }}} */
+
  /** subTagMatcherCheck {{{
   * @brief Check if client matches tag
   * @param[in]  t  A #SubTag
@@ -220,6 +230,80 @@ subTagMatcherCheck(SubTag *t,
   return False;
 } /* }}} */
 
+ /** subTagMatcherClear {{{
+  * @brief Remove all matchers of a tag
+  * @param[in]  t  A #SubTag
+  **/
+
+void
+subTagMatcherClear(SubTag *t)
+{
+  int i;
+
+  assert(t);
+
+  /* Clear matcher */
+  for(i = 0; t->matcher && i < t->matcher->ndata; i++)
+    {
+      TagMatcher *m = MATCHER(t->matcher->data[i]);
+
+      if(m->regex)   subSharedRegexKill(m->regex);
+      if(m->pattern) free(m->pattern);
+
+      free(m);
+    }
+
+  if(t->matcher)
+    {
+      subArrayKill(t->matcher, False);
+      t->matcher = NULL;
+    }
+} /* }}} */
+
+ /** subTagEqual {{{
+  * @brief Check if two tags have the same settings
+  * @param[in]  t1  A #SubTag
+  * @param[in]  t2  A #SubTag
+  * @retval  True  Tags are equal
+  * @retval  False Tags differ
+  **/
+
+int
+subTagEqual(SubTag *t1,
+  SubTag *t2)
+{
+  int i, n1, n2;
+
+  assert(t1 && t2);
+
+  /* Procs can't be compared */
+  if(t1->flags & SUB_TAG_PROC || t2->flags & SUB_TAG_PROC) return False;
+
+  /* Compare values */
+  if(t1->flags != t2->flags || t1->gravityid != t2->gravityid ||
+      t1->screenid != t2->screenid || strcmp(t1->name, t2->name) ||
+      memcmp(&t1->geom, &t2->geom, sizeof(XRectangle)))
+    return False;
+
+  /* Compare matcher */
+  n1 = t1->matcher ? t1->matcher->ndata : 0;
+  n2 = t2->matcher ? t2->matcher->ndata : 0;
+
+  if(n1 != n2) return False;
+
+  for(i = 0; i < n1; i++)
+    {
+      TagMatcher *m1 = MATCHER(t1->matcher->data[i]);
+      TagMatcher *m2 = MATCHER(t2->matcher->data[i]);
+
+      if(m1->flags != m2->flags || (m1->pattern && m2->pattern ?
+          strcmp(m1->pattern, m2->pattern) : m1->pattern != m2->pattern))
+        return False;
+    }
+
+  return True;
+} /* }}} */
+
  /** subTagKill {{{
   * @brief Delete tag
   * @param[in]  t  A #SubTag
@@ -233,13 +317,10 @@ subTagKill(SubTag *t)
   /* Hook: Kill */
   subHookCall((SUB_HOOK_TYPE_TAG|SUB_HOOK_ACTION_KILL),
     (void *)t);
+  subRubyReleaseObject((void *)t);
 
   /* Remove matcher */
-  if(t->matcher)
-    {
-      TagClear(t);
-      subArrayKill(t->matcher, False);
-    }
+  if(t->matcher) subTagMatcherClear(t);
 
   /* Remove proc */
   if(t->flags & SUB_TAG_PROC)
@@ -265,6 +346,8 @@ subTagPublish(void)
 
   assert(0 < subtle->tags->ndata);
 
+  subtle->flags |= SUB_SUBTLE_DIRTY; ///< Update state mirror
+
   names = (char **)subSharedMemoryAlloc(subtle->tags->ndata, sizeof(char *));
 
   for(i = 0; i < subtle->tags->ndata; i++)
@@ -35,9 +35,9 @@ subTextParse(SubText *t,
   SubFont *f,
   char *text)
 {
-  int i = 0, left = 0, right = 0;
-  char *tok = NULL;
-  long color = -1, pixmap = 0;
+  int i = 0, left = 0, right = 0, graph = False;
+  char *tok = NULL, *end = NULL;
+  long color = -1, pixmap = 0, width = 0;
   SubTextItem *item = NULL;
 
   assert(f && t);
@@ -53,11 +53,12 @@ subTextParse(SubText *t,
           /* Re-use items to save alloc cycles */
           if(i < t->nitems && (item = ITEM(t->items[i])))
             {
-              if(!(item->flags & (SUB_TEXT_BITMAP|SUB_TEXT_PIXMAP)) &&
-                  item->data.string)
+              if(!(item->flags & (SUB_TEXT_BITMAP|SUB_TEXT_PIXMAP|
+                  SUB_TEXT_GRAPH)) && item->data.string)
                 free(item->data.string);
 
-              item->flags &= ~(SUB_TEXT_EMPTY|SUB_TEXT_BITMAP|SUB_TEXT_PIXMAP);
+              item->flags &= ~(SUB_TEXT_EMPTY|SUB_TEXT_BITMAP|SUB_TEXT_PIXMAP|
+                SUB_TEXT_GRAPH);
             }
           else if((item = ITEM(subSharedMemoryAlloc(1, sizeof(SubTextItem)))))
             {
@@ -84,6 +85,22 @@ subTextParse(SubText *t,
               /* Add spacing and check if icon is first */
               t->width += item->width + (0 == i ? 3 : 6);
 
+              item->color = color;
+            }
+          else if('%' == *tok && 0 <= (width = strtol(tok + 1, &end, 10)) &&
+              '\0' == *end) ///< Graph with optional width
+            {
+              if(!t->graph) subTextGraph(t, GRAPHSIZE, 0);
+
+              item->flags    |= SUB_TEXT_GRAPH;
+              item->data.num  = 0;
+              graph           = True;
+              item->width     = 0 < width ? width : t->graph->size;
+              item->height    = f->height;
+
+              /* Add spacing and check if graph is first */
+              t->width += item->width + (0 == i ? 3 : 6);
+
               item->color = color;
             }
           else ///< Ordinary text
@@ -106,10 +123,13 @@ subTextParse(SubText *t,
   for(; i < t->nitems; i++)
     ITEM(t->items[i])->flags |= SUB_TEXT_EMPTY;
 
+  /* Stop partial updates of a graph that is gone */
+  if(t->graph && !graph) t->graph->geom.width = 0;
+
   /* Fix spacing of last item */
   if(item)
     {
-      if(item->flags & (SUB_TEXT_BITMAP|SUB_TEXT_PIXMAP))
+      if(item->flags & (SUB_TEXT_BITMAP|SUB_TEXT_PIXMAP|SUB_TEXT_GRAPH))
         t->width -= 2;
       else
         {
@@ -172,6 +192,23 @@ subTextRender(SubText *t,
           /* Add spacing when icon isn't last */
           width += item->width + dx + (i != t->nitems - 1 ? 3 : 0);
         }
+      else if(item->flags & SUB_TEXT_GRAPH) ///< Graph
+        {
+          int dx = (0 == i) ? 0 : 3; ///< Add spacing when graph isn't first
+
+          /* Cache geometry relative to text origin for partial updates */
+          t->graph->geom.x      = width + dx - x;
+          t->graph->geom.y      = y - f->y;
+          t->graph->geom.width  = item->width;
+          t->graph->geom.height = f->height;
+          t->graph->color       = (-1 == item->color) ? icon : item->color;
+          t->graph->bg          = bg;
+
+          subTextGraphRender(t, gc, win, x, 0);
+
+          /* Add spacing when graph isn't last */
+          width += item->width + dx + (i != t->nitems - 1 ? 3 : 0);
+        }
       else ///< Text
         {
           subSharedDrawString(subtle->dpy, gc, f, win, width, y,
@@ -183,6 +220,131 @@ subTextRender(SubText *t,
     }
 } /* }}} */
 
+ /** subTextGraph {{{
+  * @brief Configure graph of text
+  * @param[inout]  t     A #SubText
+  * @param[in]     size  Number of samples
+  * @param[in]     max   Fixed scale or 0 to scale to the peak
+  **/
+
+void
+subTextGraph(SubText *t,
+  int size,
+  double max)
+{
+  assert(t && 0 < size);
+
+  if(!t->graph) t->graph = (SubGraph *)subSharedMemoryAlloc(1,
+    sizeof(SubGraph));
+
+  /* Resize ring buffer and drop samples */
+  if(size != t->graph->size)
+    {
+      if(t->graph->samples) free(t->graph->samples);
+
+      t->graph->samples = (double *)subSharedMemoryAlloc(size,
+        sizeof(double));
+      t->graph->size    = size;
+      t->graph->head    = 0;
+      t->graph->count   = 0;
+    }
+
+  t->graph->max = max;
+} /* }}} */
+
+ /** subTextGraphPush {{{
+  * @brief Append sample to graph of text
+  * @param[inout]  t      A #SubText
+  * @param[in]     value  Sample value
+  * @retval  True   Graph was rendered before and can be updated
+  * @retval  False  Graph needs a full render
+  **/
+
+int
+subTextGraphPush(SubText *t,
+  double value)
+{
+  SubGraph *g = NULL;
+
+  assert(t);
+
+  if(!t->graph) subTextGraph(t, GRAPHSIZE, 0);
+
+  g = t->graph;
+
+  /* Overwrite oldest sample */
+  g->samples[g->head] = value;
+  g->head             = (g->head + 1) % g->size;
+
+  if(g->count < g->size) g->count++;
+
+  return 0 < g->geom.width;
+} /* }}} */
+
+ /** subTextGraphRender {{{
+  * @brief Render only the graph of text with cached geometry
+  * @param[in]  t         A #SubText
+  * @param[in]  gc        A #GC
+  * @param[in]  drawable  Drawable to draw on
+  * @param[in]  x         X position of text
+  * @param[in]  y         Y offset in drawable
+  **/
+
+void
+subTextGraphRender(SubText *t,
+  GC gc,
+  Drawable drawable,
+  int x,
+  int y)
+{
+  int i, w = 1, nbars = 0;
+  double max = 0;
+  SubGraph *g = NULL;
+  XRectangle *bars = NULL;
+
+  assert(t);
+
+  if(!(g = t->graph) || 0 == g->geom.width) return;
+
+  x += g->geom.x;
+  y += g->geom.y;
+
+  /* Clear graph area */
+  XSetForeground(subtle->dpy, gc, g->bg);
+  XFillRectangle(subtle->dpy, drawable, gc, x, y,
+    g->geom.width, g->geom.height);
+
+  /* Use fixed scale or scale to peak */
+  if(0 >= (max = g->max))
+    {
+      for(i = 0; i < g->count; i++)
+        max = MAX(max, g->samples[i]);
+    }
+
+  if(0 == g->count || 0 >= max) return;
+
+  /* Spread samples over width, newest one on the right */
+  w     = MAX(1, g->geom.width / g->size);
+  nbars = MIN(g->count, g->geom.width / w);
+  bars  = (XRectangle *)subSharedMemoryAlloc(nbars, sizeof(XRectangle));
+
+  for(i = 0; i < nbars; i++)
+    {
+      double h = g->samples[(g->head - 1 - i + g->size) % g->size] /
+        max * g->geom.height;
+
+      bars[i].width  = w;
+      bars[i].height = MINMAX(h, 0, g->geom.height);
+      bars[i].x      = x + g->geom.width - (i + 1) * w;
+      bars[i].y      = y + g->geom.height - bars[i].height;
+    }
+
+  XSetForeground(subtle->dpy, gc, g->color);
+  XFillRectangles(subtle->dpy, drawable, gc, bars, nbars);
+
+  free(bars);
+} /* }}} */
+
  /** subTextKill {{{
   * @brief Delete text
   * @param[in]  t  A #SubText
@@ -199,13 +361,19 @@ subTextKill(SubText *t)
     {
       SubTextItem *item = (SubTextItem *)t->items[i];
 
-      if(!(item->flags & (SUB_TEXT_BITMAP|SUB_TEXT_PIXMAP)) &&
+      if(!(item->flags & (SUB_TEXT_BITMAP|SUB_TEXT_PIXMAP|SUB_TEXT_GRAPH)) &&
           item->data.string)
         free(item->data.string);
 
       free(t->items[i]);
     }
 
+  if(t->graph)
+    {
+      free(t->graph->samples);
+      free(t->graph);
+    }
+
   free(t->items);
   free(t);
 } /* }}} */
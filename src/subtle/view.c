@@ -138,6 +138,7 @@ subViewKill(SubView *v)
   /* Hook: Kill */
   subHookCall((SUB_HOOK_TYPE_VIEW|SUB_HOOK_ACTION_KILL),
     (void *)v);
+  subRubyReleaseObject((void *)v);
 
   if(v->icon) free(v->icon);
   free(v->name);
@@ -159,6 +160,8 @@ subViewPublish(void)
   long vid = 0, *tags = NULL, *icons = NULL;
   char **names = NULL;
 
+  subtle->flags |= SUB_SUBTLE_DIRTY; ///< Update state mirror
+
   if(0 < subtle->views->ndata)
     {
       tags  = (long *)subSharedMemoryAlloc(subtle->views->ndata, sizeof(long));
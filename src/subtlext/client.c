@@ -11,6 +11,39 @@
 
 #include "subtlext.h"
 
+/* Typedef {{{ */
+typedef struct subtlextclient_t
+{
+  int loaded;
+} SubtlextClient;
+/* }}} */
+
+/* ClientMemsize {{{ */
+static size_t
+ClientMemsize(const void *data)
+{
+  return sizeof(SubtlextClient);
+} /* }}} */
+
+static const rb_data_type_t ClientType = {
+  "Subtlext::Client",
+  { NULL, RUBY_TYPED_DEFAULT_FREE, ClientMemsize, },
+#ifdef RUBY_TYPED_FREE_IMMEDIATELY
+  NULL, NULL, RUBY_TYPED_FREE_IMMEDIATELY
+#endif /* RUBY_TYPED_FREE_IMMEDIATELY */
+};
+
+/* ClientGet {{{ */
+static SubtlextClient *
+ClientGet(VALUE self)
+{
+  SubtlextClient *c = NULL;
+
+  TypedData_Get_Struct(self, SubtlextClient, &ClientType, c);
+
+  return c;
+} /* }}} */
+
 /* ClientRestack {{{ */
 VALUE
 ClientRestack(VALUE self,
@@ -45,10 +78,9 @@ ClientFlagsGet(VALUE self,
 
   /* Check ruby object */
   rb_check_frozen(self);
+  subClientLoad(self, SUB_CLIENT_FLAGS);
   GET_ATTR(self, "@flags", flags)
 
-  flags = rb_iv_get(self, "@flags");
-
   return (FIXNUM_P(flags) && FIX2INT(flags) & flag) ? Qtrue : Qfalse;
 } /* }}} */
 
@@ -71,6 +103,7 @@ ClientFlagsSet(VALUE self,
     {
       VALUE flags = Qnil;
 
+      subClientLoad(self, SUB_CLIENT_FLAGS);
       GET_ATTR(self, "@flags", flags);
 
       iflags = FIX2INT(flags);
@@ -102,6 +135,7 @@ ClientFlagsToggle(VALUE self,
 
   /* Check ruby object */
   rb_check_frozen(self);
+  subClientLoad(self, SUB_CLIENT_FLAGS);
   GET_ATTR(self, "@win",   win);
   GET_ATTR(self, "@flags", flags);
 
@@ -115,7 +149,7 @@ ClientFlagsToggle(VALUE self,
   rb_iv_set(self, "@flags", INT2FIX(iflags));
 
   /* Send message */
-  data.l[0] = XInternAtom(display, "_NET_WM_STATE_TOGGLE", False);
+  data.l[0] = subSubtlextAtom(SUB_ATOM_NET_WM_STATE_TOGGLE);
   data.l[1] = XInternAtom(display, type, False);
 
   subSharedMessage(display, NUM2LONG(win), "_NET_WM_STATE", data, 32, True);
@@ -189,7 +223,7 @@ ClientFind(VALUE value,
           return parsed;
     }
 
-  return subSubtlextFindWindows("_NET_CLIENT_LIST", "Client",
+  return subSubtlextFindWindows(SUB_ATOM_NET_CLIENT_LIST, "Client",
     buf, flags, first);
 } /* }}} */
 
@@ -316,13 +350,23 @@ subClientSingCurrent(VALUE self)
 {
   VALUE client = Qnil;
   unsigned long *focus = NULL;
+  SubBackend *b = NULL;
 
   subSubtlextConnect(NULL); ///< Implicit open connection
 
+  /* Ask subtle directly */
+  if((b = subSharedBackendGet(display)))
+    {
+      Window win = b->current();
+
+      if(None != win && RTEST(client = subClientInstantiate(win)))
+        return subClientUpdate(client);
+    }
+
   /* Get current client */
   if((focus = (unsigned long *)subSharedPropertyGet(display,
       DefaultRootWindow(display), XA_WINDOW,
-      XInternAtom(display, "_NET_ACTIVE_WINDOW", False), NULL)))
+      subSubtlextAtom(SUB_ATOM_NET_ACTIVE_WINDOW), NULL)))
     {
       /* Update client values */
       if(RTEST(client = subClientInstantiate(*focus)))
@@ -355,6 +399,8 @@ subClientSingVisible(VALUE self)
   Window *clients = NULL;
   unsigned long *visible = NULL;
   VALUE meth = Qnil, klass = Qnil, array = Qnil, client = Qnil;
+  SubBackend *b = NULL;
+  SubBackendClient *recs = NULL;
 
   subSubtlextConnect(NULL); ///< Implicit open connection
 
@@ -362,10 +408,31 @@ subClientSingVisible(VALUE self)
   meth    = rb_intern("new");
   array   = rb_ary_new();
   klass   = rb_const_get(mod, rb_intern("Client"));
-  clients = subSubtlextWindowList("_NET_CLIENT_LIST", &nclients);
   visible = (unsigned long *)subSharedPropertyGet(display,
-    DefaultRootWindow(display), XA_CARDINAL, XInternAtom(display,
-    "SUBTLE_VISIBLE_TAGS", False), NULL);
+    DefaultRootWindow(display), XA_CARDINAL,
+    subSubtlextAtom(SUB_ATOM_SUBTLE_VISIBLE_TAGS), NULL);
+
+  /* Get all clients with values in one go */
+  if(visible && (b = subSharedBackendGet(display)) &&
+      -1 != (nclients = b->list(&recs)))
+    {
+      for(i = 0; i < nclients; i++)
+        {
+          if(*visible & recs[i].tags &&
+              RTEST(client = rb_funcall(klass, meth, 1, LONG2NUM(recs[i].win))))
+            {
+              subClientRecord(client, &recs[i]);
+              rb_ary_push(array, client);
+            }
+        }
+
+      free(recs);
+      free(visible);
+
+      return array;
+    }
+
+  clients = subSubtlextWindowList(SUB_ATOM_NET_CLIENT_LIST, &nclients);
 
   /* Check results */
   if(clients && visible)
@@ -373,8 +440,8 @@ subClientSingVisible(VALUE self)
       for(i = 0; i < nclients; i++)
         {
           unsigned long *tags = (unsigned long *)subSharedPropertyGet(display,
-            clients[i], XA_CARDINAL, XInternAtom(display,
-            "SUBTLE_CLIENT_TAGS", False), NULL);
+            clients[i], XA_CARDINAL,
+            subSubtlextAtom(SUB_ATOM_SUBTLE_CLIENT_TAGS), NULL);
 
           /* Create client on match */
           if(tags && *tags && *visible & *tags &&
@@ -414,6 +481,8 @@ subClientSingList(VALUE self)
   int i, nclients = 0;
   Window *clients = NULL;
   VALUE meth = Qnil, klass = Qnil, array = Qnil, client = Qnil;
+  SubBackend *b = NULL;
+  SubBackendClient *recs = NULL;
 
   subSubtlextConnect(NULL); ///< Implicit open connection
 
@@ -421,7 +490,26 @@ subClientSingList(VALUE self)
   meth    = rb_intern("new");
   array   = rb_ary_new();
   klass   = rb_const_get(mod, rb_intern("Client"));
-  clients = subSubtlextWindowList("_NET_CLIENT_LIST", &nclients);
+
+  /* Get all clients with values in one go */
+  if((b = subSharedBackendGet(display)) &&
+      -1 != (nclients = b->list(&recs)))
+    {
+      for(i = 0; i < nclients; i++)
+        {
+          if(RTEST(client = rb_funcall(klass, meth, 1, LONG2NUM(recs[i].win))))
+            {
+              subClientRecord(client, &recs[i]);
+              rb_ary_push(array, client);
+            }
+        }
+
+      free(recs);
+
+      return array;
+    }
+
+  clients = subSubtlextWindowList(SUB_ATOM_NET_CLIENT_LIST, &nclients);
 
   /* Check results */
   if(clients)
@@ -465,7 +553,7 @@ subClientSingRecent(VALUE self)
   meth    = rb_intern("new");
   array   = rb_ary_new();
   klass   = rb_const_get(mod, rb_intern("Client"));
-  clients = subSubtlextWindowList("_NET_ACTIVE_WINDOW", &nclients);
+  clients = subSubtlextWindowList(SUB_ATOM_NET_ACTIVE_WINDOW, &nclients);
 
   /* Check results */
   if(clients)
@@ -501,8 +589,136 @@ subClientInstantiate(Window win)
   return client;
 } /* }}} */
 
+/* subClientRecord {{{ */
+void
+subClientRecord(VALUE self,
+  SubBackendClient *rec)
+{
+  rb_iv_set(self, "@tags",     INT2FIX(rec->tags));
+  rb_iv_set(self, "@flags",    INT2FIX(rec->flags));
+  rb_iv_set(self, "@name",     rb_str_new2(rec->name ? rec->name : ""));
+  rb_iv_set(self, "@instance", rb_str_new2(rec->instance ?
+    rec->instance : ""));
+  rb_iv_set(self, "@klass",    rb_str_new2(rec->klass ? rec->klass : ""));
+  rb_iv_set(self, "@role",     rec->role ? rb_str_new2(rec->role) : Qnil);
+  rb_iv_set(self, "@geometry", subGeometryInstantiate(rec->geom.x,
+    rec->geom.y, rec->geom.width, rec->geom.height));
+  rb_iv_set(self, "@gravity",  Qnil);
+
+  ClientGet(self)->loaded = SUB_CLIENT_ALL;
+} /* }}} */
+
+/* subClientLoaded {{{ */
+int
+subClientLoaded(VALUE self,
+  int groups)
+{
+  SubtlextClient *c = ClientGet(self);
+
+  return (c->loaded |= groups);
+} /* }}} */
+
+/* subClientLoad {{{ */
+void
+subClientLoad(VALUE self,
+  int groups)
+{
+  Window win = None;
+  SubtlextClient *c = ClientGet(self);
+
+  /* Skip objects without pending attributes */
+  if(0 == (groups &= ~c->loaded)) return;
+
+  subSubtlextConnect(NULL); ///< Implicit open connection
+
+  win = NUM2LONG(rb_iv_get(self, "@win"));
+
+  /* Fetch name, class is used as fallback */
+  if(groups & SUB_CLIENT_NAME)
+    {
+      char *wmname = NULL;
+
+      subSharedPropertyName(display, win, &wmname, "");
+
+      if('\0' == *wmname && !(c->loaded & SUB_CLIENT_CLASS))
+        groups |= SUB_CLIENT_CLASS;
+
+      rb_iv_set(self, "@name", rb_str_new2(wmname));
+
+      free(wmname);
+    }
+
+  /* Fetch instance and class in one go */
+  if(groups & SUB_CLIENT_CLASS)
+    {
+      char *wminstance = NULL, *wmclass = NULL;
+
+      subSharedPropertyClass(display, win, &wminstance, &wmclass);
+
+      rb_iv_set(self, "@instance", rb_str_new2(wminstance));
+      rb_iv_set(self, "@klass",    rb_str_new2(wmclass));
+
+      free(wminstance);
+      free(wmclass);
+    }
+
+  if(groups & SUB_CLIENT_NAME &&
+      0 == RSTRING_LEN(rb_iv_get(self, "@name")))
+    rb_iv_set(self, "@name", rb_iv_get(self, "@klass"));
+
+  /* Fetch tags and flags */
+  if(groups & (SUB_CLIENT_TAGS|SUB_CLIENT_FLAGS))
+    {
+      int i, *value = NULL;
+      SubAtom atoms[] = {
+        SUB_ATOM_SUBTLE_CLIENT_TAGS, SUB_ATOM_SUBTLE_CLIENT_FLAGS
+      };
+      const char *ivars[] = { "@tags", "@flags" };
+
+      for(i = 0; 2 > i; i++)
+        {
+          if(!(groups & (SUB_CLIENT_TAGS << i))) continue;
+
+          value = (int *)subSharedPropertyGet(display, win, XA_CARDINAL,
+            subSubtlextAtom(atoms[i]), NULL);
+
+          rb_iv_set(self, ivars[i], INT2FIX(value ? *value : 0));
+
+          if(value) free(value);
+        }
+    }
+
+  /* Fetch role */
+  if(groups & SUB_CLIENT_ROLE)
+    {
+      char *role = subSharedPropertyGet(display, win, XA_STRING,
+        subSubtlextAtom(SUB_ATOM_WM_WINDOW_ROLE), NULL);
+
+      rb_iv_set(self, "@role", role ? rb_str_new2(role) : Qnil);
+
+      if(role) free(role);
+    }
+
+  c->loaded |= groups;
+} /* }}} */
+
 /* Class */
 
+/* subClientAlloc {{{ */
+/*
+ * call-seq: new(win) -> Subtlext::Client
+ *
+ * Allocate space for a new Client object.
+ */
+
+VALUE
+subClientAlloc(VALUE self)
+{
+  SubtlextClient *c = NULL;
+
+  return TypedData_Make_Struct(self, SubtlextClient, &ClientType, c);
+} /* }}} */
+
 /* subClientInit {{{ */
 /*
  * call-seq: new(win) -> Subtlext::Client
@@ -535,16 +751,55 @@ subClientInit(VALUE self,
   rb_iv_set(self, "@flags",    Qnil);
   rb_iv_set(self, "@tags",     Qnil);
 
+  ClientGet(self)->loaded = 0;
+
   subSubtlextConnect(NULL); ///< Implicit open connection
 
   return self;
 } /* }}} */
 
+/* subClientInitCopy {{{ */
+/*
+ * call-seq: initialize_copy(client) -> Subtlext::Client
+ *
+ * Copy loaded attributes from given Client object on dup and clone.
+ */
+
+VALUE
+subClientInitCopy(VALUE self,
+  VALUE other)
+{
+  rb_check_frozen(self);
+
+  if(self != other)
+    *ClientGet(self) = *ClientGet(other);
+
+  return self;
+} /* }}} */
+
+/* subClientLoadedWriter {{{ */
+/*
+ * call-seq: loaded=(groups) -> Fixnum
+ *
+ * Mark attribute groups as loaded, used by subtle for its own
+ * Client objects.
+ */
+
+VALUE
+subClientLoadedWriter(VALUE self,
+  VALUE value)
+{
+  ClientGet(self)->loaded = FIX2INT(value);
+
+  return value;
+} /* }}} */
+
 /* subClientUpdate {{{ */
 /*
  * call-seq: update -> Subtlext::Client
  *
  * Update Client properties based on <b>required</b> Client window id.
+ * Without a subtle backend the properties are read on first access.
  *
  *  client.update
  *  => nil
@@ -561,45 +816,115 @@ subClientUpdate(VALUE self)
   /* Check values */
   if(0 <= (win = NUM2LONG(rb_iv_get(self, "@win"))))
     {
-      int *tags = NULL, *flags = NULL;
-      char *wmname = NULL, *wminstance = NULL, *wmclass = NULL, *role = NULL;
-
-      /* Fetch name, instance and class */
-      subSharedPropertyClass(display, win, &wminstance, &wmclass);
-      subSharedPropertyName(display, win, &wmname, wmclass);
-
-      /* Fetch tags, flags and role */
-      tags  = (int *)subSharedPropertyGet(display, win, XA_CARDINAL,
-        XInternAtom(display, "SUBTLE_CLIENT_TAGS", False), NULL);
-      flags = (int *)subSharedPropertyGet(display, win, XA_CARDINAL,
-        XInternAtom(display, "SUBTLE_CLIENT_FLAGS", False), NULL);
-      role  = subSharedPropertyGet(display, win, XA_STRING,
-        XInternAtom(display, "WM_WINDOW_ROLE", False), NULL);
-
-      /* Set properties */
-      rb_iv_set(self, "@tags",     tags  ? INT2FIX(*tags)  : INT2FIX(0));
-      rb_iv_set(self, "@flags",    flags ? INT2FIX(*flags) : INT2FIX(0));
-      rb_iv_set(self, "@name",     rb_str_new2(wmname));
-      rb_iv_set(self, "@instance", rb_str_new2(wminstance));
-      rb_iv_set(self, "@klass",    rb_str_new2(wmclass));
-      rb_iv_set(self, "@role",     role ? rb_str_new2(role) : Qnil);
-
-      /* Set to nil for on demand loading */
-      rb_iv_set(self, "@geometry", Qnil);
-      rb_iv_set(self, "@gravity",  Qnil);
+      SubBackend *b = NULL;
+      SubBackendClient rec = { 0 };
 
-      if(tags)  free(tags);
-      if(flags) free(flags);
-      if(role)  free(role);
-      free(wmname);
-      free(wminstance);
-      free(wmclass);
+      /* Read values directly from subtle */
+      if((b = subSharedBackendGet(display)) && b->client(win, &rec))
+        subClientRecord(self, &rec);
+      else
+        {
+          /* Reset values for on demand loading */
+          ClientGet(self)->loaded = 0;
+          rb_iv_set(self, "@geometry", Qnil);
+          rb_iv_set(self, "@gravity",  Qnil);
+        }
     }
   else rb_raise(rb_eStandardError, "Invalid client id `%#lx'", win);
 
   return self;
 } /* }}} */
 
+/* subClientNameReader {{{ */
+/*
+ * call-seq: name -> String
+ *
+ * Get WM_NAME of this Client, loaded on first access.
+ *
+ *  client.name
+ *  => "subtle"
+ */
+
+VALUE
+subClientNameReader(VALUE self)
+{
+  subClientLoad(self, SUB_CLIENT_NAME);
+
+  return rb_iv_get(self, "@name");
+} /* }}} */
+
+/* subClientInstanceReader {{{ */
+/*
+ * call-seq: instance -> String
+ *
+ * Get instance of WM_CLASS of this Client, loaded on first access.
+ *
+ *  client.instance
+ *  => "subtle"
+ */
+
+VALUE
+subClientInstanceReader(VALUE self)
+{
+  subClientLoad(self, SUB_CLIENT_CLASS);
+
+  return rb_iv_get(self, "@instance");
+} /* }}} */
+
+/* subClientKlassReader {{{ */
+/*
+ * call-seq: klass -> String
+ *
+ * Get class of WM_CLASS of this Client, loaded on first access.
+ *
+ *  client.klass
+ *  => "Subtle"
+ */
+
+VALUE
+subClientKlassReader(VALUE self)
+{
+  subClientLoad(self, SUB_CLIENT_CLASS);
+
+  return rb_iv_get(self, "@klass");
+} /* }}} */
+
+/* subClientRoleReader {{{ */
+/*
+ * call-seq: role -> String or nil
+ *
+ * Get WM_WINDOW_ROLE of this Client, loaded on first access.
+ *
+ *  client.role
+ *  => nil
+ */
+
+VALUE
+subClientRoleReader(VALUE self)
+{
+  subClientLoad(self, SUB_CLIENT_ROLE);
+
+  return rb_iv_get(self, "@role");
+} /* }}} */
+
+/* subClientFlagsReader {{{ */
+/*
+ * call-seq: flags -> Fixnum
+ *
+ * Get bitfield of window states of this Client, loaded on first access.
+ *
+ *  client.flags
+ *  => 0
+ */
+
+VALUE
+subClientFlagsReader(VALUE self)
+{
+  subClientLoad(self, SUB_CLIENT_FLAGS);
+
+  return rb_iv_get(self, "@flags");
+} /* }}} */
+
 /* subClientViewList {{{ */
 /*
  * call-seq: views -> Array
@@ -632,14 +957,14 @@ subClientViewList(VALUE self)
   klass   = rb_const_get(mod, rb_intern("View"));
   array   = rb_ary_new();
   names   = subSharedPropertyGetStrings(display, DefaultRootWindow(display),
-    XInternAtom(display, "_NET_DESKTOP_NAMES", False), &nnames);
+    subSubtlextAtom(SUB_ATOM_NET_DESKTOP_NAMES), &nnames);
   view_tags   = (unsigned long *)subSharedPropertyGet(display,
-    DefaultRootWindow(display), XA_CARDINAL, XInternAtom(display,
-    "SUBTLE_VIEW_TAGS", False), NULL);
+    DefaultRootWindow(display), XA_CARDINAL,
+    subSubtlextAtom(SUB_ATOM_SUBTLE_VIEW_TAGS), NULL);
   client_tags = (unsigned long *)subSharedPropertyGet(display, NUM2LONG(win),
-    XA_CARDINAL, XInternAtom(display, "SUBTLE_CLIENT_TAGS", False), NULL);
+    XA_CARDINAL, subSubtlextAtom(SUB_ATOM_SUBTLE_CLIENT_TAGS), NULL);
   flags       = (unsigned long *)subSharedPropertyGet(display, NUM2LONG(win),
-    XA_CARDINAL, XInternAtom(display, "SUBTLE_CLIENT_FLAGS", False), NULL);
+    XA_CARDINAL, subSubtlextAtom(SUB_ATOM_SUBTLE_CLIENT_FLAGS), NULL);
 
   /* Check results */
   if(names && view_tags && client_tags)
@@ -964,6 +1289,9 @@ subClientFlagsToggleBorderless(VALUE self)
  * [:fixed]      Set fixed mode
  * [:borderless] Set borderless mode
  *
+ * Inside of subtle the change is applied after the running hook or sublet
+ * callback returned.
+ *
  *  client.flags = [ :float, :stick ]
  *  => nil
  */
@@ -1091,7 +1419,7 @@ subClientGravityReader(VALUE self)
 
       /* Get gravity */
       if((id = (int *)subSharedPropertyGet(display, NUM2LONG(win), XA_CARDINAL,
-          XInternAtom(display, "SUBTLE_CLIENT_GRAVITY", False), NULL)))
+          subSubtlextAtom(SUB_ATOM_SUBTLE_CLIENT_GRAVITY), NULL)))
         {
           /* Create gravity */
           snprintf(buf, sizeof(buf), "%d", *id);
@@ -1117,6 +1445,9 @@ subClientGravityReader(VALUE self)
  *
  * Set Client Gravity either for current or for specific View.
  *
+ * Inside of subtle the change is applied after the running hook or sublet
+ * callback returned.
+ *
  *  # Set gravity for current view
  *  client.gravity = 0
  *  => #<Subtlext::Gravity:xxx>
@@ -1190,8 +1521,13 @@ subClientGeometryReader(VALUE self)
   if(NIL_P((geom = rb_iv_get(self, "@geometry"))))
     {
       XRectangle geometry = { 0 };
+      SubBackend *b = NULL;
+      SubBackendClient rec = { 0 };
 
-      subSharedPropertyGeometry(display, NUM2LONG(win), &geometry);
+      /* Read geometry directly from subtle */
+      if((b = subSharedBackendGet(display)) && b->client(NUM2LONG(win), &rec))
+        geometry = rec.geom;
+      else subSharedPropertyGeometry(display, NUM2LONG(win), &geometry);
 
       geom = subGeometryInstantiate(geometry.x, geometry.y,
         geometry.width, geometry.height);
@@ -1212,6 +1548,9 @@ subClientGeometryReader(VALUE self)
  *
  * Set Client geometry.
  *
+ * Inside of subtle the change is applied after the running hook or sublet
+ * callback returned.
+ *
  *  client.geometry = 0, 0, 100, 100
  *  => 0
  *
@@ -1247,14 +1586,17 @@ subClientGeometryWriter(int argc,
   if(RTEST(geom))
     {
       VALUE win = Qnil;
+      XRectangle r = { 0 };
       SubMessageData data = { { 0, 0, 0, 0, 0 } };
 
       GET_ATTR(self, "@win", win);
 
-      data.l[1] = FIX2INT(rb_iv_get(geom,  "@x"));
-      data.l[2] = FIX2INT(rb_iv_get(geom,  "@y"));
-      data.l[3] = FIX2INT(rb_iv_get(geom,  "@width"));
-      data.l[4] = FIX2INT(rb_iv_get(geom,  "@height"));
+      subGeometryToRect(geom, &r);
+
+      data.l[1] = r.x;
+      data.l[2] = r.y;
+      data.l[3] = r.width;
+      data.l[4] = r.height;
 
       subSharedMessage(display, NUM2LONG(win),
         "_NET_MOVERESIZE_WINDOW", data, 32, True);
@@ -1287,7 +1629,7 @@ subClientScreenReader(VALUE self)
 
   /* Get screen */
   if((id = (int *)subSharedPropertyGet(display, NUM2LONG(win), XA_CARDINAL,
-      XInternAtom(display, "SUBTLE_CLIENT_SCREEN", False), NULL)))
+      subSubtlextAtom(SUB_ATOM_SUBTLE_CLIENT_SCREEN), NULL)))
     {
       screen = subScreenSingFind(self, INT2FIX(*id));
 
@@ -1313,6 +1655,7 @@ subClientToString(VALUE self)
   VALUE name = Qnil;
 
   /* Check ruby object */
+  subClientLoad(self, SUB_CLIENT_NAME);
   GET_ATTR(self, "@name", name);
 
   return name;
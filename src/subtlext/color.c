@@ -12,6 +12,43 @@
 #include "subtlext.h"
 
 #define SCALE(i,div,mul) (unsigned long)(0 < i ? ((float)i / div) * mul : 0)
+#define INSTANCES 256                                             ///< Max shared color instances
+
+/* Typedef {{{ */
+typedef struct subtlextcolor_t
+{
+  unsigned short red, green, blue;
+  unsigned long  pixel;
+} SubtlextColor;
+/* }}} */
+
+static VALUE instances = Qnil;
+
+/* ColorMemsize {{{ */
+static size_t
+ColorMemsize(const void *data)
+{
+  return sizeof(SubtlextColor);
+} /* }}} */
+
+static const rb_data_type_t ColorType = {
+  "Subtlext::Color",
+  { NULL, RUBY_TYPED_DEFAULT_FREE, ColorMemsize, },
+#ifdef RUBY_TYPED_FREE_IMMEDIATELY
+  NULL, NULL, RUBY_TYPED_FREE_IMMEDIATELY
+#endif /* RUBY_TYPED_FREE_IMMEDIATELY */
+};
+
+/* ColorGet {{{ */
+static SubtlextColor *
+ColorGet(VALUE self)
+{
+  SubtlextColor *c = NULL;
+
+  TypedData_Get_Struct(self, SubtlextColor, &ColorType, c);
+
+  return c;
+} /* }}} */
 
 /* ColorEqual {{{ */
 VALUE
@@ -20,18 +57,15 @@ ColorEqual(VALUE self,
   int check_type)
 {
   int ret = False;
-  VALUE pixel1 = Qnil, pixel2 = Qnil;
 
   /* Check ruby object */
-  GET_ATTR(self,  "@pixel", pixel1);
-  GET_ATTR(other, "@pixel", pixel2);
+  if(!rb_typeddata_is_kind_of(other, &ColorType)) return Qfalse;
+
+  ret = (ColorGet(self)->pixel == ColorGet(other)->pixel);
 
   /* Check ruby object types */
   if(check_type)
-    {
-      ret = (rb_obj_class(self) == rb_obj_class(other) && pixel1 == pixel2);
-    }
-  else ret = (pixel1 == pixel2);
+    ret = (ret && rb_obj_class(self) == rb_obj_class(other));
 
   return ret ? Qtrue : Qfalse;
 } /* }}} */
@@ -40,8 +74,7 @@ ColorEqual(VALUE self,
 static void
 ColorPixelToRGB(XColor *xcolor)
 {
-  XQueryColor(display, DefaultColormap(display,
-    DefaultScreen(display)), xcolor);
+  subSharedColorQuery(display, xcolor);
 
   /* Scale 65535 to 255 */
   xcolor->red   = SCALE(xcolor->red,   65535, 255);
@@ -58,8 +91,7 @@ ColorRGBToPixel(XColor *xcolor)
   xcolor->green = SCALE(xcolor->green, 255, 65535);
   xcolor->blue  = SCALE(xcolor->blue,  255, 65535);
 
-  XAllocColor(display, DefaultColormap(display,
-      DefaultScreen(display)), xcolor);
+  subSharedColorAlloc(display, xcolor);
 
   /* Scale 65535 to 255 */
   xcolor->red   = SCALE(xcolor->red,   65535, 255);
@@ -122,18 +154,16 @@ subColorPixel(VALUE red,
             ColorRGBToPixel(&xcol);
           }
         break;
-      case T_OBJECT:
+      case T_DATA:
+        /* Check object instance */
+        if(rb_typeddata_is_kind_of(red, &ColorType))
           {
-            VALUE klass = rb_const_get(mod, rb_intern("Color"));
-
-            /* Check object instance */
-            if(rb_obj_is_instance_of(red, klass))
-              {
-                xcol.red   = NUM2INT(rb_iv_get(red, "@red"));
-                xcol.green = NUM2INT(rb_iv_get(red, "@green"));
-                xcol.blue  = NUM2INT(rb_iv_get(red, "@blue"));
-                xcol.pixel = NUM2LONG(rb_iv_get(red, "@pixel"));
-              }
+            SubtlextColor *c = ColorGet(red);
+
+            xcol.red   = c->red;
+            xcol.green = c->green;
+            xcol.blue  = c->blue;
+            xcol.pixel = c->pixel;
           }
         break;
       default:
@@ -159,15 +189,46 @@ subColorInstantiate(unsigned long pixel)
 {
   VALUE klass = Qnil, color = Qnil;
 
-  /* Create new instance */
-  klass  = rb_const_get(mod, rb_intern("Color"));
-  color = rb_funcall(klass, rb_intern("new"), 1, LONG2NUM(pixel));
+  /* Share frozen instances per pixel */
+  if(NIL_P(instances))
+    {
+      instances = rb_hash_new();
+
+      rb_gc_register_address(&instances);
+    }
+
+  if(NIL_P(color = rb_hash_lookup(instances, LONG2NUM(pixel))))
+    {
+      /* Start over instead of growing forever */
+      if(INSTANCES <= RHASH_SIZE(instances)) instances = rb_hash_new();
+
+      /* Create new instance */
+      klass = rb_const_get(mod, rb_intern("Color"));
+      color = rb_funcall(klass, rb_intern("new"), 1, LONG2NUM(pixel));
+
+      rb_hash_aset(instances, LONG2NUM(pixel), color);
+    }
 
   return color;
 } /* }}} */
 
 /* Class */
 
+/* subColorAlloc {{{ */
+/*
+ * call-seq: new(red, green, blue) -> Subtlext::Color
+ *
+ * Allocate space for a new Color object.
+ */
+
+VALUE
+subColorAlloc(VALUE self)
+{
+  SubtlextColor *c = NULL;
+
+  return TypedData_Make_Struct(self, SubtlextColor, &ColorType, c);
+} /* }}} */
+
 /* subColorInit {{{ */
 /*
  * call-seq: new(red, green, blue) -> Subtlext::Color
@@ -177,7 +238,7 @@ subColorInstantiate(unsigned long pixel)
  *           new(fixnum)           -> Subtlext::Color
  *           new(color)            -> Subtlext::Color
  *
- * Create new Color object from given <i>value</i> which can be of
+ * Create new frozen Color object from given <i>value</i> which can be of
  * following types:
  *
  * [String] Any color representation of Xlib is allowed
@@ -217,7 +278,9 @@ subColorInit(int argc,
 {
   VALUE data[3] = { Qnil };
   XColor xcolor = { 0 };
+  SubtlextColor *c = ColorGet(self);
 
+  rb_check_frozen(self);
   rb_scan_args(argc, argv, "12", &data[0], &data[1], &data[2]);
 
   subSubtlextConnect(NULL); ///< Implicit open connection
@@ -226,14 +289,125 @@ subColorInit(int argc,
   subColorPixel(data[0], data[1], data[2], &xcolor);
 
   /* Set values */
-  rb_iv_set(self, "@red",   INT2FIX(xcolor.red));
-  rb_iv_set(self, "@green", INT2FIX(xcolor.green));
-  rb_iv_set(self, "@blue",  INT2FIX(xcolor.blue));
-  rb_iv_set(self, "@pixel", LONG2NUM(xcolor.pixel));
+  c->red   = xcolor.red;
+  c->green = xcolor.green;
+  c->blue  = xcolor.blue;
+  c->pixel = xcolor.pixel;
+
+  rb_obj_freeze(self); ///< Colors are values
+
+  return self;
+} /* }}} */
+
+/* subColorInitCopy {{{ */
+/*
+ * call-seq: initialize_copy(color) -> Subtlext::Color
+ *
+ * Copy values from given Color object on dup and clone.
+ */
+
+VALUE
+subColorInitCopy(VALUE self,
+  VALUE other)
+{
+  rb_check_frozen(self);
+
+  if(self != other)
+    *ColorGet(self) = *ColorGet(other);
 
   return self;
 } /* }}} */
 
+/* subColorRedReader {{{ */
+/*
+ * call-seq: red -> Fixnum
+ *
+ * Get red fraction of this Color object.
+ *
+ *  color.red
+ *  => 51
+ */
+
+VALUE
+subColorRedReader(VALUE self)
+{
+  return INT2FIX(ColorGet(self)->red);
+} /* }}} */
+
+/* subColorGreenReader {{{ */
+/*
+ * call-seq: green -> Fixnum
+ *
+ * Get green fraction of this Color object.
+ *
+ *  color.green
+ *  => 102
+ */
+
+VALUE
+subColorGreenReader(VALUE self)
+{
+  return INT2FIX(ColorGet(self)->green);
+} /* }}} */
+
+/* subColorBlueReader {{{ */
+/*
+ * call-seq: blue -> Fixnum
+ *
+ * Get blue fraction of this Color object.
+ *
+ *  color.blue
+ *  => 253
+ */
+
+VALUE
+subColorBlueReader(VALUE self)
+{
+  return INT2FIX(ColorGet(self)->blue);
+} /* }}} */
+
+/* subColorPixelReader {{{ */
+/*
+ * call-seq: pixel -> Fixnum
+ *
+ * Get pixel number of this Color object.
+ *
+ *  color.pixel
+ *  => 14253553
+ */
+
+VALUE
+subColorPixelReader(VALUE self)
+{
+  return LONG2NUM(ColorGet(self)->pixel);
+} /* }}} */
+
+/* subColorSpaceship {{{ */
+/*
+ * call-seq: <=>(other) -> -1, 0 or 1
+ *
+ * Whether both objects have the same value. Returns -1, 0 or 1 when self is
+ * less than, equal to or grater than other. (based on pixel)
+ *
+ *  object1 <=> object2
+ *  => 0
+ */
+
+VALUE
+subColorSpaceship(VALUE self,
+  VALUE other)
+{
+  unsigned long pixel1 = 0, pixel2 = 0;
+
+  /* Check ruby object */
+  if(!rb_typeddata_is_kind_of(other, &ColorType)) return Qnil;
+
+  pixel1 = ColorGet(self)->pixel;
+  pixel2 = ColorGet(other)->pixel;
+
+  return INT2FIX(pixel1 < pixel2 ? -1 : (pixel1 == pixel2 ? 0 : 1));
+} /* }}} */
+
 /* subColorToHex {{{ */
 /*
  * call-seq: to_hex -> String
@@ -248,15 +422,9 @@ VALUE
 subColorToHex(VALUE self)
 {
   char buf[8] = { 0 };
-  VALUE red = Qnil, green = Qnil, blue = Qnil;
-
-  /* Check ruby object */
-  GET_ATTR(self, "@red",   red);
-  GET_ATTR(self, "@green", green);
-  GET_ATTR(self, "@blue",  blue);
+  SubtlextColor *c = ColorGet(self);
 
-  snprintf(buf, sizeof(buf), "#%02X%02X%02X",
-    (int)FIX2INT(red), (int)FIX2INT(green), (int)FIX2INT(blue));
+  snprintf(buf, sizeof(buf), "#%02X%02X%02X", c->red, c->green, c->blue);
 
   return rb_str_new2(buf);
 } /* }}} */
@@ -275,20 +443,16 @@ subColorToHex(VALUE self)
 VALUE
 subColorToArray(VALUE self)
 {
-  VALUE ary = Qnil, red = Qnil, green = Qnil, blue = Qnil;
-
-  /* Check ruby object */
-  GET_ATTR(self, "@red",   red);
-  GET_ATTR(self, "@green", green);
-  GET_ATTR(self, "@blue",  blue);
+  VALUE ary = Qnil;
+  SubtlextColor *c = ColorGet(self);
 
   /* Create new array */
   ary = rb_ary_new2(3);
 
   /* Set values */
-  rb_ary_push(ary, red);
-  rb_ary_push(ary, green);
-  rb_ary_push(ary, blue);
+  rb_ary_push(ary, INT2FIX(c->red));
+  rb_ary_push(ary, INT2FIX(c->green));
+  rb_ary_push(ary, INT2FIX(c->blue));
 
   return ary;
 } /* }}} */
@@ -307,21 +471,17 @@ subColorToArray(VALUE self)
 VALUE
 subColorToHash(VALUE self)
 {
-  VALUE klass = Qnil, hash = Qnil, red = Qnil, green = Qnil, blue = Qnil;
-
-  /* Check ruby object */
-  GET_ATTR(self, "@red",   red);
-  GET_ATTR(self, "@green", green);
-  GET_ATTR(self, "@blue",  blue);
+  VALUE klass = Qnil, hash = Qnil;
+  SubtlextColor *c = ColorGet(self);
 
   /* Create new hash */
   klass = rb_const_get(rb_mKernel, rb_intern("Hash"));
   hash  = rb_funcall(klass, rb_intern("new"), 0, NULL);
 
   /* Set values */
-  rb_hash_aset(hash, CHAR2SYM("red"),   red);
-  rb_hash_aset(hash, CHAR2SYM("green"), green);
-  rb_hash_aset(hash, CHAR2SYM("blue"),  blue);
+  rb_hash_aset(hash, CHAR2SYM("red"),   INT2FIX(c->red));
+  rb_hash_aset(hash, CHAR2SYM("green"), INT2FIX(c->green));
+  rb_hash_aset(hash, CHAR2SYM("blue"),  INT2FIX(c->blue));
 
   return hash;
 } /* }}} */
@@ -340,13 +500,9 @@ VALUE
 subColorToString(VALUE self)
 {
   char buf[20] = { 0 };
-  VALUE pixel = Qnil;
-
-  /* Check ruby object */
-  GET_ATTR(self, "@pixel", pixel);
 
   snprintf(buf, sizeof(buf), "%s#%ld%s",
-    SEPARATOR, NUM2LONG(pixel), SEPARATOR);
+    SEPARATOR, (long)ColorGet(self)->pixel, SEPARATOR);
 
   return rb_str_new2(buf);
 } /* }}} */
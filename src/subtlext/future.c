@@ -0,0 +1,321 @@
+ /**
+  * @package subtlext
+  *
+  * @file Future functions
+  * @copyright (c) 2005-2012 Christoph Kappel <unexist@subforge.org>
+  * @version $Id$
+  *
+  * This program can be distributed under the terms of the GNU GPLv2.
+  * See the file COPYING for details.
+  **/
+
+#include "subtlext.h"
+
+/* Flags {{{ */
+#define FUTURE_PENDING 0
+#define FUTURE_DONE    1
+#define FUTURE_FAILED  2
+/* }}} */
+
+/* Typedef {{{ */
+typedef struct subtlextfuture_t
+{
+  int   state;
+  ID    meth;
+  VALUE receiver, value;
+} SubtlextFuture;
+/* }}} */
+
+/* FutureMark {{{ */
+static void
+FutureMark(void *data)
+{
+  SubtlextFuture *f = (SubtlextFuture *)data;
+
+  if(f)
+    {
+      rb_gc_mark(f->receiver);
+      rb_gc_mark(f->value);
+    }
+} /* }}} */
+
+/* FutureMemsize {{{ */
+static size_t
+FutureMemsize(const void *data)
+{
+  return sizeof(SubtlextFuture);
+} /* }}} */
+
+static const rb_data_type_t FutureType = {
+  "Subtlext::Future",
+  { FutureMark, RUBY_TYPED_DEFAULT_FREE, FutureMemsize, },
+#ifdef RUBY_TYPED_FREE_IMMEDIATELY
+  NULL, NULL, RUBY_TYPED_FREE_IMMEDIATELY
+#endif /* RUBY_TYPED_FREE_IMMEDIATELY */
+};
+
+/* FutureGet {{{ */
+static SubtlextFuture *
+FutureGet(VALUE self)
+{
+  SubtlextFuture *f = NULL;
+
+  TypedData_Get_Struct(self, SubtlextFuture, &FutureType, f);
+
+  return f;
+} /* }}} */
+
+/* FutureCall {{{ */
+static VALUE
+FutureCall(VALUE data)
+{
+  SubtlextFuture *f = (SubtlextFuture *)data;
+
+  return rb_funcall(f->receiver, f->meth, 0, NULL);
+} /* }}} */
+
+/* FutureResolve {{{ */
+static void
+FutureResolve(SubtlextFuture *f)
+{
+  int state = 0;
+  VALUE value = rb_protect(FutureCall, (VALUE)f, &state);
+
+  /* Keep error for #value */
+  if(state)
+    {
+      f->value = rb_errinfo();
+      f->state = FUTURE_FAILED;
+
+      rb_set_errinfo(Qnil);
+    }
+  else
+    {
+      f->value = value;
+      f->state = FUTURE_DONE;
+    }
+} /* }}} */
+
+/* FuturePrefetch {{{ */
+static void
+FuturePrefetch(VALUE futures)
+{
+  int i, j, nrecs = 0;
+  VALUE klass = Qnil, clients = Qnil;
+  SubBackend *b = NULL;
+  SubBackendClient *recs = NULL;
+
+  klass   = rb_const_get(mod, rb_intern("Client"));
+  clients = rb_ary_new();
+
+  /* Collect clients with values still to load */
+  for(i = 0; i < RARRAY_LEN(futures); i++)
+    {
+      SubtlextFuture *f = FutureGet(rb_ary_entry(futures, i));
+
+      if(rb_obj_is_instance_of(f->receiver, klass) &&
+          !OBJ_FROZEN(f->receiver))
+        {
+          if((SUB_CLIENT_ALL != (subClientLoaded(f->receiver, 0) &
+              SUB_CLIENT_ALL) || NIL_P(rb_iv_get(f->receiver, "@geometry"))) &&
+              !RTEST(rb_ary_includes(clients, f->receiver)))
+            rb_ary_push(clients, f->receiver);
+        }
+    }
+
+  /* Fetch all client values in one go, single clients load on their own */
+  if(1 < RARRAY_LEN(clients) && (b = subSharedBackendGet(display)) &&
+      -1 != (nrecs = b->list(&recs)))
+    {
+      for(i = 0; i < RARRAY_LEN(clients); i++)
+        {
+          VALUE client = rb_ary_entry(clients, i);
+          Window win = NUM2LONG(rb_iv_get(client, "@win"));
+
+          for(j = 0; j < nrecs; j++)
+            {
+              if(recs[j].win == win)
+                {
+                  subClientRecord(client, &recs[j]);
+
+                  break;
+                }
+            }
+        }
+
+      free(recs);
+    }
+} /* }}} */
+
+/* Helper */
+
+/* subFutureInstantiate {{{ */
+VALUE
+subFutureInstantiate(VALUE receiver,
+  VALUE meth)
+{
+  ID id = 0;
+  VALUE klass = Qnil, future = Qnil;
+  SubtlextFuture *f = NULL;
+
+  /* Check object type */
+  if(T_SYMBOL != rb_type(meth) && T_STRING != rb_type(meth))
+    rb_raise(rb_eArgError, "Unexpected value-type `%s'",
+      rb_obj_classname(meth));
+
+  /* Check method */
+  if(!rb_respond_to(receiver, (id = rb_to_id(meth))))
+    rb_raise(rb_eArgError, "Unknown method `%s'", rb_id2name(id));
+
+  /* Create new instance */
+  klass  = rb_const_get(mod, rb_intern("Future"));
+  future = TypedData_Make_Struct(klass, SubtlextFuture, &FutureType, f);
+
+  f->state    = FUTURE_PENDING;
+  f->meth     = id;
+  f->receiver = receiver;
+  f->value    = Qnil;
+
+  return future;
+} /* }}} */
+
+/* Singleton */
+
+/* subFutureSingAwait {{{ */
+/*
+ * call-seq: await(futures) -> Array
+ *           await(future)  -> Object
+ *
+ * Resolve given Future objects in one batch and return their values.
+ * Client values are fetched from subtle for all Clients in one request
+ * and Futures of the same method on the same receiver share one call.
+ *
+ * Batching needs a connection to subtle, either from inside of subtle or
+ * via its RPC socket. Over plain X every other Future still costs its own
+ * round trips.
+ *
+ *  futures = Subtlext::Client.list.map { |c| c.async(:name) }
+ *  Subtlext.await(futures)
+ *  => [ "subtle", "urxvt" ]
+ */
+
+VALUE
+subFutureSingAwait(VALUE self,
+  VALUE futures)
+{
+  int i, j;
+  VALUE ary = Qnil, ret = Qnil;
+
+  /* Check object type */
+  if(rb_typeddata_is_kind_of(futures, &FutureType))
+    ary = rb_ary_new3(1, futures);
+  else ary = rb_Array(futures);
+
+  subSubtlextConnect(NULL); ///< Implicit open connection
+
+  /* Check futures */
+  for(i = 0; i < RARRAY_LEN(ary); i++)
+    FutureGet(rb_ary_entry(ary, i));
+
+  FuturePrefetch(ary);
+
+  /* Resolve pending futures */
+  for(i = 0; i < RARRAY_LEN(ary); i++)
+    {
+      SubtlextFuture *f = FutureGet(rb_ary_entry(ary, i));
+
+      if(FUTURE_PENDING != f->state) continue;
+
+      /* Share values of equal requests */
+      for(j = 0; j < i; j++)
+        {
+          SubtlextFuture *prev = FutureGet(rb_ary_entry(ary, j));
+
+          if(prev->receiver == f->receiver && prev->meth == f->meth)
+            {
+              f->state = prev->state;
+              f->value = prev->value;
+
+              break;
+            }
+        }
+
+      if(FUTURE_PENDING == f->state) FutureResolve(f);
+    }
+
+  /* Collect values */
+  if(rb_typeddata_is_kind_of(futures, &FutureType))
+    ret = subFutureValue(futures);
+  else
+    {
+      ret = rb_ary_new2(RARRAY_LEN(ary));
+
+      for(i = 0; i < RARRAY_LEN(ary); i++)
+        rb_ary_push(ret, subFutureValue(rb_ary_entry(ary, i)));
+    }
+
+  return ret;
+} /* }}} */
+
+/* Class */
+
+/* subFutureAsync {{{ */
+/*
+ * call-seq: async(method) -> Subtlext::Future
+ *
+ * Create a Future of given reader <i>method</i> that is resolved later
+ * together with other Futures via Subtlext#await.
+ *
+ *  client.async(:geometry)
+ *  => #<Subtlext::Future:xxx>
+ *
+ *  Subtlext::View.async(:list)
+ *  => #<Subtlext::Future:xxx>
+ */
+
+VALUE
+subFutureAsync(VALUE self,
+  VALUE meth)
+{
+  return subFutureInstantiate(self, meth);
+} /* }}} */
+
+/* subFutureValue {{{ */
+/*
+ * call-seq: value -> Object
+ *
+ * Get value of this Future, resolve it first when it is still pending.
+ * Errors of the call are raised here.
+ *
+ *  future.value
+ *  => #<Subtlext::Geometry:xxx>
+ */
+
+VALUE
+subFutureValue(VALUE self)
+{
+  SubtlextFuture *f = FutureGet(self);
+
+  if(FUTURE_PENDING == f->state) subFutureSingAwait(Qnil, self);
+  if(FUTURE_FAILED  == f->state) rb_exc_raise(f->value);
+
+  return f->value;
+} /* }}} */
+
+/* subFutureAskReady {{{ */
+/*
+ * call-seq: ready? -> true or false
+ *
+ * Whether this Future is already resolved.
+ *
+ *  future.ready?
+ *  => false
+ */
+
+VALUE
+subFutureAskReady(VALUE self)
+{
+  return FUTURE_PENDING != FutureGet(self)->state ? Qtrue : Qfalse;
+} /* }}} */
+
+// vim:ts=2:bs=2:sw=2:et:fdm=marker
@@ -11,6 +11,52 @@
 
 #include "subtlext.h"
 
+/* Typedef {{{ */
+typedef struct subtlextgeometry_t
+{
+  int x, y, width, height;
+} SubtlextGeometry;
+/* }}} */
+
+/* GeometryMemsize {{{ */
+static size_t
+GeometryMemsize(const void *data)
+{
+  return sizeof(SubtlextGeometry);
+} /* }}} */
+
+static const rb_data_type_t GeometryType = {
+  "Subtlext::Geometry",
+  { NULL, RUBY_TYPED_DEFAULT_FREE, GeometryMemsize, },
+#ifdef RUBY_TYPED_FREE_IMMEDIATELY
+  NULL, NULL, RUBY_TYPED_FREE_IMMEDIATELY
+#endif /* RUBY_TYPED_FREE_IMMEDIATELY */
+};
+
+/* GeometryGet {{{ */
+static SubtlextGeometry *
+GeometryGet(VALUE self)
+{
+  SubtlextGeometry *g = NULL;
+
+  TypedData_Get_Struct(self, SubtlextGeometry, &GeometryType, g);
+
+  return g;
+} /* }}} */
+
+/* GeometrySet {{{ */
+static VALUE
+GeometrySet(VALUE self,
+  int *field,
+  VALUE value)
+{
+  rb_check_frozen(self);
+
+  *field = NUM2INT(value);
+
+  return value;
+} /* }}} */
+
 /* GeometryEqual {{{ */
 VALUE
 GeometryEqual(VALUE self,
@@ -58,15 +104,32 @@ void
 subGeometryToRect(VALUE self,
   XRectangle *r)
 {
+  SubtlextGeometry *g = GeometryGet(self);
+
   /* Set values */
-  r->x      = FIX2INT(rb_iv_get(self, "@x"));
-  r->y      = FIX2INT(rb_iv_get(self, "@y"));
-  r->width  = FIX2INT(rb_iv_get(self, "@width"));
-  r->height = FIX2INT(rb_iv_get(self, "@height"));
+  r->x      = g->x;
+  r->y      = g->y;
+  r->width  = g->width;
+  r->height = g->height;
 } /* }}} */
 
 /* Class */
 
+/* subGeometryAlloc {{{ */
+/*
+ * call-seq: new(x, y, width, height) -> Subtlext::Geometry
+ *
+ * Allocate space for a new Geometry object.
+ */
+
+VALUE
+subGeometryAlloc(VALUE self)
+{
+  SubtlextGeometry *g = NULL;
+
+  return TypedData_Make_Struct(self, SubtlextGeometry, &GeometryType, g);
+} /* }}} */
+
 /* subGeometryInit {{{ */
 /*
  * call-seq: new(x, y, width, height) -> Subtlext::Geometry
@@ -111,6 +174,7 @@ subGeometryInit(int argc,
 {
   VALUE value = Qnil, data[4] = { Qnil };
 
+  rb_check_frozen(self);
   rb_scan_args(argc, argv, "13", &data[0], &data[1], &data[2], &data[3]);
   value = data[0];
 
@@ -150,18 +214,16 @@ subGeometryInit(int argc,
             data[3] = INT2FIX(geom.height);
           }
         break;
-      case T_OBJECT:
+      case T_DATA:
+        /* Check object instance */
+        if(rb_typeddata_is_kind_of(value, &GeometryType))
           {
-            VALUE klass = rb_const_get(mod, rb_intern("Geometry"));
-
-            /* Check object instance */
-            if(rb_obj_is_instance_of(value, klass))
-              {
-                data[0] = rb_iv_get(value, "@x");
-                data[1] = rb_iv_get(value, "@y");
-                data[2] = rb_iv_get(value, "@width");
-                data[3] = rb_iv_get(value, "@height");
-              }
+            SubtlextGeometry *g = GeometryGet(value);
+
+            data[0] = INT2FIX(g->x);
+            data[1] = INT2FIX(g->y);
+            data[2] = INT2FIX(g->width);
+            data[3] = INT2FIX(g->height);
           }
         break;
       default: rb_raise(rb_eArgError, "Unexpected value-type `%s'",
@@ -172,16 +234,169 @@ subGeometryInit(int argc,
   if(FIXNUM_P(data[0]) && FIXNUM_P(data[1]) && FIXNUM_P(data[2]) &&
       FIXNUM_P(data[3]) && 0 < FIX2INT(data[2]) && 0 < FIX2INT(data[3]))
     {
-      rb_iv_set(self, "@x",      data[0]);
-      rb_iv_set(self, "@y",      data[1]);
-      rb_iv_set(self, "@width",  data[2]);
-      rb_iv_set(self, "@height", data[3]);
+      SubtlextGeometry *g = GeometryGet(self);
+
+      g->x      = FIX2INT(data[0]);
+      g->y      = FIX2INT(data[1]);
+      g->width  = FIX2INT(data[2]);
+      g->height = FIX2INT(data[3]);
     }
   else rb_raise(rb_eStandardError, "Invalid geometry");
 
   return self;
 } /* }}} */
 
+/* subGeometryInitCopy {{{ */
+/*
+ * call-seq: initialize_copy(geometry) -> Subtlext::Geometry
+ *
+ * Copy values from given Geometry object on dup and clone.
+ */
+
+VALUE
+subGeometryInitCopy(VALUE self,
+  VALUE other)
+{
+  rb_check_frozen(self);
+
+  if(self != other)
+    *GeometryGet(self) = *GeometryGet(other);
+
+  return self;
+} /* }}} */
+
+/* subGeometryXReader {{{ */
+/*
+ * call-seq: x -> Fixnum
+ *
+ * Get x offset of this Geometry object.
+ *
+ *  geom.x
+ *  => 0
+ */
+
+VALUE
+subGeometryXReader(VALUE self)
+{
+  return INT2FIX(GeometryGet(self)->x);
+} /* }}} */
+
+/* subGeometryXWriter {{{ */
+/*
+ * call-seq: x=(fixnum) -> Fixnum
+ *
+ * Set x offset of this Geometry object.
+ *
+ *  geom.x = 0
+ *  => 0
+ */
+
+VALUE
+subGeometryXWriter(VALUE self,
+  VALUE value)
+{
+  return GeometrySet(self, &GeometryGet(self)->x, value);
+} /* }}} */
+
+/* subGeometryYReader {{{ */
+/*
+ * call-seq: y -> Fixnum
+ *
+ * Get y offset of this Geometry object.
+ *
+ *  geom.y
+ *  => 0
+ */
+
+VALUE
+subGeometryYReader(VALUE self)
+{
+  return INT2FIX(GeometryGet(self)->y);
+} /* }}} */
+
+/* subGeometryYWriter {{{ */
+/*
+ * call-seq: y=(fixnum) -> Fixnum
+ *
+ * Set y offset of this Geometry object.
+ *
+ *  geom.y = 0
+ *  => 0
+ */
+
+VALUE
+subGeometryYWriter(VALUE self,
+  VALUE value)
+{
+  return GeometrySet(self, &GeometryGet(self)->y, value);
+} /* }}} */
+
+/* subGeometryWidthReader {{{ */
+/*
+ * call-seq: width -> Fixnum
+ *
+ * Get width of this Geometry object.
+ *
+ *  geom.width
+ *  => 50
+ */
+
+VALUE
+subGeometryWidthReader(VALUE self)
+{
+  return INT2FIX(GeometryGet(self)->width);
+} /* }}} */
+
+/* subGeometryWidthWriter {{{ */
+/*
+ * call-seq: width=(fixnum) -> Fixnum
+ *
+ * Set width of this Geometry object.
+ *
+ *  geom.width = 50
+ *  => 50
+ */
+
+VALUE
+subGeometryWidthWriter(VALUE self,
+  VALUE value)
+{
+  return GeometrySet(self, &GeometryGet(self)->width, value);
+} /* }}} */
+
+/* subGeometryHeightReader {{{ */
+/*
+ * call-seq: height -> Fixnum
+ *
+ * Get height of this Geometry object.
+ *
+ *  geom.height
+ *  => 50
+ */
+
+VALUE
+subGeometryHeightReader(VALUE self)
+{
+  return INT2FIX(GeometryGet(self)->height);
+} /* }}} */
+
+/* subGeometryHeightWriter {{{ */
+/*
+ * call-seq: height=(fixnum) -> Fixnum
+ *
+ * Set height of this Geometry object.
+ *
+ *  geom.height = 50
+ *  => 50
+ */
+
+VALUE
+subGeometryHeightWriter(VALUE self,
+  VALUE value)
+{
+  return GeometrySet(self, &GeometryGet(self)->height, value);
+} /* }}} */
+
 /* subGeometryToArray {{{ */
 /*
  * call-seq: to_a -> Array
@@ -196,22 +411,17 @@ subGeometryInit(int argc,
 VALUE
 subGeometryToArray(VALUE self)
 {
-  VALUE ary = Qnil, x = Qnil, y = Qnil, width = Qnil, height = Qnil;
-
-  /* Check ruby object */
-  GET_ATTR(self, "@x",      x);
-  GET_ATTR(self, "@y",      y);
-  GET_ATTR(self, "@width",  width);
-  GET_ATTR(self, "@height", height);
+  VALUE ary = Qnil;
+  SubtlextGeometry *g = GeometryGet(self);
 
   /* Create new array */
   ary = rb_ary_new2(4);
 
   /* Set values */
-  rb_ary_push(ary, x);
-  rb_ary_push(ary, y);
-  rb_ary_push(ary, width);
-  rb_ary_push(ary, height);
+  rb_ary_push(ary, INT2FIX(g->x));
+  rb_ary_push(ary, INT2FIX(g->y));
+  rb_ary_push(ary, INT2FIX(g->width));
+  rb_ary_push(ary, INT2FIX(g->height));
 
   return ary;
 } /* }}} */
@@ -231,23 +441,17 @@ VALUE
 subGeometryToHash(VALUE self)
 {
   VALUE klass = Qnil, hash = Qnil;
-  VALUE x = Qnil, y = Qnil, width = Qnil, height = Qnil;
-
-  /* Check ruby object */
-  GET_ATTR(self, "@x",      x);
-  GET_ATTR(self, "@y",      y);
-  GET_ATTR(self, "@width",  width);
-  GET_ATTR(self, "@height", height);
+  SubtlextGeometry *g = GeometryGet(self);
 
   /* Create new hash */
   klass = rb_const_get(rb_mKernel, rb_intern("Hash"));
   hash  = rb_funcall(klass, rb_intern("new"), 0, NULL);
 
   /* Set values */
-  rb_hash_aset(hash, CHAR2SYM("x"),      x);
-  rb_hash_aset(hash, CHAR2SYM("y"),      y);
-  rb_hash_aset(hash, CHAR2SYM("width"),  width);
-  rb_hash_aset(hash, CHAR2SYM("height"), height);
+  rb_hash_aset(hash, CHAR2SYM("x"),      INT2FIX(g->x));
+  rb_hash_aset(hash, CHAR2SYM("y"),      INT2FIX(g->y));
+  rb_hash_aset(hash, CHAR2SYM("width"),  INT2FIX(g->width));
+  rb_hash_aset(hash, CHAR2SYM("height"), INT2FIX(g->height));
 
   return hash;
 } /* }}} */
@@ -266,16 +470,10 @@ VALUE
 subGeometryToString(VALUE self)
 {
   char buf[256] = { 0 };
-  VALUE x = Qnil, y = Qnil, width = Qnil, height = Qnil;
-
-  /* Check ruby object */
-  GET_ATTR(self, "@x",      x);
-  GET_ATTR(self, "@y",      y);
-  GET_ATTR(self, "@width",  width);
-  GET_ATTR(self, "@height", height);
+  SubtlextGeometry *g = GeometryGet(self);
 
-  snprintf(buf, sizeof(buf), "%dx%d+%d+%d", (int)FIX2INT(x),
-    (int)FIX2INT(y), (int)FIX2INT(width), (int)FIX2INT(height));
+  snprintf(buf, sizeof(buf), "%dx%d+%d+%d",
+    g->x, g->y, g->width, g->height);
 
   return rb_str_new2(buf);
 } /* }}} */
@@ -34,8 +34,8 @@ GravityFindId(char *match,
 
   /* Find gravity id */
   if((gravities = subSharedPropertyGetStrings(display,
-      DefaultRootWindow(display), XInternAtom(display,
-      "SUBTLE_GRAVITY_LIST", False), &ngravities)))
+      DefaultRootWindow(display), subSubtlextAtom(SUB_ATOM_SUBTLE_GRAVITY_LIST),
+      &ngravities)))
     {
       int i;
       XRectangle geom = { 0 };
@@ -94,7 +94,7 @@ GravityFind(VALUE value,
           return parsed;
     }
 
-  return subSubtlextFindObjectsGeometry("SUBTLE_GRAVITY_LIST",
+  return subSubtlextFindObjectsGeometry(SUB_ATOM_SUBTLE_GRAVITY_LIST,
     "Gravity", buf, flags, first);
 } /* }}} */
 
@@ -180,7 +180,7 @@ subGravitySingFirst(VALUE self,
 VALUE
 subGravitySingList(VALUE self)
 {
-  return subSubtlextFindObjectsGeometry("SUBTLE_GRAVITY_LIST",
+  return subSubtlextFindObjectsGeometry(SUB_ATOM_SUBTLE_GRAVITY_LIST,
     "Gravity", NULL, 0, False);
 } /* }}} */
 
@@ -312,7 +312,7 @@ subGravitySave(VALUE self)
       char **gravities = NULL;
 
       gravities = subSharedPropertyGetStrings(display, DefaultRootWindow(display),
-        XInternAtom(display, "SUBTLE_GRAVITY_LIST", False), &ngravities);
+        subSubtlextAtom(SUB_ATOM_SUBTLE_GRAVITY_LIST), &ngravities);
 
       id = ngravities; ///< New id should be last
 
@@ -355,7 +355,7 @@ subGravityClients(VALUE self)
   klass   = rb_const_get(mod, rb_intern("Client"));
   meth    = rb_intern("new");
   array   = rb_ary_new();
-  clients = subSubtlextWindowList("_NET_CLIENT_LIST", &nclients);
+  clients = subSubtlextWindowList(SUB_ATOM_NET_CLIENT_LIST, &nclients);
 
   /* Check results */
   if(clients)
@@ -366,8 +366,8 @@ subGravityClients(VALUE self)
 
           /* Get window gravity */
           gravity = (unsigned long *)subSharedPropertyGet(display,
-            clients[i], XA_CARDINAL, XInternAtom(display,
-            "SUBTLE_CLIENT_GRAVITY", False), NULL);
+            clients[i], XA_CARDINAL,
+            subSubtlextAtom(SUB_ATOM_SUBTLE_CLIENT_GRAVITY), NULL);
 
           /* Check if there are common tags or window is stick */
           if(gravity && FIX2INT(id) == *gravity &&
@@ -10,6 +10,7 @@
   **/
 
 #include <unistd.h>
+#include <sys/stat.h>
 #include "subtlext.h"
 
 #ifdef HAVE_WORDEXP_H
@@ -27,16 +28,241 @@
 /* }}} */
 
 /* Typedef {{{ */
+typedef struct subtlexticonentry_t
+{
+  char         *path;
+  time_t       mtime;
+  Pixmap       pixmap;
+  int          flags, refs;
+  unsigned int width, height;
+  struct subtlexticonentry_t *next;
+} SubtlextIconEntry;
+
 typedef struct subtlexticon_t
 {
   GC           gc;
   Pixmap       pixmap;
   int          flags;
-  unsigned int width, height;
+  unsigned int width, height, revision;
   VALUE        instance;
+  SubtlextIconEntry *entry;
 } SubtlextIcon;
 /* }}} */
 
+static SubtlextIconEntry *icons[CACHESIZE] = { NULL };
+
+/* IconHash {{{ */
+static unsigned long
+IconHash(const char *path)
+{
+  unsigned long hash = 5381;
+
+  while(*path) hash = ((hash << 5) + hash) + *path++;
+
+  return hash % CACHESIZE;
+} /* }}} */
+
+/* IconCacheFind {{{ */
+static SubtlextIconEntry *
+IconCacheFind(const char *path,
+  time_t mtime)
+{
+  SubtlextIconEntry *e = NULL;
+
+  for(e = icons[IconHash(path)]; e; e = e->next)
+    if(e->mtime == mtime && !strcmp(e->path, path)) break;
+
+  return e;
+} /* }}} */
+
+/* IconCacheAdd {{{ */
+static SubtlextIconEntry *
+IconCacheAdd(SubtlextIcon *i,
+  const char *path,
+  time_t mtime)
+{
+  unsigned long hash = IconHash(path);
+  SubtlextIconEntry *e = NULL;
+
+  e = (SubtlextIconEntry *)subSharedMemoryAlloc(1,
+    sizeof(SubtlextIconEntry));
+  e->path   = strdup(path);
+  e->mtime  = mtime;
+  e->pixmap = i->pixmap;
+  e->flags  = i->flags;
+  e->width  = i->width;
+  e->height = i->height;
+  e->next   = icons[hash];
+
+  icons[hash] = e;
+
+  return e;
+} /* }}} */
+
+/* IconCacheUnlink {{{ */
+static void
+IconCacheUnlink(SubtlextIconEntry *e)
+{
+  SubtlextIconEntry **prev = &icons[IconHash(e->path)];
+
+  while(*prev && *prev != e) prev = &(*prev)->next;
+  if(*prev) *prev = e->next;
+
+  free(e->path);
+  free(e);
+} /* }}} */
+
+/* IconCacheRelease {{{ */
+static void
+IconCacheRelease(SubtlextIconEntry *e)
+{
+  /* Keep pixmap as long as any icon uses it */
+  if(0 < --e->refs) return;
+
+  if(display) XFreePixmap(display, e->pixmap);
+
+  IconCacheUnlink(e);
+} /* }}} */
+
+/* IconDetach {{{ */
+static void
+IconDetach(SubtlextIcon *i)
+{
+  GC gc = 0;
+  Pixmap pixmap = None;
+
+  i->revision++; ///< Content changes after detaching
+
+  /* Take over pixmap of the last user, later loads decode it again */
+  if(i->entry && 1 == i->entry->refs)
+    {
+      IconCacheUnlink(i->entry);
+
+      i->entry = NULL;
+    }
+
+  /* Copy shared pixmap before drawing on it */
+  if(i->entry)
+    {
+      pixmap = XCreatePixmap(display, DefaultRootWindow(display),
+        i->width, i->height, i->flags & ICON_PIXMAP ?
+        XDefaultDepth(display, DefaultScreen(display)) : 1);
+      gc     = XCreateGC(display, pixmap, 0, NULL);
+
+      XCopyArea(display, i->pixmap, pixmap, gc, 0, 0,
+        i->width, i->height, 0, 0);
+      XFreeGC(display, gc);
+
+      IconCacheRelease(i->entry);
+
+      i->entry  = NULL;
+      i->pixmap = pixmap;
+
+      rb_iv_set(i->instance, "@pixmap", LONG2NUM(i->pixmap));
+    }
+} /* }}} */
+
+/* IconGC {{{ */
+static void
+IconGC(SubtlextIcon *i,
+  VALUE fg,
+  VALUE bg)
+{
+  XGCValues gvals;
+
+  IconDetach(i);
+
+  /* Create on demand */
+  if(0 == i->gc)
+    i->gc = XCreateGC(display, i->pixmap, 0, NULL);
+
+  /* Update GC */
+  gvals.foreground = 1;
+  gvals.background = 0;
+
+  if(i->flags & ICON_PIXMAP)
+    {
+      if(!NIL_P(fg)) gvals.foreground = subColorPixel(fg, Qnil, Qnil, NULL);
+      if(!NIL_P(bg)) gvals.background = subColorPixel(bg, Qnil, Qnil, NULL);
+    }
+
+  XChangeGC(display, i->gc, GCForeground|GCBackground, &gvals);
+} /* }}} */
+
+/* IconShortsFill {{{ */
+static VALUE
+IconShortsFill(VALUE data)
+{
+  int j, k, n = 0, len = 0;
+  short *shorts = NULL;
+  VALUE *rargs = (VALUE *)data, entry = Qnil;
+
+  n      = FIX2INT(rargs[1]);
+  len    = FIX2INT(rargs[2]);
+  shorts = (short *)rargs[3];
+
+  for(j = 0; j < len; j++)
+    {
+      entry = rb_ary_entry(rargs[0], j);
+
+      if(Qtrue == rargs[4]) ///< Nested
+        {
+          if(T_ARRAY != rb_type(entry) || n != RARRAY_LEN(entry))
+            rb_raise(rb_eArgError, "Unexpected value-types");
+
+          for(k = 0; k < n; k++)
+            shorts[j * n + k] = NUM2INT(rb_ary_entry(entry, k));
+        }
+      else shorts[j] = NUM2INT(entry);
+    }
+
+  return Qnil;
+} /* }}} */
+
+/* IconShorts {{{ */
+static short *
+IconShorts(VALUE value,
+  int n,
+  int *nitems)
+{
+  int len = 0, size = 0, state = 0;
+  short *shorts = NULL;
+  VALUE nested = Qfalse, rargs[5] = { Qnil };
+
+  /* Accept nested [[x, y], ...] and flat [x, y, ...] arrays */
+  Check_Type(value, T_ARRAY);
+
+  len    = RARRAY_LEN(value);
+  nested = (0 < len && T_ARRAY == rb_type(rb_ary_entry(value, 0))) ?
+    Qtrue : Qfalse;
+
+  if(Qfalse == nested && 0 != len % n)
+    rb_raise(rb_eArgError, "Unexpected value-types");
+
+  size   = Qtrue == nested ? len * n : len;
+  shorts = (short *)subSharedMemoryAlloc(0 < size ? size : 1,
+    sizeof(short));
+
+  /* Free buffer when a conversion raises */
+  rargs[0] = value;
+  rargs[1] = INT2FIX(n);
+  rargs[2] = INT2FIX(len);
+  rargs[3] = (VALUE)shorts;
+  rargs[4] = nested;
+
+  rb_protect(IconShortsFill, (VALUE)&rargs, &state);
+  if(state)
+    {
+      free(shorts);
+
+      rb_jump_tag(state);
+    }
+
+  *nitems = Qtrue == nested ? len : len / n;
+
+  return shorts;
+} /* }}} */
+
 /* IconMark {{{ */
 static void
 IconMark(SubtlextIcon *i)
@@ -51,7 +277,8 @@ IconSweep(SubtlextIcon *i)
   if(i)
     {
       /* Check if we can kill the pixmap here */
-      if(!(i->flags & ICON_FOREIGN) && i->pixmap)
+      if(i->entry) IconCacheRelease(i->entry);
+      else if(!(i->flags & ICON_FOREIGN) && i->pixmap)
         XFreePixmap(display, i->pixmap);
 
       if(0 != i->gc) XFreeGC(display, i->gc);
@@ -82,6 +309,26 @@ IconEqual(VALUE self,
   return ret ? Qtrue : Qfalse;
 } /* }}} */
 
+/* Helper */
+
+/* subIconPixmap {{{ */
+Pixmap
+subIconPixmap(VALUE self,
+  unsigned int *revision)
+{
+  SubtlextIcon *i = NULL;
+
+  Data_Get_Struct(self, SubtlextIcon, i);
+  if(i)
+    {
+      if(revision) *revision = i->revision;
+
+      return i->pixmap;
+    }
+
+  return None;
+} /* }}} */
+
 /* Class */
 
 /* subIconAlloc {{{ */
@@ -139,6 +386,7 @@ subIconInit(int argc,
         {
           int hotx = 0, hoty = 0;
           char buf[100] = { 0 };
+          struct stat sb;
 
 #ifdef HAVE_WORDEXP_H
           /* Expand tildes in path */
@@ -177,8 +425,20 @@ subIconInit(int argc,
                   RSTRING_PTR(data[0]));
             }
 
+          /* Share decoded icon of unchanged file */
+          if(0 == stat(buf, &sb) && (i->entry = IconCacheFind(buf,
+              sb.st_mtime)))
+            {
+              i->entry->refs++;
+
+              i->pixmap = i->entry->pixmap;
+              i->flags  = i->entry->flags;
+              i->width  = i->entry->width;
+              i->height = i->entry->height;
+            }
+
           /* Reading bitmap or pixmap icon file */
-          if(BitmapSuccess != XReadBitmapFile(display,
+          else if(BitmapSuccess != XReadBitmapFile(display,
               DefaultRootWindow(display), buf, &i->width, &i->height,
               &i->pixmap, &hotx, &hoty))
             {
@@ -211,6 +471,13 @@ subIconInit(int argc,
                }
             }
           else i->flags |= ICON_BITMAP;
+
+          /* Cache new icon */
+          if(!i->entry && 0 == stat(buf, &sb))
+            {
+              i->entry = IconCacheAdd(i, buf, sb.st_mtime);
+              i->entry->refs++;
+            }
         }
       else if(FIXNUM_P(data[0]) && FIXNUM_P(data[1])) ///< Icon dimensions
         {
@@ -287,6 +554,8 @@ subIconDrawPoint(int argc,
         {
           XGCValues gvals;
 
+          IconDetach(i);
+
           /* Create on demand */
           if(0 == i->gc)
             i->gc = XCreateGC(display, i->pixmap, 0, NULL);
@@ -350,6 +619,8 @@ subIconDrawLine(int argc,
         {
           XGCValues gvals;
 
+          IconDetach(i);
+
           /* Create on demand */
           if(0 == i->gc)
             i->gc = XCreateGC(display, i->pixmap, 0, NULL);
@@ -414,6 +685,8 @@ subIconDrawRect(int argc,
         {
           XGCValues gvals;
 
+          IconDetach(i);
+
           /* Create on demand */
           if(0 == i->gc)
             i->gc = XCreateGC(display, i->pixmap, 0, NULL);
@@ -449,6 +722,217 @@ subIconDrawRect(int argc,
   return self;
 } /* }}} */
 
+/* subIconDrawPoints {{{ */
+/*
+ * call-seq: draw_points(points, fg, bg) -> Subtlext::Icon
+ *
+ * Draw many points on the Icon in given colors with a single request.
+ *
+ *  icon.draw_points([ [ 1, 1 ], [ 2, 4 ], [ 3, 2 ] ])
+ *  => #<Subtlext::Icon:xxx>
+ *
+ *  icon.draw_points([ 1, 1, 2, 4, 3, 2 ], "#ff0000", "#000000")
+ *  => #<Subtlext::Icon:xxx>
+ */
+
+VALUE
+subIconDrawPoints(int argc,
+  VALUE *argv,
+  VALUE self)
+{
+  SubtlextIcon *i = NULL;
+  VALUE data[3] = { Qnil };
+
+  rb_scan_args(argc, argv, "12", &data[0], &data[1], &data[2]);
+
+  Data_Get_Struct(self, SubtlextIcon, i);
+  if(i)
+    {
+      int npoints = 0;
+      short *points = NULL;
+
+      IconGC(i, data[1], data[2]);
+
+      points = IconShorts(data[0], 2, &npoints);
+
+      XDrawPoints(display, i->pixmap, i->gc, (XPoint *)points,
+        npoints, CoordModeOrigin);
+      XFlush(display);
+
+      free(points);
+    }
+
+  return self;
+} /* }}} */
+
+/* subIconDrawSegments {{{ */
+/*
+ * call-seq: draw_segments(segments, fg, bg) -> Subtlext::Icon
+ *
+ * Draw many lines from x1/y1 to x2/y2 on the Icon in given colors with a
+ * single request.
+ *
+ *  icon.draw_segments([ [ 1, 1, 1, 10 ], [ 2, 5, 2, 10 ] ])
+ *  => #<Subtlext::Icon:xxx>
+ *
+ *  icon.draw_segments([ 1, 1, 1, 10, 2, 5, 2, 10 ], "#ff0000", "#000000")
+ *  => #<Subtlext::Icon:xxx>
+ */
+
+VALUE
+subIconDrawSegments(int argc,
+  VALUE *argv,
+  VALUE self)
+{
+  SubtlextIcon *i = NULL;
+  VALUE data[3] = { Qnil };
+
+  rb_scan_args(argc, argv, "12", &data[0], &data[1], &data[2]);
+
+  Data_Get_Struct(self, SubtlextIcon, i);
+  if(i)
+    {
+      int nsegments = 0;
+      short *segments = NULL;
+
+      IconGC(i, data[1], data[2]);
+
+      segments = IconShorts(data[0], 4, &nsegments);
+
+      XDrawSegments(display, i->pixmap, i->gc, (XSegment *)segments,
+        nsegments);
+      XFlush(display);
+
+      free(segments);
+    }
+
+  return self;
+} /* }}} */
+
+/* subIconDrawRects {{{ */
+/*
+ * call-seq: draw_rects(rects, fill, fg, bg) -> Subtlext::Icon
+ *
+ * Draw many rects of x, y, width and height on the Icon in given colors
+ * with a single request.
+ *
+ *  icon.draw_rects([ [ 0, 5, 2, 5 ], [ 3, 2, 2, 8 ] ], true)
+ *  => #<Subtlext::Icon:xxx>
+ *
+ *  icon.draw_rects([ 0, 5, 2, 5, 3, 2, 2, 8 ], false, "#ff0000", "#000000")
+ *  => #<Subtlext::Icon:xxx>
+ */
+
+VALUE
+subIconDrawRects(int argc,
+  VALUE *argv,
+  VALUE self)
+{
+  SubtlextIcon *i = NULL;
+  VALUE data[4] = { Qnil };
+
+  rb_scan_args(argc, argv, "13", &data[0], &data[1], &data[2], &data[3]);
+
+  Data_Get_Struct(self, SubtlextIcon, i);
+  if(i)
+    {
+      int nrects = 0;
+      short *rects = NULL;
+
+      IconGC(i, data[2], data[3]);
+
+      rects = IconShorts(data[0], 4, &nrects);
+
+      /* Draw rects */
+      if(Qtrue == data[1])
+        {
+          XFillRectangles(display, i->pixmap, i->gc,
+            (XRectangle *)rects, nrects);
+        }
+      else XDrawRectangles(display, i->pixmap, i->gc,
+        (XRectangle *)rects, nrects);
+
+      XFlush(display);
+
+      free(rects);
+    }
+
+  return self;
+} /* }}} */
+
+/* subIconPutImage {{{ */
+/*
+ * call-seq: put_image(data, fg, bg) -> Subtlext::Icon
+ *
+ * Replace the content of the Icon with raw image data in one request.
+ * Bitmaps and calls with colors expect packed XBM bits, LSB first and
+ * each row padded to full bytes. Otherwise data contains the pixel
+ * values for the depth of the screen.
+ *
+ *  icon.put_image("\xff\x81\x81\x81\x81\x81\x81\xff")
+ *  => #<Subtlext::Icon:xxx>
+ *
+ *  icon.put_image(bits, "#ff0000", "#000000")
+ *  => #<Subtlext::Icon:xxx>
+ */
+
+VALUE
+subIconPutImage(int argc,
+  VALUE *argv,
+  VALUE self)
+{
+  SubtlextIcon *i = NULL;
+  VALUE data[3] = { Qnil };
+
+  rb_scan_args(argc, argv, "12", &data[0], &data[1], &data[2]);
+
+  Check_Type(data[0], T_STRING);
+
+  Data_Get_Struct(self, SubtlextIcon, i);
+  if(i)
+    {
+      XImage *image = NULL;
+      int screen = DefaultScreen(display);
+
+      /* Create image from string data */
+      if(!(i->flags & ICON_PIXMAP) || !NIL_P(data[1]) || !NIL_P(data[2]))
+        {
+          image = XCreateImage(display, DefaultVisual(display, screen), 1,
+            XYBitmap, 0, RSTRING_PTR(data[0]), i->width, i->height, 8, 0);
+
+          /* Use XBM bit order */
+          image->byte_order       = LSBFirst;
+          image->bitmap_bit_order = LSBFirst;
+        }
+      else image = XCreateImage(display, DefaultVisual(display, screen),
+        DefaultDepth(display, screen), ZPixmap, 0, RSTRING_PTR(data[0]),
+        i->width, i->height, 32, 0);
+
+      if(!image) rb_raise(rb_eStandardError, "Failed creating image");
+
+      /* Check data size */
+      if(RSTRING_LEN(data[0]) < image->bytes_per_line * (int)i->height)
+        {
+          image->data = NULL;
+          XDestroyImage(image);
+
+          rb_raise(rb_eArgError, "Invalid image data size");
+        }
+
+      IconGC(i, data[1], data[2]);
+
+      XPutImage(display, i->pixmap, i->gc, image, 0, 0, 0, 0,
+        i->width, i->height);
+      XFlush(display);
+
+      /* Data belongs to ruby */
+      image->data = NULL;
+      XDestroyImage(image);
+    }
+
+  return self;
+} /* }}} */
+
 /* subIconCopyArea {{{ */
 /*
  * call-seq: copy_area(icon2, src_x, src_y, width, height, dest_x, dest_y) -> Subtlext::Icon
@@ -511,6 +995,8 @@ subIconCopyArea(int argc,
           if(0 > dest_x || dest_x > iwidth)  dest_x = 0;
           if(0 > dest_y || dest_y > iheight) dest_y = 0;
 
+          IconDetach(dest);
+
           /* Create on demand */
           if(0 == dest->gc)
             dest->gc = XCreateGC(display, dest->pixmap, 0, NULL);
@@ -558,6 +1044,8 @@ subIconClear(int argc,
     {
       XGCValues gvals;
 
+      IconDetach(i);
+
       if(0 == i->gc) ///< Create on demand
         i->gc = XCreateGC(display, i->pixmap, 0, NULL);
 
@@ -29,7 +29,7 @@ ScreenList(void)
   /* Get workarea list */
   if((workareas = (long *)subSharedPropertyGet(display,
       DefaultRootWindow(display), XA_CARDINAL,
-      XInternAtom(display, "_NET_WORKAREA", False), &nworkareas)))
+      subSubtlextAtom(SUB_ATOM_NET_WORKAREA), &nworkareas)))
     {
       int i;
 
@@ -103,7 +103,7 @@ subScreenSingFind(VALUE self,
                 /* Get workarea list */
                 if((workareas = (long *)subSharedPropertyGet(display,
                     DefaultRootWindow(display), XA_CARDINAL,
-                    XInternAtom(display, "_NET_WORKAREA", False),
+                    subSubtlextAtom(SUB_ATOM_NET_WORKAREA),
                     &nworkareas)))
                   {
                     int i;
@@ -192,9 +192,9 @@ subScreenSingCurrent(VALUE self)
 
   /* Fetch data */
   workareas = (long *)subSharedPropertyGet(display, DefaultRootWindow(display),
-    XA_CARDINAL, XInternAtom(display, "_NET_WORKAREA", False), &nworkareas);
+    XA_CARDINAL, subSubtlextAtom(SUB_ATOM_NET_WORKAREA), &nworkareas);
   panels    = (long *)subSharedPropertyGet(display, DefaultRootWindow(display),
-    XA_CARDINAL, XInternAtom(display, "SUBTLE_SCREEN_PANELS", False),
+    XA_CARDINAL, subSubtlextAtom(SUB_ATOM_SUBTLE_SCREEN_PANELS),
     &npanels);
 
   /* Get workarea list */
@@ -359,10 +359,10 @@ subScreenViewReader(VALUE self)
 
   /* Fetch data */
   names   = subSharedPropertyGetStrings(display, DefaultRootWindow(display),
-    XInternAtom(display, "_NET_DESKTOP_NAMES", False), &nnames);
+    subSubtlextAtom(SUB_ATOM_NET_DESKTOP_NAMES), &nnames);
   screens = (unsigned long *)subSharedPropertyGet(display,
-    DefaultRootWindow(display), XA_CARDINAL, XInternAtom(display,
-    "SUBTLE_SCREEN_VIEWS", False), NULL);
+    DefaultRootWindow(display), XA_CARDINAL,
+    subSubtlextAtom(SUB_ATOM_SUBTLE_SCREEN_VIEWS), NULL);
 
   /* Check results */
   if(names && screens)
@@ -35,7 +35,7 @@ SubletFind(VALUE value,
           return parsed;
     }
 
-  return subSubtlextFindObjectsGeometry("SUBTLE_SUBLET_LIST",
+  return subSubtlextFindObjectsGeometry(SUB_ATOM_SUBTLE_SUBLET_LIST,
     "Sublet", buf, flags, first);
 } /* }}} */
 
@@ -121,7 +121,7 @@ subSubletSingFirst(VALUE self,
 VALUE
 subSubletSingList(VALUE self)
 {
-  return subSubtlextFindObjectsGeometry("SUBTLE_SUBLET_LIST",
+  return subSubtlextFindObjectsGeometry(SUB_ATOM_SUBTLE_SUBLET_LIST,
     "Sublet", NULL, 0, False);
 } /* }}} */
 
@@ -213,7 +213,7 @@ subSubletSend(VALUE self,
       /* Store data */
       list = strdup(RSTRING_PTR(value));
       subSharedPropertySetStrings(display, DefaultRootWindow(display),
-        XInternAtom(display, "SUBTLE_DATA", False), &list, 1);
+        subSubtlextAtom(SUB_ATOM_SUBTLE_DATA), &list, 1);
       free(list);
 
       data.l[0] = FIX2INT(id);
@@ -9,8 +9,31 @@
   * See the file COPYING for details.
   **/
 
+#include <unistd.h>
 #include "subtlext.h"
 
+/* Events by hook slot of subtle */
+static char *events[SUB_SLOT_TOTAL] =
+{
+  [SUB_SLOT_START]  = "start",
+  [SUB_SLOT_RELOAD] = "reload",
+  [SUB_SLOT_EXIT]   = "exit",
+  [SUB_SLOT_TILE]   = "tile",
+
+  [SUB_SLOT(SUB_SLOT_CLIENT, SUB_SLOT_CREATE)]  = "client_create",
+  [SUB_SLOT(SUB_SLOT_CLIENT, SUB_SLOT_MODE)]    = "client_mode",
+  [SUB_SLOT(SUB_SLOT_CLIENT, SUB_SLOT_GRAVITY)] = "client_gravity",
+  [SUB_SLOT(SUB_SLOT_CLIENT, SUB_SLOT_FOCUS)]   = "client_focus",
+  [SUB_SLOT(SUB_SLOT_CLIENT, SUB_SLOT_KILL)]    = "client_kill",
+
+  [SUB_SLOT(SUB_SLOT_VIEW, SUB_SLOT_CREATE)] = "view_create",
+  [SUB_SLOT(SUB_SLOT_VIEW, SUB_SLOT_FOCUS)]  = "view_focus",
+  [SUB_SLOT(SUB_SLOT_VIEW, SUB_SLOT_KILL)]   = "view_kill",
+
+  [SUB_SLOT(SUB_SLOT_TAG, SUB_SLOT_CREATE)] = "tag_create",
+  [SUB_SLOT(SUB_SLOT_TAG, SUB_SLOT_KILL)]   = "tag_kill"
+};
+
 /* SubtleSend {{{ */
 static VALUE
 SubtleSend(char *message)
@@ -25,6 +48,64 @@ SubtleSend(char *message)
   return Qnil;
 } /* }}} */
 
+/* SubtleEventLoop {{{ */
+static VALUE
+SubtleEventLoop(VALUE fd)
+{
+  int slot = 0, id = -1;
+  char *name = NULL;
+  VALUE object = Qnil, str = Qnil;
+
+  /* Events are read without blocking other ruby threads */
+  while(True)
+    {
+      if(!subSubtlextEvent(FIX2INT(fd), &slot, &id, &name) ||
+          0 > slot || LENGTH(events) <= slot || !events[slot])
+        break; ///< Subtle is gone
+
+      str = name ? rb_str_new2(name) : Qnil;
+      if(name) free(name);
+
+      /* Create object of event */
+      if(SUB_SLOT(SUB_SLOT_CLIENT, SUB_SLOT_CREATE) <= slot &&
+          SUB_SLOT(SUB_SLOT_VIEW, SUB_SLOT_CREATE) > slot)
+        {
+          object = subClientInstantiate(id);
+
+          /* Name is loaded on demand when subtle sent none */
+          if(!NIL_P(str))
+            {
+              rb_iv_set(object, "@name", str);
+              subClientLoaded(object, SUB_CLIENT_NAME);
+            }
+        }
+      else if(SUB_SLOT(SUB_SLOT_VIEW, SUB_SLOT_CREATE) <= slot && !NIL_P(str))
+        {
+          object = SUB_SLOT(SUB_SLOT_TAG, SUB_SLOT_CREATE) > slot ?
+            subViewInstantiate(RSTRING_PTR(str)) :
+            subTagInstantiate(RSTRING_PTR(str));
+
+          rb_iv_set(object, "@id", INT2FIX(id));
+        }
+      else object = Qnil;
+
+      /* Stop when block returns false */
+      if(Qfalse == rb_yield_values(2, CHAR2SYM(events[slot]), object))
+        break;
+    }
+
+  return Qnil;
+} /* }}} */
+
+/* SubtleEventClose {{{ */
+static VALUE
+SubtleEventClose(VALUE fd)
+{
+  close(FIX2INT(fd));
+
+  return Qnil;
+} /* }}} */
+
 /* Singleton */
 
 /* subSubtleSingDisplayReader {{{ */
@@ -90,13 +171,13 @@ subSubtleSingAskRunning(VALUE self)
 
   /* Get supporting window */
   if((support = (Window *)subSharedPropertyGet(display,
-      DefaultRootWindow(display), XA_WINDOW, XInternAtom(display,
-      "_NET_SUPPORTING_WM_CHECK", False), NULL)))
+      DefaultRootWindow(display), XA_WINDOW,
+      subSubtlextAtom(SUB_ATOM_NET_SUPPORTING_WM_CHECK), NULL)))
     {
       /* Get version property */
-      if((version = subSharedPropertyGet(display, *support, XInternAtom(display,
-          "UTF8_STRING", False), XInternAtom(display, "SUBTLE_VERSION", False),
-          NULL)))
+      if((version = subSharedPropertyGet(display, *support,
+          subSubtlextAtom(SUB_ATOM_UTF8_STRING),
+          subSubtlextAtom(SUB_ATOM_SUBTLE_VERSION), NULL)))
         {
           running = Qtrue;
 
@@ -109,6 +190,74 @@ subSubtleSingAskRunning(VALUE self)
   return running;
 } /* }}} */
 
+/* subSubtleSingGeneration {{{ */
+/*
+ * call-seq: generation -> Fixnum or nil
+ *
+ * Get the generation counter of the state of subtle. It changes every time
+ * clients, tags or views change and can be polled cheaply.
+ *
+ *  subtle.generation
+ *  => 42
+ *
+ *  subtle.generation
+ *  => nil
+ */
+
+VALUE
+subSubtleSingGeneration(VALUE self)
+{
+  SubBackend *b = NULL;
+
+  subSubtlextConnect(NULL); ///< Implicit open connection
+
+  if((b = subSharedBackendGet(display)) && b->generation)
+    return UINT2NUM(b->generation());
+
+  return Qnil;
+} /* }}} */
+
+/* subSubtleSingAskCache {{{ */
+/*
+ * call-seq: cache? -> true or false
+ *
+ * Whether subtlext caches window properties.
+ *
+ *  subtle.cache?
+ *  => false
+ */
+
+VALUE
+subSubtleSingAskCache(VALUE self)
+{
+  subSubtlextConnect(NULL); ///< Implicit open connection
+
+  return subSharedPropertyCached(display) ? Qtrue : Qfalse;
+} /* }}} */
+
+/* subSubtleSingCacheWriter {{{ */
+/*
+ * call-seq: cache=(bool) -> nil
+ *
+ * Enable or disable the cache of window properties. Cached properties are
+ * dropped once the X server reports a change of them, so repeated lookups
+ * like Client#name or Subtlext::View.current don't cost a round trip.
+ *
+ *  subtle.cache = true
+ *  => nil
+ */
+
+VALUE
+subSubtleSingCacheWriter(VALUE self,
+  VALUE value)
+{
+  subSubtlextConnect(NULL); ///< Implicit open connection
+
+  subSharedPropertyCache(display, RTEST(value));
+
+  return Qnil;
+} /* }}} */
+
 /* subSubtleSingSelect {{{ */
 /*
  * call-seq: select_window -> Fixnum
@@ -136,7 +285,7 @@ subSubtleSingSelect(VALUE self)
 
   root   = DefaultRootWindow(display);
   cursor = XCreateFontCursor(display, XC_cross);
-  type   = XInternAtom(display, "WM_STATE", True);
+  type   = subSubtlextAtom(SUB_ATOM_WM_STATE);
 
   /* Grab pointer */
   if(XGrabPointer(display, root, False, ButtonPressMask|ButtonReleaseMask,
@@ -277,7 +426,7 @@ subSubtleSingColors(VALUE self)
 {
   int i;
   unsigned long ncolors = 0, *colors = NULL;
-  VALUE meth = Qnil, klass = Qnil, hash = Qnil;
+  VALUE hash = Qnil;
   const char *names[] = {
     "title_fg",           "title_bg",             "title_bo_top",
     "title_bo_right",     "title_bo_bottom",      "title_bo_left",
@@ -300,21 +449,17 @@ subSubtleSingColors(VALUE self)
 
   subSubtlextConnect(NULL); ///< Implicit open connection
 
-  /* Fetch data */
-  meth  = rb_intern("new");
-  klass = rb_const_get(mod, rb_intern("Color"));
-  hash  = rb_hash_new();
+  hash = rb_hash_new();
 
   /* Check result */
   if((colors = (unsigned long *)subSharedPropertyGet(display,
       DefaultRootWindow(display), XA_CARDINAL,
-      XInternAtom(display, "SUBTLE_COLORS", False), &ncolors)))
+      subSubtlextAtom(SUB_ATOM_SUBTLE_COLORS), &ncolors)))
     {
       for(i = 0; i < ncolors && i < LENGTH(names); i++)
         {
-          VALUE c = rb_funcall(klass, meth, 1, LONG2NUM(colors[i]));
-
-          rb_hash_aset(hash, CHAR2SYM(names[i]), c);
+          rb_hash_aset(hash, CHAR2SYM(names[i]),
+            subColorInstantiate(colors[i]));
         }
 
       free(colors);
@@ -343,8 +488,8 @@ subSubtleSingFont(VALUE self)
 
   /* Get results */
   if((prop = subSharedPropertyGet(display, DefaultRootWindow(display),
-      XInternAtom(display, "UTF8_STRING", False),
-      XInternAtom(display, "SUBTLE_FONT", False),
+      subSubtlextAtom(SUB_ATOM_UTF8_STRING),
+      subSubtlextAtom(SUB_ATOM_SUBTLE_FONT),
       NULL)))
     {
       font = rb_str_new2(prop);
@@ -392,4 +537,56 @@ subSubtleSingSpawn(VALUE self,
   return ret;
 } /* }}} */
 
+/* subSubtleSingSubscribe {{{ */
+/*
+ * call-seq: subscribe(*events) { |event, object| } -> nil
+ *
+ * Subscribe to hook <i>events</i> of subtle and call the block with the
+ * event and the Client, View or Tag of it, as soon as subtle sends it.
+ * This waits for events until the block returns false or subtle exits,
+ * but lets other ruby threads run meanwhile.
+ *
+ * Available events are the names of the hooks like :client_focus,
+ * :view_focus or :tag_create. Subscriptions work from external programs
+ * only, inside of subtle hooks should be used.
+ *
+ *  subtle.subscribe(:client_focus, :view_focus) do |event, object|
+ *    puts "#{event}: #{object}"
+ *  end
+ *  => nil
+ */
+
+VALUE
+subSubtleSingSubscribe(int argc,
+  VALUE *argv,
+  VALUE self)
+{
+  int i, j, fd = -1, mask = 0;
+
+  rb_need_block();
+
+  if(0 == argc) rb_raise(rb_eArgError, "No events given");
+
+  /* Translate events */
+  for(i = 0; i < argc; i++)
+    {
+      for(j = 0; LENGTH(events) > j; j++)
+        if(events[j] && CHAR2SYM(events[j]) == argv[i]) break;
+
+      if(LENGTH(events) == j)
+        rb_raise(rb_eArgError, "Unknown event `%s'",
+          RSTRING_PTR(rb_inspect(argv[i])));
+
+      mask |= (1L << j);
+    }
+
+  subSubtlextConnect(NULL); ///< Implicit open connection
+
+  if(-1 == (fd = subSubtlextSubscribe(mask)))
+    rb_raise(rb_eStandardError, "Failed subscribing to subtle");
+
+  return rb_ensure(SubtleEventLoop, INT2FIX(fd),
+    SubtleEventClose, INT2FIX(fd));
+} /* }}} */
+
 // vim:ts=2:bs=2:sw=2:et:fdm=marker
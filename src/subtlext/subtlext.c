@@ -10,9 +10,20 @@
   * See the file COPYING for details.
   **/
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE 1 ///< For struct ucred
+#endif /* _GNU_SOURCE */
+
 #include <unistd.h>
 #include <locale.h>
 #include <ctype.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/un.h>
 #include "subtlext.h"
 
 #ifdef HAVE_X11_EXTENSIONS_XTEST_H
@@ -22,6 +33,72 @@
 Display *display = NULL;
 VALUE mod = Qnil;
 
+static int rpcfd = -1, rpcsize = 0, mirrorfd = -1, mirrorsize = 0;
+static time_t rpcretry = 0;
+static char *rpcdata = NULL;
+static SubBackend rpc = { NULL };
+static SubMirror *mirror = NULL, *snapshot = NULL;
+
+/* Typedef {{{ */
+typedef struct subtlextselector_t
+{
+  int        flags, selid, ngravities;
+  Window     selwin;
+  const char *source;
+  regex_t    *preg;
+  char       **gravities;
+} SubtlextSelector;
+/* }}} */
+
+static Atom atoms[SUB_ATOM_TOTAL] = { None };
+static char *atomnames[] =
+{
+  "UTF8_STRING", "WM_STATE", "WM_WINDOW_ROLE", "_NET_ACTIVE_WINDOW",
+  "_NET_CLIENT_LIST", "_NET_CLOSE_WINDOW", "_NET_CURRENT_DESKTOP",
+  "_NET_DESKTOP_NAMES", "_NET_MOVERESIZE_WINDOW", "_NET_RESTACK_WINDOW",
+  "_NET_SUPPORTING_WM_CHECK", "_NET_WM_NAME", "_NET_WM_PID", "_NET_WM_STATE",
+  "_NET_WM_STATE_ABOVE", "_NET_WM_STATE_FULLSCREEN", "_NET_WM_STATE_STICKY",
+  "_NET_WM_STATE_TOGGLE", "_NET_WORKAREA", "SUBTLE_CLIENT_FLAGS",
+  "SUBTLE_CLIENT_GRAVITY", "SUBTLE_CLIENT_RETAG", "SUBTLE_CLIENT_SCREEN",
+  "SUBTLE_CLIENT_TAGS", "SUBTLE_COLORS", "SUBTLE_DATA", "SUBTLE_FONT",
+  "SUBTLE_GRAVITY_FLAGS", "SUBTLE_GRAVITY_KILL", "SUBTLE_GRAVITY_LIST",
+  "SUBTLE_GRAVITY_NEW", "SUBTLE_QUIT", "SUBTLE_RELOAD", "SUBTLE_RENDER",
+  "SUBTLE_RESTART", "SUBTLE_SCREEN_JUMP", "SUBTLE_SCREEN_PANELS",
+  "SUBTLE_SCREEN_VIEWS", "SUBTLE_SUBLET_DATA", "SUBTLE_SUBLET_FLAGS",
+  "SUBTLE_SUBLET_KILL", "SUBTLE_SUBLET_LIST", "SUBTLE_SUBLET_STYLE",
+  "SUBTLE_SUBLET_UPDATE", "SUBTLE_TAG_KILL", "SUBTLE_TAG_LIST",
+  "SUBTLE_TAG_NEW", "SUBTLE_TRAY_LIST", "SUBTLE_VERSION",
+  "SUBTLE_VIEW_ICONS", "SUBTLE_VIEW_KILL", "SUBTLE_VIEW_NEW",
+  "SUBTLE_VIEW_STYLE", "SUBTLE_VIEW_TAGS", "SUBTLE_VISIBLE_TAGS",
+  "SUBTLE_VISIBLE_VIEWS"
+};
+
+/* SubtlextRpcClose {{{ */
+static void
+SubtlextRpcClose(void)
+{
+  if(-1 != rpcfd)
+    {
+      close(rpcfd);
+
+      rpcfd    = -1;
+      rpcretry = time(NULL) + 1; ///< Try again when subtle is back
+    }
+
+  if(mirror)
+    {
+      munmap(mirror, mirrorsize);
+      close(mirrorfd);
+
+      mirror     = NULL;
+      mirrorfd   = -1;
+      mirrorsize = 0;
+    }
+
+  /* Fall back to X */
+  if(&rpc == subSharedBackendGet(NULL)) subSharedBackendSet(NULL);
+} /* }}} */
+
 /* SubtlextStringify {{{ */
 static void
 SubtlextStringify(char *string)
@@ -45,10 +122,15 @@ SubtlextSweep(void)
 {
   if(display)
     {
+      SubtlextRpcClose();
+      subSharedPropertyCache(display, False);
       XCloseDisplay(display);
 
       display = NULL;
     }
+
+  if(rpcdata)  free(rpcdata);
+  if(snapshot) free(snapshot);
 } /* }}} */
 
 /* SubtlextPidReader {{{ */
@@ -78,7 +160,7 @@ SubtlextPidReader(VALUE self)
 
       /* Get pid */
       if((id = (int *)subSharedPropertyGet(display, win, XA_CARDINAL,
-          XInternAtom(display, "_NET_WM_PID", False), NULL)))
+          subSubtlextAtom(SUB_ATOM_NET_WM_PID), NULL)))
         {
           pid = INT2FIX(*id);
 
@@ -235,7 +317,7 @@ SubtlextTagFind(VALUE value)
             else string = RSTRING_PTR(value);
 
             /* Find tag and get id */
-            if(-1 != (id = subSubtlextFindString("SUBTLE_TAG_LIST",
+            if(-1 != (id = subSubtlextFindString(SUB_ATOM_SUBTLE_TAG_LIST,
                 string, NULL, flags)))
               tags |= (1L << (id + 1));
           }
@@ -297,7 +379,10 @@ SubtlextTag(VALUE self,
   /* Get and update tag mask */
   if(0 != action)
     {
-      int tags = FIX2INT(rb_iv_get(self, "@tags"));
+      int tags = 0;
+
+      subClientLoad(self, SUB_CLIENT_TAGS);
+      tags = FIX2INT(rb_iv_get(self, "@tags"));
 
       /* Update masks */
       if(1 == action)       data.l[1] = tags |  data.l[1];
@@ -333,6 +418,9 @@ SubtlextTag(VALUE self,
  *
  * Set or remove all tags at once
  *
+ * Inside of subtle the change is applied after the running hook or sublet
+ * callback returned.
+ *
  *  # Set new tags
  *  object.tags=([ #<Subtlext::Tag:xxx>, #<Subtlext::Tag:xxx> ])
  *  => nil
@@ -373,11 +461,12 @@ SubtlextTagReader(VALUE self)
   /* Fetch data */
   method     = rb_intern("new");
   klass      = rb_const_get(mod, rb_intern("Tag"));
+  subClientLoad(self, SUB_CLIENT_TAGS);
   value_tags = FIX2INT(rb_iv_get(self, "@tags"));
 
   /* Check results */
   if((tags = subSharedPropertyGetStrings(display, ROOT,
-      XInternAtom(display, "SUBTLE_TAG_LIST", False), &ntags)))
+      subSubtlextAtom(SUB_ATOM_SUBTLE_TAG_LIST), &ntags)))
     {
       for(i = 0; i < ntags; i++)
         {
@@ -470,6 +559,8 @@ SubtlextTagAsk(VALUE self,
       VALUE id = Qnil, tags = Qnil;
 
       /* Get properties */
+      subClientLoad(self, SUB_CLIENT_TAGS);
+
       id   = rb_iv_get(tag,  "@id");
       tags = rb_iv_get(self, "@tags");
 
@@ -724,6 +815,9 @@ SubtlextSendKey(int argc,
  *
  * Set focus to window
  *
+ * Inside of subtle the change is applied after the running hook or sublet
+ * callback returned.
+ *
  *  object.focus
  *  => nil
  */
@@ -771,7 +865,7 @@ SubtlextAskFocus(VALUE self)
 
   /* Fetch data */
   if((focus = (unsigned long *)subSharedPropertyGet(display, ROOT,
-      XA_WINDOW, XInternAtom(display, "_NET_ACTIVE_WINDOW", False), NULL)))
+      XA_WINDOW, subSubtlextAtom(SUB_ATOM_NET_ACTIVE_WINDOW), NULL)))
     {
       if(*focus == NUM2LONG(win)) ret = Qtrue;
 
@@ -844,8 +938,9 @@ SubtlextPropReader(VALUE self,
         }
 
       /* Get actual property */
-      if((result = subSharedPropertyGet(display, win, XInternAtom(display,
-          "UTF8_STRING", False), XInternAtom(display, propname, False), NULL)))
+      if((result = subSharedPropertyGet(display, win,
+          subSubtlextAtom(SUB_ATOM_UTF8_STRING),
+          XInternAtom(display, propname, False), NULL)))
         {
           ret = rb_str_new2(result);
 
@@ -925,7 +1020,7 @@ SubtlextPropWriter(VALUE self,
       case T_SYMBOL: str = rb_sym_to_s(value);
       case T_STRING:
         XChangeProperty(display, win, XInternAtom(display, propname, False),
-          XInternAtom(display, "UTF8_STRING", False), 8, PropModeReplace,
+          subSubtlextAtom(SUB_ATOM_UTF8_STRING), 8, PropModeReplace,
           (unsigned char *)RSTRING_PTR(str), RSTRING_LEN(str));
         break;
       case T_NIL:
@@ -1072,24 +1167,6 @@ SubtlextEqualSpaceWindow(VALUE self,
   return SubtlextSpaceship(self, other, "@win");
 } /* }}} */
 
-/* SubtlextEqualSpacePixel {{{ */
-/*
- * call-seq: <=>(other) -> -1, 0 or 1
- *
- * Whether both objects have the same value. Returns -1, 0 or 1 when self is
- * less than, equal to or grater than other. (based on pixel)
- *
- *  object1 <=> object2
- *  => 0
- */
-
-static VALUE
-SubtlextEqualSpacePixel(VALUE self,
-  VALUE other)
-{
-  return SubtlextSpaceship(self, other, "@pixel");
-} /* }}} */
-
 /* SubtlextEqualSpacePixmap {{{ */
 /*
  * call-seq: <=>(other) -> -1, 0 or 1
@@ -1126,132 +1203,770 @@ SubtlextEqualSpaceId(VALUE self,
   return SubtlextSpaceship(self, other, "@id");
 } /* }}} */
 
-/* SubtlextWindowMatch {{{ */
-static int
-SubtlextWindowMatch(Window win,
-  regex_t *preg,
-  const char *source,
-  char **name,
+/* SubtlextSelectorInit {{{ */
+static void
+SubtlextSelectorInit(SubtlextSelector *sel,
+  char *source,
   int flags)
 {
-  int ret = False;
-  char *wminstance = NULL, *wmclass = NULL;
+  VALUE win = Qnil;
+
+  sel->flags      = flags;
+  sel->selid      = -1;
+  sel->selwin     = None;
+  sel->source     = source;
+  sel->preg       = NULL;
+  sel->gravities  = NULL;
+  sel->ngravities = 0;
+
+  /* Create regexp when required */
+  if(!(flags & SUB_MATCH_EXACT)) sel->preg = subSharedRegexNew(source);
+
+  /* Special values */
+  if(isdigit(source[0])) sel->selid = atoi(source);
+  if('#' == source[0] && FIXNUM_P(win = subSubtleSingSelect(Qnil)))
+    sel->selwin = NUM2LONG(win);
+
+  /* Fetch root lists once per query */
+  if(flags & SUB_MATCH_GRAVITY)
+    sel->gravities = subSharedPropertyGetStrings(display, ROOT,
+      subSubtlextAtom(SUB_ATOM_SUBTLE_GRAVITY_LIST), &sel->ngravities);
+} /* }}} */
+
+/* SubtlextSelectorString {{{ */
+static int
+SubtlextSelectorString(SubtlextSelector *sel,
+  const char *str)
+{
+  if(!str) return False;
+
+  return sel->flags & SUB_MATCH_EXACT ? 0 == strcmp(sel->source, str) :
+    (sel->preg && subSharedRegexMatch(sel->preg, (char *)str));
+} /* }}} */
+
+/* SubtlextSelectorFetch {{{ */
+static void
+SubtlextSelectorFetch(SubtlextSelector *sel,
+  Window win,
+  SubBackendClient *rec)
+{
+  rec->win     = win;
+  rec->gravity = -1;
+
+  /* Fetch only properties required by the match flags */
+  if(sel->flags & (SUB_MATCH_INSTANCE|SUB_MATCH_CLASS))
+    subSharedPropertyClass(display, win, &rec->instance, &rec->klass);
+
+  if(sel->flags & SUB_MATCH_NAME)
+    subSharedPropertyName(display, win, &rec->name, "subtle");
 
-  /* Fetch when needed */
-  if(name || flags & (SUB_MATCH_INSTANCE|SUB_MATCH_CLASS))
-    subSharedPropertyClass(display, win, &wminstance, &wmclass);
+  if(sel->flags & SUB_MATCH_ROLE)
+    rec->role = subSharedPropertyGet(display, win, XA_STRING,
+      subSubtlextAtom(SUB_ATOM_WM_WINDOW_ROLE), NULL);
 
-  /* Check window WM_NAME */
-  if(!ret && flags & SUB_MATCH_NAME)
+  if(sel->flags & SUB_MATCH_GRAVITY)
     {
-      char *wmname = NULL;
+      int *gravity = NULL;
 
-      subSharedPropertyName(display, win, &wmname, "subtle");
+      if((gravity = (int *)subSharedPropertyGet(display, win, XA_CARDINAL,
+          subSubtlextAtom(SUB_ATOM_SUBTLE_CLIENT_GRAVITY), NULL)))
+        {
+          rec->gravity = *gravity;
+
+          free(gravity);
+        }
+    }
+} /* }}} */
+
+/* SubtlextSelectorRelease {{{ */
+static void
+SubtlextSelectorRelease(SubBackendClient *rec)
+{
+  if(rec->name)     free(rec->name);
+  if(rec->instance) free(rec->instance);
+  if(rec->klass)    free(rec->klass);
+  if(rec->role)     free(rec->role);
+} /* }}} */
+
+/* SubtlextSelectorMatch {{{ */
+static int
+SubtlextSelectorMatch(SubtlextSelector *sel,
+  int idx,
+  SubBackendClient *rec)
+{
+  int ret = False;
 
-      if(wmname)
+  /* Check special values */
+  if(sel->selid == idx || sel->selid == (int)rec->win ||
+      (None != sel->selwin && sel->selwin == rec->win))
+    return True;
+  else if(-1 != sel->selid) return False;
+
+  /* Check fetched values */
+  if(sel->flags & SUB_MATCH_NAME)
+    ret = SubtlextSelectorString(sel, rec->name);
+  if(!ret && sel->flags & SUB_MATCH_INSTANCE)
+    ret = SubtlextSelectorString(sel, rec->instance);
+  if(!ret && sel->flags & SUB_MATCH_CLASS)
+    ret = SubtlextSelectorString(sel, rec->klass);
+  if(!ret && sel->flags & SUB_MATCH_ROLE)
+    ret = SubtlextSelectorString(sel, rec->role);
+  if(!ret && sel->flags & SUB_MATCH_GRAVITY && sel->gravities &&
+      0 <= rec->gravity && rec->gravity < sel->ngravities)
+    ret = SubtlextSelectorString(sel, sel->gravities[rec->gravity]);
+
+  /* Pid is only known to X */
+  if(!ret && sel->flags & SUB_MATCH_PID)
+    {
+      int *pid = NULL;
+
+      if((pid = (int *)subSharedPropertyGet(display, rec->win, XA_CARDINAL,
+          subSubtlextAtom(SUB_ATOM_NET_WM_PID), NULL)))
         {
-          ret = (flags & SUB_MATCH_EXACT ? 0 == strcmp(source, wmname) :
-            subSharedRegexMatch(preg, wmname));
+          char pidbuf[10] = { 0 };
+
+          snprintf(pidbuf, sizeof(pidbuf), "%d", (int)*pid);
+
+          ret = SubtlextSelectorString(sel, pidbuf);
 
-          free(wmname);
+          free(pid);
         }
     }
 
-  /* Check window WM_CLASS */
-  if(!ret && flags & (SUB_MATCH_INSTANCE|SUB_MATCH_CLASS))
+  return ret;
+} /* }}} */
+
+/* SubtlextSelectorFinish {{{ */
+static void
+SubtlextSelectorFinish(SubtlextSelector *sel)
+{
+  if(sel->preg)      subSharedRegexKill(sel->preg);
+  if(sel->gravities) XFreeStringList(sel->gravities);
+} /* }}} */
+
+/* SubtlextRpcCall {{{ */
+static int
+SubtlextRpcCall(int type,
+  const void *payload,
+  int len)
+{
+  char req[sizeof(SubRpcHeader) + RPCSIZE];
+  SubRpcHeader head = { 0 };
+
+  if(-1 == rpcfd || RPCSIZE < len) return -1;
+
+  /* Send request in one go */
+  head.type = type;
+  head.len  = len;
+
+  memcpy(req, &head, sizeof(SubRpcHeader));
+  if(0 < len) memcpy(req + sizeof(SubRpcHeader), payload, len);
+
+  if((ssize_t)(sizeof(SubRpcHeader) + len) != send(rpcfd, req,
+      sizeof(SubRpcHeader) + len, MSG_NOSIGNAL) ||
+      (ssize_t)sizeof(SubRpcHeader) != recv(rpcfd, &head,
+      sizeof(SubRpcHeader), MSG_WAITALL) || 0 > head.len)
+    {
+      SubtlextRpcClose();
+
+      return -1;
+    }
+
+  /* Read response */
+  if(head.len > rpcsize)
+    {
+      rpcsize = head.len;
+      rpcdata = (char *)subSharedMemoryRealloc(rpcdata, rpcsize);
+    }
+
+  if(0 < head.len && head.len != recv(rpcfd, rpcdata, head.len, MSG_WAITALL))
     {
-      /* Check instance */
-      if(wminstance && flags & SUB_MATCH_INSTANCE)
+      SubtlextRpcClose();
+
+      return -1;
+    }
+
+  return 0 == head.type ? head.len : -1;
+} /* }}} */
+
+/* SubtlextRpcWait {{{ */
+static int
+SubtlextRpcWait(int fd,
+  char *data,
+  int len)
+{
+  ssize_t got = 0;
+
+  /* Read in pieces without blocking other ruby threads */
+  while(0 < len)
+    {
+      if(0 < (got = recv(fd, data, len, MSG_DONTWAIT)))
         {
-          ret = (flags & SUB_MATCH_EXACT ?
-            0 == strcmp(source, wminstance) :
-            subSharedRegexMatch(preg, wminstance));
+          data += got;
+          len  -= got;
         }
+      else if(-1 == got && (EAGAIN == errno || EWOULDBLOCK == errno))
+        rb_thread_wait_fd(fd);
+      else if(-1 != got || EINTR != errno) return False;
+    }
 
-      /* Check class */
-      if(!ret && wmclass && flags & SUB_MATCH_CLASS)
+  return True;
+} /* }}} */
+
+/* SubtlextRpcInt {{{ */
+static int
+SubtlextRpcInt(char **pos,
+  char *end,
+  int *value)
+{
+  if((int)sizeof(int) > end - *pos) return False;
+
+  memcpy(value, *pos, sizeof(int));
+  *pos += sizeof(int);
+
+  return True;
+} /* }}} */
+
+/* SubtlextRpcString {{{ */
+static int
+SubtlextRpcString(char **pos,
+  char *end,
+  char **str)
+{
+  int len = 0;
+
+  if(!SubtlextRpcInt(pos, end, &len) || 0 > len || len > end - *pos ||
+      (0 < len && '\0' != (*pos)[len - 1]))
+    return False;
+
+  /* Borrow string from response buffer */
+  *str  = 0 < len ? *pos : NULL;
+  *pos += len;
+
+  return True;
+} /* }}} */
+
+/* SubtlextRpcRecord {{{ */
+static int
+SubtlextRpcRecord(char **pos,
+  char *end,
+  SubBackendClient *rec)
+{
+  int win = 0, geom[4] = { 0 };
+
+  if(!SubtlextRpcInt(pos, end, &win) ||
+      !SubtlextRpcInt(pos, end, &rec->flags) ||
+      !SubtlextRpcInt(pos, end, &rec->tags) ||
+      !SubtlextRpcInt(pos, end, &rec->gravity) ||
+      !SubtlextRpcInt(pos, end, &geom[0]) ||
+      !SubtlextRpcInt(pos, end, &geom[1]) ||
+      !SubtlextRpcInt(pos, end, &geom[2]) ||
+      !SubtlextRpcInt(pos, end, &geom[3]) ||
+      !SubtlextRpcString(pos, end, &rec->name) ||
+      !SubtlextRpcString(pos, end, &rec->instance) ||
+      !SubtlextRpcString(pos, end, &rec->klass) ||
+      !SubtlextRpcString(pos, end, &rec->role))
+    return False;
+
+  rec->win         = (Window)win;
+  rec->geom.x      = geom[0];
+  rec->geom.y      = geom[1];
+  rec->geom.width  = geom[2];
+  rec->geom.height = geom[3];
+
+  return True;
+} /* }}} */
+
+/* SubtlextRpcRecords {{{ */
+static int
+SubtlextRpcRecords(char *pos,
+  char *end,
+  SubBackendClient **recs)
+{
+  int i, nclients = 0;
+
+  if(!SubtlextRpcInt(&pos, end, &nclients) || 0 > nclients) return -1;
+
+  *recs = (SubBackendClient *)subSharedMemoryAlloc(
+    0 < nclients ? nclients : 1, sizeof(SubBackendClient));
+
+  for(i = 0; i < nclients; i++)
+    {
+      if(!SubtlextRpcRecord(&pos, end, &(*recs)[i]))
         {
-          ret = (flags & SUB_MATCH_EXACT ?
-            0 == strcmp(source, wmclass) :
-            subSharedRegexMatch(preg, wmclass));
+          free(*recs);
+          *recs = NULL;
 
-          free(wmclass);
+          return -1;
         }
     }
 
-  /* Check window role */
-  if(!ret && flags & SUB_MATCH_ROLE)
+  return nclients;
+} /* }}} */
+
+/* SubtlextRpcList {{{ */
+static int
+SubtlextRpcList(SubBackendClient **recs)
+{
+  int len = 0;
+
+  if(-1 == (len = SubtlextRpcCall(SUB_RPC_LIST, NULL, 0))) return -1;
+
+  return SubtlextRpcRecords(rpcdata, rpcdata + len, recs);
+} /* }}} */
+
+/* SubtlextRpcCurrent {{{ */
+static Window
+SubtlextRpcCurrent(void)
+{
+  int len = 0, win = None;
+  char *pos = NULL;
+
+  if(-1 == (len = SubtlextRpcCall(SUB_RPC_CURRENT, NULL, 0))) return None;
+
+  pos = rpcdata;
+
+  return SubtlextRpcInt(&pos, rpcdata + len, &win) ? (Window)win : None;
+} /* }}} */
+
+/* SubtlextRpcClient {{{ */
+static int
+SubtlextRpcClient(Window win,
+  SubBackendClient *rec)
+{
+  int len = 0, id = (int)win;
+  char *pos = NULL;
+
+  /* Empty response for unknown clients */
+  if(0 >= (len = SubtlextRpcCall(SUB_RPC_CLIENT, &id, sizeof(int))))
+    return False;
+
+  pos = rpcdata;
+
+  return SubtlextRpcRecord(&pos, rpcdata + len, rec);
+} /* }}} */
+
+/* SubtlextRpcView {{{ */
+static int
+SubtlextRpcView(char **name)
+{
+  int len = 0, id = -1;
+  char *pos = NULL, *end = NULL;
+
+  if(-1 == (len = SubtlextRpcCall(SUB_RPC_VIEW, NULL, 0))) return -1;
+
+  pos = rpcdata;
+  end = rpcdata + len;
+
+  if(!SubtlextRpcInt(&pos, end, &id) || -1 == id ||
+      !SubtlextRpcString(&pos, end, name) || !*name)
+    return -1;
+
+  return id;
+} /* }}} */
+
+/* SubtlextRpcMessage {{{ */
+static int
+SubtlextRpcMessage(Window win,
+  char *type,
+  SubMessageData data)
+{
+  int len = 0, id = (int)win;
+  char payload[RPCSIZE];
+
+  /* Payload: window, data and terminated type */
+  len = sizeof(int) + sizeof(SubMessageData) + strlen(type) + 1;
+  if(RPCSIZE < len) return False;
+
+  memcpy(payload, &id, sizeof(int));
+  memcpy(payload + sizeof(int), &data, sizeof(SubMessageData));
+  memcpy(payload + sizeof(int) + sizeof(SubMessageData),
+    type, strlen(type) + 1);
+
+  return -1 != SubtlextRpcCall(SUB_RPC_MESSAGE, payload, len);
+} /* }}} */
+
+/* SubtlextMirrorMap {{{ */
+static int
+SubtlextMirrorMap(int size)
+{
+  struct stat st;
+
+  if(mirror) munmap(mirror, mirrorsize);
+
+  /* Never map beyond the end of the file */
+  if(-1 == fstat(mirrorfd, &st) || (int)sizeof(SubMirror) > st.st_size)
+    {
+      mirror     = NULL;
+      mirrorsize = 0;
+
+      return False;
+    }
+
+  if(size > st.st_size) size = st.st_size;
+
+  if(MAP_FAILED == (mirror = (SubMirror *)mmap(NULL, size, PROT_READ,
+      MAP_SHARED, mirrorfd, 0)))
     {
-      char *role = NULL;
+      mirror     = NULL;
+      mirrorsize = 0;
 
-      if((role = subSharedPropertyGet(display, win, XA_STRING,
-          XInternAtom(display, "WM_WINDOW_ROLE", False), NULL)))
-        {
-          ret = (flags & SUB_MATCH_EXACT ? 0 == strcmp(source, role) :
-            subSharedRegexMatch(preg, role));
+      return False;
+    }
 
-          free(role);
-        }
-     }
+  mirrorsize = size;
+
+  return True;
+} /* }}} */
+
+/* SubtlextMirrorAlive {{{ */
+static int
+SubtlextMirrorAlive(void)
+{
+  struct stat st;
+  struct pollfd pfd;
+
+  /* Closed or already replaced by subtle */
+  if(((volatile SubMirror *)mirror)->flags & SUB_MIRROR_CLOSED ||
+      -1 == fstat(mirrorfd, &st) || 0 == st.st_nlink)
+    return False;
 
-  /* Check window gravity */
-  if(!ret && flags & SUB_MATCH_GRAVITY)
+  /* Idle connection only becomes readable when subtle is gone */
+  pfd.fd     = rpcfd;
+  pfd.events = POLLIN;
+
+  return 0 == poll(&pfd, 1, 0);
+} /* }}} */
+
+/* SubtlextMirrorRead {{{ */
+static SubMirror *
+SubtlextMirrorRead(void)
+{
+  int i, len = 0;
+  unsigned int seq = 0;
+  volatile SubMirror *m = NULL;
+
+  /* Don't report state of a gone subtle, fall back to X */
+  if(mirror && !SubtlextMirrorAlive()) SubtlextRpcClose();
+
+  /* Copy a consistent snapshot, writers are never blocked */
+  for(i = 0; mirror && i < 100; i++)
     {
-      int *gravity = NULL, ngravities = 0;
-      char **gravities = NULL;
+      m   = mirror;
+      seq = m->seq;
+
+      /* Reuse copy of unchanged state */
+      if(snapshot && seq == snapshot->seq) return snapshot;
+      if(seq & 1) continue; ///< Writer active
 
-      /* Fetch gravities */
-      gravities = subSharedPropertyGetStrings(display,
-        ROOT, XInternAtom(display, "SUBTLE_GRAVITY_LIST",
-        False), &ngravities);
-      gravity = (int *)subSharedPropertyGet(display, win,
-        XA_CARDINAL, XInternAtom(display, "SUBTLE_CLIENT_GRAVITY",
-        False), NULL);
+      __sync_synchronize();
+      len = m->len;
 
-      /* Finally compare gravities */
-      if(gravities && gravity && 0 <= *gravity && *gravity < ngravities)
+      /* Remap when segment grew, give up when the file is smaller */
+      if(0 > len || (int)sizeof(SubMirror) + len > mirrorsize)
         {
-          ret = (flags & SUB_MATCH_EXACT ?
-            0 == strcmp(source, gravities[*gravity]) :
-            subSharedRegexMatch(preg, gravities[*gravity]));
+          int size = m->size;
+
+          if(size <= mirrorsize || !SubtlextMirrorMap(size) ||
+              mirrorsize < size)
+            break;
+
+          continue;
         }
 
-      if(gravities) XFreeStringList(gravities);
-      if(gravity)   free(gravity);
+      snapshot = (SubMirror *)subSharedMemoryRealloc(snapshot,
+        sizeof(SubMirror) + len);
+      memcpy(snapshot, (void *)m, sizeof(SubMirror) + len);
+
+      __sync_synchronize();
+      if(seq == m->seq)
+        {
+          snapshot->len = len;
+
+          return snapshot;
+        }
     }
 
-  /* Check window pid */
-  if(!ret && flags & SUB_MATCH_PID)
+  if(snapshot) free(snapshot);
+  snapshot = NULL;
+
+  return NULL;
+} /* }}} */
+
+/* SubtlextMirrorSection {{{ */
+static int
+SubtlextMirrorSection(int section,
+  char **pos,
+  char **end)
+{
+  SubMirror *m = NULL;
+
+  if(!(m = SubtlextMirrorRead()) || 0 > m->sections[section] ||
+      m->len < m->sections[section])
+    return False;
+
+  *pos = (char *)m + sizeof(SubMirror) + m->sections[section];
+  *end = (char *)m + sizeof(SubMirror) + m->len;
+
+  return True;
+} /* }}} */
+
+/* SubtlextMirrorList {{{ */
+static int
+SubtlextMirrorList(SubBackendClient **recs)
+{
+  char *pos = NULL, *end = NULL;
+
+  if(!SubtlextMirrorSection(SUB_MIRROR_CLIENTS, &pos, &end))
+    return SubtlextRpcList(recs);
+
+  return SubtlextRpcRecords(pos, end, recs);
+} /* }}} */
+
+/* SubtlextMirrorCurrent {{{ */
+static Window
+SubtlextMirrorCurrent(void)
+{
+  int nhistory = 0, win = None;
+  char *pos = NULL, *end = NULL;
+
+  if(!SubtlextMirrorSection(SUB_MIRROR_HISTORY, &pos, &end))
+    return SubtlextRpcCurrent();
+
+  if(!SubtlextRpcInt(&pos, end, &nhistory) || 0 >= nhistory ||
+      !SubtlextRpcInt(&pos, end, &win))
+    return None;
+
+  return (Window)win;
+} /* }}} */
+
+/* SubtlextMirrorClient {{{ */
+static int
+SubtlextMirrorClient(Window win,
+  SubBackendClient *rec)
+{
+  int i, nclients = 0;
+  char *pos = NULL, *end = NULL;
+
+  if(!SubtlextMirrorSection(SUB_MIRROR_CLIENTS, &pos, &end))
+    return SubtlextRpcClient(win, rec);
+
+  if(!SubtlextRpcInt(&pos, end, &nclients)) return False;
+
+  for(i = 0; i < nclients; i++)
     {
-      int *pid = NULL;
+      if(!SubtlextRpcRecord(&pos, end, rec)) return False;
+      if(rec->win == win) return True;
+    }
 
-      /* Fetch pid from window */
-      if((pid = (int *)subSharedPropertyGet(display, win, XA_CARDINAL,
-          XInternAtom(display, "_NET_WM_PID", False), NULL)))
+  return False;
+} /* }}} */
+
+/* SubtlextMirrorViews {{{ */
+static int
+SubtlextMirrorViews(char ***names,
+  int **tags)
+{
+  int i, nviews = 0;
+  char *pos = NULL, *end = NULL;
+
+  if(!SubtlextMirrorSection(SUB_MIRROR_VIEWS, &pos, &end) ||
+      !SubtlextRpcInt(&pos, end, &nviews) || 0 > nviews)
+    return -1;
+
+  *names = (char **)subSharedMemoryAlloc(0 < nviews ? nviews : 1,
+    sizeof(char *));
+  *tags  = (int *)subSharedMemoryAlloc(0 < nviews ? nviews : 1,
+    sizeof(int));
+
+  for(i = 0; i < nviews; i++)
+    {
+      if(!SubtlextRpcString(&pos, end, &(*names)[i]) || !(*names)[i] ||
+          !SubtlextRpcInt(&pos, end, &(*tags)[i]))
         {
-          char pidbuf[10] = { 0 };
+          free(*names);
+          free(*tags);
 
-          /* Convert pid to string */
-          snprintf(pidbuf, sizeof(pidbuf), "%d", (int)*pid);
+          return -1;
+        }
+    }
 
-          ret = (flags & SUB_MATCH_EXACT ? 0 == strcmp(source, pidbuf) :
-            subSharedRegexMatch(preg, pidbuf));
+  return nviews;
+} /* }}} */
 
-          free(pid);
+/* SubtlextMirrorView {{{ */
+static int
+SubtlextMirrorView(char **name)
+{
+  int id = -1, nviews = 0, *tags = NULL;
+  char *pos = NULL, *end = NULL, **names = NULL;
+
+  if(!SubtlextMirrorSection(SUB_MIRROR_VIEW, &pos, &end))
+    return SubtlextRpcView(name);
+
+  /* Look up name of current view */
+  if(!SubtlextRpcInt(&pos, end, &id) || -1 == id ||
+      -1 == (nviews = SubtlextMirrorViews(&names, &tags)))
+    return -1;
+
+  if(id < nviews) *name = names[id];
+  else id = -1;
+
+  free(names);
+  free(tags);
+
+  return id;
+} /* }}} */
+
+/* SubtlextMirrorTags {{{ */
+static int
+SubtlextMirrorTags(char ***names)
+{
+  int i, ntags = 0;
+  char *pos = NULL, *end = NULL;
+
+  if(!SubtlextMirrorSection(SUB_MIRROR_TAGS, &pos, &end) ||
+      !SubtlextRpcInt(&pos, end, &ntags) || 0 > ntags)
+    return -1;
+
+  *names = (char **)subSharedMemoryAlloc(0 < ntags ? ntags : 1,
+    sizeof(char *));
+
+  for(i = 0; i < ntags; i++)
+    {
+      if(!SubtlextRpcString(&pos, end, &(*names)[i]) || !(*names)[i])
+        {
+          free(*names);
+
+          return -1;
         }
     }
 
-  /* Copy instance name */
-  if(ret && name)
+  return ntags;
+} /* }}} */
+
+/* SubtlextMirrorGeneration {{{ */
+static unsigned int
+SubtlextMirrorGeneration(void)
+{
+  SubMirror *m = SubtlextMirrorRead();
+
+  return m ? m->generation : 0;
+} /* }}} */
+
+/* SubtlextMirrorOpen {{{ */
+static int
+SubtlextMirrorOpen(void)
+{
+  char path[sizeof(((struct sockaddr_un *)0)->sun_path)] = { 0 };
+  struct stat st;
+
+  /* Map state mirror of subtle read-only */
+  if(!subSharedRuntimePath(DisplayString(display), "state",
+      path, sizeof(path), False) ||
+      -1 == (mirrorfd = open(path, O_RDONLY|O_NOFOLLOW)))
+    return False;
+
+  fcntl(mirrorfd, F_SETFD, FD_CLOEXEC);
+
+  /* Only trust a private regular file of the user */
+  if(-1 == fstat(mirrorfd, &st) || !S_ISREG(st.st_mode) ||
+      st.st_uid != getuid() ||
+      (S_IRUSR|S_IWUSR) != (st.st_mode & (S_IRWXU|S_IRWXG|S_IRWXO)) ||
+      (int)sizeof(SubMirror) > st.st_size || !SubtlextMirrorMap(st.st_size))
+    {
+      close(mirrorfd);
+      mirrorfd = -1;
+
+      return False;
+    }
+
+  return True;
+} /* }}} */
+
+/* SubtlextRpcPeer {{{ */
+static int
+SubtlextRpcPeer(int fd)
+{
+#ifdef SO_PEERCRED
+  struct ucred cred;
+  socklen_t len = sizeof(cred);
+
+  /* Check user of the listening process */
+  return 0 == getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cred, &len) &&
+    cred.uid == getuid();
+#else /* SO_PEERCRED */
+  uid_t uid;
+  gid_t gid;
+
+  return 0 == getpeereid(fd, &uid, &gid) && uid == getuid();
+#endif /* SO_PEERCRED */
+} /* }}} */
+
+/* SubtlextRpcSocket {{{ */
+static int
+SubtlextRpcSocket(void)
+{
+  int fd = -1;
+  struct sockaddr_un addr = { 0 };
+
+  /* Connect to RPC socket of subtle */
+  addr.sun_family = AF_UNIX;
+
+  if(!subSharedRuntimePath(DisplayString(display), "rpc",
+      addr.sun_path, sizeof(addr.sun_path), False) ||
+      -1 == (fd = socket(AF_UNIX, SOCK_STREAM, 0)))
+    return -1;
+
+  if(-1 == connect(fd, (struct sockaddr *)&addr, sizeof(addr)))
+    {
+      close(fd);
+
+      return -1;
+    }
+
+  /* Only talk to subtle of the same user */
+  if(!SubtlextRpcPeer(fd))
     {
-      *name = (char *)subSharedMemoryAlloc(
-        strlen(wminstance) + 1, sizeof(char));
-      strncpy(*name, wminstance, strlen(wminstance));
+      close(fd);
+
+      return -1;
     }
 
-  if(wminstance) free(wminstance);
+  fcntl(fd, F_SETFD, FD_CLOEXEC);
 
-  return ret;
+  return fd;
+} /* }}} */
+
+/* SubtlextRpcConnect {{{ */
+static void
+SubtlextRpcConnect(void)
+{
+  if(-1 == (rpcfd = SubtlextRpcSocket())) return;
+
+  /* Install backend, prefer mirror for queries */
+  rpc.display = DisplayString(display);
+  rpc.message = SubtlextRpcMessage;
+
+  if(SubtlextMirrorOpen())
+    {
+      rpc.list       = SubtlextMirrorList;
+      rpc.current    = SubtlextMirrorCurrent;
+      rpc.client     = SubtlextMirrorClient;
+      rpc.view       = SubtlextMirrorView;
+      rpc.tags       = SubtlextMirrorTags;
+      rpc.views      = SubtlextMirrorViews;
+      rpc.generation = SubtlextMirrorGeneration;
+    }
+  else
+    {
+      rpc.list    = SubtlextRpcList;
+      rpc.current = SubtlextRpcCurrent;
+      rpc.client  = SubtlextRpcClient;
+      rpc.view    = SubtlextRpcView;
+    }
+
+  subSharedBackendSet(&rpc);
 } /* }}} */
 
 /* Exported */
@@ -1274,9 +1989,115 @@ subSubtlextConnect(char *display_string)
 
       if(!setlocale(LC_CTYPE, "")) XSupportsLocale();
 
+      /* Intern all atoms in one round trip */
+      assert(SUB_ATOM_TOTAL == LENGTH(atomnames));
+      XInternAtoms(display, atomnames, SUB_ATOM_TOTAL, False, atoms);
+
+      /* Prefer RPC socket unless running inside of subtle */
+      if(!subSharedBackendGet(NULL)) SubtlextRpcConnect();
+
       /* Register sweeper */
       atexit(SubtlextSweep);
     }
+  else if(rpcretry && rpcretry <= time(NULL) && !subSharedBackendGet(NULL))
+    {
+      /* Reconnect to restarted subtle */
+      SubtlextRpcConnect();
+
+      rpcretry = -1 == rpcfd ? time(NULL) + 1 : 0;
+    }
+} /* }}} */
+
+ /** subSubtlextAtom {{{
+  * @brief Get atom from the table interned at connect
+  * @param[in]  a  A #SubAtom
+  * @return Returns the desired #Atom
+  **/
+
+Atom
+subSubtlextAtom(SubAtom a)
+{
+  assert(display && a < SUB_ATOM_TOTAL);
+
+  return atoms[a];
+} /* }}} */
+
+ /** subSubtlextSubscribe {{{
+  * @brief Open own RPC connection and subscribe to events
+  * @param[in]  mask  Mask of event slots
+  * @return Returns the connection or \p -1
+  **/
+
+int
+subSubtlextSubscribe(int mask)
+{
+  int fd = -1;
+  char req[sizeof(SubRpcHeader) + sizeof(int)];
+  SubRpcHeader head = { 0 };
+  SubBackend *b = subSharedBackendGet(NULL);
+
+  /* Hooks are the way to go inside of subtle */
+  if((b && &rpc != b) || -1 == (fd = SubtlextRpcSocket())) return -1;
+
+  /* Send request and wait for acknowledge */
+  head.type = SUB_RPC_SUBSCRIBE;
+  head.len  = sizeof(int);
+
+  memcpy(req, &head, sizeof(SubRpcHeader));
+  memcpy(req + sizeof(SubRpcHeader), &mask, sizeof(int));
+
+  if((ssize_t)sizeof(req) != send(fd, req, sizeof(req), MSG_NOSIGNAL) ||
+      (ssize_t)sizeof(SubRpcHeader) != recv(fd, &head,
+      sizeof(SubRpcHeader), MSG_WAITALL) || 0 != head.type)
+    {
+      close(fd);
+
+      return -1;
+    }
+
+  return fd;
+} /* }}} */
+
+ /** subSubtlextEvent {{{
+  * @brief Read next event of subscription
+  * @warning Name must be free'd
+  * @param[in]     fd    Connection of subscription
+  * @param[inout]  slot  Event slot
+  * @param[inout]  id    Window or id of object
+  * @param[inout]  name  Name of object or \p NULL
+  * @retval  True   Event was read
+  * @retval  False  Connection is broken
+  **/
+
+int
+subSubtlextEvent(int fd,
+  int *slot,
+  int *id,
+  char **name)
+{
+  int ret = False;
+  char *data = NULL, *pos = NULL, *str = NULL;
+  SubRpcHeader head = { 0 };
+
+  /* Wait for complete event */
+  if(!SubtlextRpcWait(fd, (char *)&head, sizeof(SubRpcHeader)) ||
+      SUB_RPC_EVENT != head.type || 0 >= head.len)
+    return False;
+
+  pos = data = (char *)subSharedMemoryAlloc(head.len, sizeof(char));
+
+  if(SubtlextRpcWait(fd, data, head.len) &&
+      SubtlextRpcInt(&pos, data + head.len, slot) &&
+      SubtlextRpcInt(&pos, data + head.len, id) &&
+      SubtlextRpcString(&pos, data + head.len, &str))
+    {
+      *name = str ? strdup(str) : NULL;
+      ret   = True;
+    }
+
+  free(data);
+
+  return ret;
 } /* }}} */
 
   /** subSubtlextBacktrace {{{
@@ -1460,23 +2281,23 @@ subSubtlextManyToOne(VALUE value)
 
  /** subSubtlextWindowList {{{
   * @brief Get property window list
-  * @param[in]  prop_name  Property name
+  * @param[in]  prop       Property atom
   * @param[inout]  size  List length
   * @return Property list
   **/
 
 Window *
-subSubtlextWindowList(char *prop_name,
+subSubtlextWindowList(SubAtom prop,
   int *size)
 {
   Window *wins = NULL;
   unsigned long len = 0;
 
-  assert(prop_name && size);
+  assert(size);
 
   /* Get property list */
   if((wins = (Window *)subSharedPropertyGet(display, ROOT,
-      XA_WINDOW, XInternAtom(display, prop_name, False), &len)))
+      XA_WINDOW, subSubtlextAtom(prop), &len)))
     {
       if(size) *size = len;
     }
@@ -1487,7 +2308,7 @@ subSubtlextWindowList(char *prop_name,
 
  /** subSubtlextFindString {{{
   * @brief Find string in property list
-  * @param[in]     prop_name  Property name
+  * @param[in]     prop       Property atom
   * @param[in]     source     Regexp source
   * @param[inout]  name       Found name
   * @param[in]     flags      Match flags
@@ -1496,7 +2317,7 @@ subSubtlextWindowList(char *prop_name,
   **/
 
 int
-subSubtlextFindString(char *prop_name,
+subSubtlextFindString(SubAtom prop,
   char *source,
   char **name,
   int flags)
@@ -1505,12 +2326,12 @@ subSubtlextFindString(char *prop_name,
   char **strings = NULL;
   regex_t *preg = NULL;
 
-  assert(prop_name && source);
+  assert(source);
 
   /* Fetch data */
   preg    = subSharedRegexNew(source);
   strings = subSharedPropertyGetStrings(display, ROOT,
-    XInternAtom(display, prop_name, False), &size);
+    subSubtlextAtom(prop), &size);
 
   /* Check results */
   if(preg && strings)
@@ -1543,7 +2364,7 @@ subSubtlextFindString(char *prop_name,
 
  /** subSubtlextFindObjects {{{
   * @brief Find match in propery list and create objects
-  * @param[in]  prop_name   Property name
+  * @param[in]  prop        Property atom
   * @param[in]  class_name  Class name
   * @param[in]  source      Regexp source
   * @param[in]  flags       Match flags
@@ -1554,7 +2375,7 @@ subSubtlextFindString(char *prop_name,
   **/
 
 VALUE
-subSubtlextFindObjects(char *prop_name,
+subSubtlextFindObjects(SubAtom prop,
   char *class_name,
   char *source,
   int flags,
@@ -1564,11 +2385,11 @@ subSubtlextFindObjects(char *prop_name,
   char **strings = NULL;
   VALUE ret = first ? Qnil : rb_ary_new();
 
-  assert(prop_name && class_name && source);
+  assert(class_name && source);
 
   /* Check results */
   if((strings = subSharedPropertyGetStrings(display, ROOT,
-      XInternAtom(display, prop_name, False), &nstrings)))
+      subSubtlextAtom(prop), &nstrings)))
     {
       int selid = -1;
       VALUE meth_new = Qnil, meth_update = Qnil, klass = Qnil, obj = Qnil;
@@ -1616,14 +2437,15 @@ subSubtlextFindObjects(char *prop_name,
       if(preg) subSharedRegexKill(preg);
       XFreeStringList(strings);
     }
-  else rb_raise(rb_eStandardError, "Unknown property list `%s'", prop_name);
+  else rb_raise(rb_eStandardError, "Unknown property list `%s'",
+    atomnames[prop]);
 
   return ret;
 } /* }}} */
 
  /** subSubtlextFindWindows {{{
   * @brief Find match in propery list and create objects
-  * @param[in]  prop_name   Property name
+  * @param[in]  prop        Property atom
   * @param[in]  class_name  Class name
   * @param[in]  source      Regexp source
   * @param[in]  flags       Match flags
@@ -1633,7 +2455,7 @@ subSubtlextFindObjects(char *prop_name,
   **/
 
 VALUE
-subSubtlextFindWindows(char *prop_name,
+subSubtlextFindWindows(SubAtom prop,
   char *class_name,
   char *source,
   int flags,
@@ -1642,63 +2464,87 @@ subSubtlextFindWindows(char *prop_name,
   int i, size = 0;
   Window *wins = NULL;
   VALUE ret = first ? Qnil : rb_ary_new();
+  VALUE meth_new = Qnil, meth_update = Qnil, klass = Qnil, obj = Qnil;
+  SubBackend *b = NULL;
+  SubBackendClient *recs = NULL;
+  SubtlextSelector sel;
 
-  /* Get window list */
-  if((wins = subSubtlextWindowList(prop_name, &size)))
-    {
-      int selid = -1;
-      Window selwin = None;
-      VALUE meth_new = Qnil, meth_update = Qnil, klass = Qnil, obj = Qnil;
-      regex_t *preg = NULL;
+  SubtlextSelectorInit(&sel, source, flags);
 
-      /* Create regexp when required */
-      if(!(flags & SUB_MATCH_EXACT)) preg = subSharedRegexNew(source);
+  /* Fetch data */
+  meth_new    = rb_intern("new");
+  meth_update = rb_intern("update");
+  klass       = rb_const_get(mod, rb_intern(class_name));
 
-      /* Special values */
-      if(isdigit(source[0])) selid  = atoi(source);
-      if('#' == source[0])   selwin = subSubtleSingSelect(Qnil);
+  /* Match clients against records fetched in one go */
+  if(SUB_ATOM_NET_CLIENT_LIST == prop &&
+      (b = subSharedBackendGet(display)) && -1 != (size = b->list(&recs)))
+    {
+      for(i = 0; i < size; i++)
+        {
+          if(SubtlextSelectorMatch(&sel, i, &recs[i]) &&
+              RTEST((obj = rb_funcall(klass, meth_new,
+              1, LONG2NUM(recs[i].win)))))
+            {
+              subClientRecord(obj, &recs[i]); ///< Hand over values
 
-      /* Fetch data */
-      meth_new    = rb_intern("new");
-      meth_update = rb_intern("update");
-      klass       = rb_const_get(mod, rb_intern(class_name));
+              /* Select first or many */
+              if(first)
+                {
+                  ret = obj;
 
-      /* Check results */
+                  break;
+                }
+              else ret = subSubtlextOneOrMany(obj, ret);
+            }
+        }
+
+      free(recs);
+    }
+  else if((wins = subSubtlextWindowList(prop, &size)))
+    {
       for(i = 0; i < size; i++)
         {
-          if(selid == i || selid == wins[i] || selwin == wins[i] ||
-              (-1 == selid && SubtlextWindowMatch(wins[i], preg,
-              source, NULL, flags)))
+          int match = False;
+          SubBackendClient rec = { 0 };
+
+          /* Fetch required values once per window */
+          if(-1 == sel.selid && None == sel.selwin)
+            SubtlextSelectorFetch(&sel, wins[i], &rec);
+          else rec.win = wins[i];
+
+          match = SubtlextSelectorMatch(&sel, i, &rec);
+          SubtlextSelectorRelease(&rec);
+
+          /* Create new obj */
+          if(match && RTEST((obj = rb_funcall(klass, meth_new,
+              1, LONG2NUM(wins[i])))))
             {
-              /* Create new obj */
-              if(RTEST((obj = rb_funcall(klass, meth_new,
-                  1, LONG2NUM(wins[i])))))
-                {
-                  /* Call update method of object */
-                  rb_funcall(obj, meth_update, 0, Qnil);
+              /* Call update method of object */
+              rb_funcall(obj, meth_update, 0, Qnil);
 
-                  /* Select first or many */
-                  if(first)
-                    {
-                      ret = obj;
+              /* Select first or many */
+              if(first)
+                {
+                  ret = obj;
 
-                      break;
-                    }
-                  else ret = subSubtlextOneOrMany(obj, ret);
+                  break;
                 }
+              else ret = subSubtlextOneOrMany(obj, ret);
             }
         }
 
-      if(preg) subSharedRegexKill(preg);
       free(wins);
     }
 
+  SubtlextSelectorFinish(&sel);
+
   return ret;
 } /* }}} */
 
  /** subSubtlextFindObjectsGeometry {{{
   * @brief Find match in propery list and create objects
-  * @param[in]  prop_name   Property name
+  * @param[in]  prop        Property atom
   * @param[in]  class_name  Class name
   * @param[in]  source      Regexp source
   * @param[in]  flags       Match flags
@@ -1709,7 +2555,7 @@ subSubtlextFindWindows(char *prop_name,
   **/
 
 VALUE
-subSubtlextFindObjectsGeometry(char *prop_name,
+subSubtlextFindObjectsGeometry(SubAtom prop,
   char *class_name,
   char *source,
   int flags,
@@ -1723,7 +2569,7 @@ subSubtlextFindObjectsGeometry(char *prop_name,
 
   /* Get string list */
   if((strings = subSharedPropertyGetStrings(display, DefaultRootWindow(display),
-      XInternAtom(display, prop_name, False), &nstrings)))
+      subSubtlextAtom(prop), &nstrings)))
     {
       int i, selid = -1;
       XRectangle geometry = { 0 };
@@ -1779,7 +2625,8 @@ subSubtlextFindObjectsGeometry(char *prop_name,
       if(preg) subSharedRegexKill(preg);
       XFreeStringList(strings);
     }
-  else rb_raise(rb_eStandardError, "Unknown property list `%s'", prop_name);
+  else rb_raise(rb_eStandardError, "Unknown property list `%s'",
+    atomnames[prop]);
 
   return ret;
 } /* }}} */
@@ -1793,8 +2640,9 @@ subSubtlextFindObjectsGeometry(char *prop_name,
 void
 Init_subtlext(void)
 {
-  VALUE client = Qnil, color = Qnil, geometry = Qnil, gravity = Qnil;
-  VALUE icon = Qnil, screen = Qnil, subtle = Qnil, sublet = Qnil;
+  VALUE client = Qnil, color = Qnil, future = Qnil, geometry = Qnil;
+  VALUE gravity = Qnil, icon = Qnil, screen = Qnil, subtle = Qnil;
+  VALUE sublet = Qnil;
   VALUE tag = Qnil, tray = Qnil, view = Qnil, window = Qnil;
 
  /*
@@ -1805,9 +2653,27 @@ Init_subtlext(void)
 
   mod = rb_define_module("Subtlext");
 
+  /* Bind to backend when loaded inside of subtle */
+  if(rb_const_defined(rb_cObject, rb_intern("Subtle")))
+    {
+      VALUE owner = rb_const_get(rb_cObject, rb_intern("Subtle"));
+
+      if(rb_const_defined(owner, rb_intern("Backend")))
+        {
+          SubBackend *b = NULL;
+
+          Data_Get_Struct(rb_const_get(owner, rb_intern("Backend")),
+            SubBackend, b);
+          subSharedBackendSet(b);
+        }
+    }
+
   /* Subtlext version */
   rb_define_const(mod, "VERSION", rb_str_new2(PKG_VERSION));
 
+  /* Resolve futures in one batch */
+  rb_define_singleton_method(mod, "await", subFutureSingAwait, 1);
+
   /*
    * Document-class: Subtlext::Client
    *
@@ -1816,24 +2682,12 @@ Init_subtlext(void)
 
   client = rb_define_class_under(mod, "Client", rb_cObject);
 
+  /* Allocate */
+  rb_define_alloc_func(client, subClientAlloc);
+
   /* Window id */
   rb_define_attr(client, "win",      1, 0);
 
-  /* WM_NAME */
-  rb_define_attr(client, "name",     1, 0);
-
-  /* Instance of WM_CLASS */
-  rb_define_attr(client, "instance", 1, 0);
-
-  /* Class of WM_CLASS */
-  rb_define_attr(client, "klass",    1, 0);
-
-    /* Window role */
-  rb_define_attr(client, "role",     1, 0);
-
-  /* Bitfield of window states */
-  rb_define_attr(client, "flags",    1, 0);
-
   /* Singleton methods */
   rb_define_singleton_method(client, "select",  subClientSingSelect,  0);
   rb_define_singleton_method(client, "find",    subClientSingFind,    1);
@@ -1842,6 +2696,7 @@ Init_subtlext(void)
   rb_define_singleton_method(client, "visible", subClientSingVisible, 0);
   rb_define_singleton_method(client, "list",    subClientSingList,    0);
   rb_define_singleton_method(client, "recent",  subClientSingRecent,  0);
+  rb_define_singleton_method(client, "async",   subFutureAsync,       1);
 
   /* General methods */
   rb_define_method(client, "has_tag?",    SubtlextTagAsk,           1);
@@ -1860,10 +2715,18 @@ Init_subtlext(void)
   rb_define_method(client, "==",          SubtlextEqualWindow,      1);
   rb_define_method(client, "eql?",        SubtlextEqualTypedWindow, 1);
   rb_define_method(client, "hash",        SubtlextHash,             0);
+  rb_define_method(client, "async",       subFutureAsync,           1);
 
   /* Class methods */
   rb_define_method(client, "initialize",        subClientInit,                  1);
+  rb_define_method(client, "initialize_copy",   subClientInitCopy,              1);
+  rb_define_private_method(client, "loaded=",   subClientLoadedWriter,          1);
   rb_define_method(client, "update",            subClientUpdate,                0);
+  rb_define_method(client, "name",              subClientNameReader,            0);
+  rb_define_method(client, "instance",          subClientInstanceReader,        0);
+  rb_define_method(client, "klass",             subClientKlassReader,           0);
+  rb_define_method(client, "role",              subClientRoleReader,            0);
+  rb_define_method(client, "flags",             subClientFlagsReader,           0);
   rb_define_method(client, "views",             subClientViewList,              0);
   rb_define_method(client, "is_full?",          subClientFlagsAskFull,          0);
   rb_define_method(client, "is_float?",         subClientFlagsAskFloat,         0);
@@ -1913,31 +2776,27 @@ Init_subtlext(void)
 
   color = rb_define_class_under(mod, "Color", rb_cObject);
 
-  /* Red fraction */
-  rb_define_attr(color, "red", 1, 0);
-
-  /* Green fraction */
-  rb_define_attr(color, "green", 1, 0);
-
-  /* Blue fraction */
-  rb_define_attr(color, "blue", 1, 0);
-
-  /* Pixel number */
-  rb_define_attr(color, "pixel", 1, 0);
+  /* Allocate */
+  rb_define_alloc_func(color, subColorAlloc);
 
   /* General methods */
-  rb_define_method(color, "<=>",  SubtlextEqualSpacePixel, 1);
-  rb_define_method(color, "hash", SubtlextHash,            0);
+  rb_define_method(color, "<=>",  subColorSpaceship, 1);
+  rb_define_method(color, "hash", SubtlextHash,      0);
 
   /* Class methods */
-  rb_define_method(color, "initialize", subColorInit,         -1);
-  rb_define_method(color, "to_hex",     subColorToHex,         0);
-  rb_define_method(color, "to_ary",     subColorToArray,       0);
-  rb_define_method(color, "to_hash",    subColorToHash,        0);
-  rb_define_method(color, "to_str",     subColorToString,      0);
-  rb_define_method(color, "+",          subColorOperatorPlus,  1);
-  rb_define_method(color, "==",         subColorEqual,         1);
-  rb_define_method(color, "eql?",       subColorEqualTyped,    1);
+  rb_define_method(color, "initialize",      subColorInit,         -1);
+  rb_define_method(color, "initialize_copy", subColorInitCopy,      1);
+  rb_define_method(color, "red",             subColorRedReader,     0);
+  rb_define_method(color, "green",           subColorGreenReader,   0);
+  rb_define_method(color, "blue",            subColorBlueReader,    0);
+  rb_define_method(color, "pixel",           subColorPixelReader,   0);
+  rb_define_method(color, "to_hex",          subColorToHex,         0);
+  rb_define_method(color, "to_ary",          subColorToArray,       0);
+  rb_define_method(color, "to_hash",         subColorToHash,        0);
+  rb_define_method(color, "to_str",          subColorToString,      0);
+  rb_define_method(color, "+",               subColorOperatorPlus,  1);
+  rb_define_method(color, "==",              subColorEqual,         1);
+  rb_define_method(color, "eql?",            subColorEqualTyped,    1);
 
   /* Aliases */
   rb_define_alias(color, "to_a", "to_ary");
@@ -1945,35 +2804,50 @@ Init_subtlext(void)
   rb_define_alias(color, "to_s", "to_str");
 
   /*
-   * Document-class: Subtlext::Geometry
+   * Document-class: Subtlext::Future
    *
-   * Class for various sizes
+   * Class for batched reads of values
    */
 
-  geometry = rb_define_class_under(mod, "Geometry", rb_cObject);
+  future = rb_define_class_under(mod, "Future", rb_cObject);
 
-  /* X offset */
-  rb_define_attr(geometry, "x",      1, 1);
+  /* Created via async only */
+  rb_undef_alloc_func(future);
 
-  /* Y offset */
-  rb_define_attr(geometry, "y",      1, 1);
+  /* Class methods */
+  rb_define_method(future, "value",  subFutureValue,    0);
+  rb_define_method(future, "ready?", subFutureAskReady, 0);
 
-  /* Geometry width */
-  rb_define_attr(geometry, "width",  1, 1);
+  /*
+   * Document-class: Subtlext::Geometry
+   *
+   * Class for various sizes
+   */
 
-  /* Geometry height */
-  rb_define_attr(geometry, "height", 1, 1);
+  geometry = rb_define_class_under(mod, "Geometry", rb_cObject);
+
+  /* Allocate */
+  rb_define_alloc_func(geometry, subGeometryAlloc);
 
   /* General methods */
   rb_define_method(geometry, "hash", SubtlextHash, 0);
 
   /* Class methods */
-  rb_define_method(geometry, "initialize", subGeometryInit,      -1);
-  rb_define_method(geometry, "to_ary",     subGeometryToArray,    0);
-  rb_define_method(geometry, "to_hash",    subGeometryToHash,     0);
-  rb_define_method(geometry, "to_str",     subGeometryToString,   0);
-  rb_define_method(geometry, "==",         subGeometryEqual,      1);
-  rb_define_method(geometry, "eql?",       subGeometryEqualTyped, 1);
+  rb_define_method(geometry, "initialize",      subGeometryInit,         -1);
+  rb_define_method(geometry, "initialize_copy", subGeometryInitCopy,      1);
+  rb_define_method(geometry, "x",               subGeometryXReader,       0);
+  rb_define_method(geometry, "x=",              subGeometryXWriter,       1);
+  rb_define_method(geometry, "y",               subGeometryYReader,       0);
+  rb_define_method(geometry, "y=",              subGeometryYWriter,       1);
+  rb_define_method(geometry, "width",           subGeometryWidthReader,   0);
+  rb_define_method(geometry, "width=",          subGeometryWidthWriter,   1);
+  rb_define_method(geometry, "height",          subGeometryHeightReader,  0);
+  rb_define_method(geometry, "height=",         subGeometryHeightWriter,  1);
+  rb_define_method(geometry, "to_ary",          subGeometryToArray,       0);
+  rb_define_method(geometry, "to_hash",         subGeometryToHash,        0);
+  rb_define_method(geometry, "to_str",          subGeometryToString,      0);
+  rb_define_method(geometry, "==",              subGeometryEqual,         1);
+  rb_define_method(geometry, "eql?",            subGeometryEqualTyped,    1);
 
   /* Aliases */
   rb_define_alias(geometry, "to_a", "to_ary");
@@ -2052,18 +2926,22 @@ Init_subtlext(void)
   rb_define_method(icon, "hash", SubtlextHash,             0);
 
   /* Class methods */
-  rb_define_method(icon, "initialize", subIconInit,         -1);
-  rb_define_method(icon, "draw_point", subIconDrawPoint,    -1);
-  rb_define_method(icon, "draw_line",  subIconDrawLine,     -1);
-  rb_define_method(icon, "draw_rect",  subIconDrawRect,     -1);
-  rb_define_method(icon, "copy_area",  subIconCopyArea,     -1);
-  rb_define_method(icon, "clear",      subIconClear,        -1);
-  rb_define_method(icon, "bitmap?",    subIconAskBitmap,     0);
-  rb_define_method(icon, "to_str",     subIconToString,      0);
-  rb_define_method(icon, "+",          subIconOperatorPlus,  1);
-  rb_define_method(icon, "*",          subIconOperatorMult,  1);
-  rb_define_method(icon, "==",         subIconEqual,         1);
-  rb_define_method(icon, "eql?",       subIconEqualTyped,    1);
+  rb_define_method(icon, "initialize",    subIconInit,         -1);
+  rb_define_method(icon, "draw_point",    subIconDrawPoint,    -1);
+  rb_define_method(icon, "draw_line",     subIconDrawLine,     -1);
+  rb_define_method(icon, "draw_rect",     subIconDrawRect,     -1);
+  rb_define_method(icon, "draw_points",   subIconDrawPoints,   -1);
+  rb_define_method(icon, "draw_segments", subIconDrawSegments, -1);
+  rb_define_method(icon, "draw_rects",    subIconDrawRects,    -1);
+  rb_define_method(icon, "put_image",     subIconPutImage,     -1);
+  rb_define_method(icon, "copy_area",     subIconCopyArea,     -1);
+  rb_define_method(icon, "clear",         subIconClear,        -1);
+  rb_define_method(icon, "bitmap?",       subIconAskBitmap,     0);
+  rb_define_method(icon, "to_str",        subIconToString,      0);
+  rb_define_method(icon, "+",             subIconOperatorPlus,  1);
+  rb_define_method(icon, "*",             subIconOperatorMult,  1);
+  rb_define_method(icon, "==",            subIconEqual,         1);
+  rb_define_method(icon, "eql?",          subIconEqualTyped,    1);
 
   /* Aliases */
   rb_define_alias(icon, "to_s", "to_str");
@@ -2124,6 +3002,9 @@ Init_subtlext(void)
   rb_define_singleton_method(subtle, "display=",      subSubtleSingDisplayWriter, 1);
   rb_define_singleton_method(subtle, "select_window", subSubtleSingSelect,        0);
   rb_define_singleton_method(subtle, "running?",      subSubtleSingAskRunning,    0);
+  rb_define_singleton_method(subtle, "generation",    subSubtleSingGeneration,    0);
+  rb_define_singleton_method(subtle, "cache?",        subSubtleSingAskCache,      0);
+  rb_define_singleton_method(subtle, "cache=",        subSubtleSingCacheWriter,   1);
   rb_define_singleton_method(subtle, "render",        subSubtleSingRender,        0);
   rb_define_singleton_method(subtle, "reload",        subSubtleSingReload,        0);
   rb_define_singleton_method(subtle, "restart",       subSubtleSingRestart,       0);
@@ -2131,6 +3012,7 @@ Init_subtlext(void)
   rb_define_singleton_method(subtle, "colors",        subSubtleSingColors,        0);
   rb_define_singleton_method(subtle, "font",          subSubtleSingFont,          0);
   rb_define_singleton_method(subtle, "spawn",         subSubtleSingSpawn,         1);
+  rb_define_singleton_method(subtle, "subscribe",     subSubtleSingSubscribe,    -1);
 
   /* Aliases */
   rb_define_alias(rb_singleton_class(subtle), "reload_config", "reload");
@@ -2199,12 +3081,14 @@ Init_subtlext(void)
   rb_define_singleton_method(tag, "first",   subTagSingFirst,   1);
   rb_define_singleton_method(tag, "visible", subTagSingVisible, 0);
   rb_define_singleton_method(tag, "list",    subTagSingList,    0);
+  rb_define_singleton_method(tag, "async",   subFutureAsync,    1);
 
   /* General methods */
   rb_define_method(tag, "<=>",  SubtlextEqualSpaceId, 1);
   rb_define_method(tag, "==",   SubtlextEqualId,      1);
   rb_define_method(tag, "eql?", SubtlextEqualTypedId, 1);
   rb_define_method(tag, "hash", SubtlextHash,         0);
+  rb_define_method(tag, "async", subFutureAsync,       1);
 
   /* Class methods */
   rb_define_method(tag, "initialize", subTagInit,     1);
@@ -2293,6 +3177,7 @@ Init_subtlext(void)
   rb_define_singleton_method(view, "current", subViewSingCurrent, 0);
   rb_define_singleton_method(view, "visible", subViewSingVisible, 0);
   rb_define_singleton_method(view, "list",    subViewSingList,    0);
+  rb_define_singleton_method(view, "async",   subFutureAsync,     1);
 
   /* General methods */
   rb_define_method(view, "has_tag?", SubtlextTagAsk,       1);
@@ -2307,6 +3192,7 @@ Init_subtlext(void)
   rb_define_method(view, "eql?",     SubtlextEqualTypedId, 1);
   rb_define_method(view, "style=",   SubtlextStyle,        1);
   rb_define_method(view, "hash",     SubtlextHash,         0);
+  rb_define_method(view, "async",    subFutureAsync,       1);
 
   /* Class methods */
   rb_define_method(view, "initialize", subViewInit,          1);
@@ -2374,6 +3260,9 @@ Init_subtlext(void)
   rb_define_method(window, "border_color=", subWindowBorderColorWriter, 1);
   rb_define_method(window, "border_size=",  subWindowBorderSizeWriter,  1);
   rb_define_method(window, "on",            subWindowOn,               -1);
+  rb_define_method(window, "watch",         subWindowWatch,            -1);
+  rb_define_method(window, "unwatch",       subWindowUnwatch,           1);
+  rb_define_method(window, "timer",         subWindowTimer,            -1);
   rb_define_method(window, "draw_point",    subWindowDrawPoint,        -1);
   rb_define_method(window, "draw_line",     subWindowDrawLine,         -1);
   rb_define_method(window, "draw_rect",     subWindowDrawRect,         -1);
@@ -36,9 +36,78 @@
 #define SUB_TYPE_TRAY    4           ///< Tray
 #define SUB_TYPE_SCREEN  5           ///< Screen
 #define SUB_TYPE_SUBLET  6           ///< Sublet
+
+#define SUB_CLIENT_CLASS (1L << 0)   ///< Client WM_CLASS loaded
+#define SUB_CLIENT_NAME  (1L << 1)   ///< Client WM_NAME loaded
+#define SUB_CLIENT_TAGS  (1L << 2)   ///< Client tags loaded
+#define SUB_CLIENT_FLAGS (1L << 3)   ///< Client flags loaded
+#define SUB_CLIENT_ROLE  (1L << 4)   ///< Client WM_WINDOW_ROLE loaded
+#define SUB_CLIENT_ALL   0x1F         ///< Client attributes loaded
 /* }}} */
 
 /* Typedefs {{{ */
+typedef enum subatom_t /* {{{ */
+{
+  SUB_ATOM_UTF8_STRING,                                           ///< UTF8_STRING
+  SUB_ATOM_WM_STATE,                                              ///< WM_STATE
+  SUB_ATOM_WM_WINDOW_ROLE,                                        ///< WM_WINDOW_ROLE
+  SUB_ATOM_NET_ACTIVE_WINDOW,                                     ///< _NET_ACTIVE_WINDOW
+  SUB_ATOM_NET_CLIENT_LIST,                                       ///< _NET_CLIENT_LIST
+  SUB_ATOM_NET_CLOSE_WINDOW,                                      ///< _NET_CLOSE_WINDOW
+  SUB_ATOM_NET_CURRENT_DESKTOP,                                   ///< _NET_CURRENT_DESKTOP
+  SUB_ATOM_NET_DESKTOP_NAMES,                                     ///< _NET_DESKTOP_NAMES
+  SUB_ATOM_NET_MOVERESIZE_WINDOW,                                 ///< _NET_MOVERESIZE_WINDOW
+  SUB_ATOM_NET_RESTACK_WINDOW,                                    ///< _NET_RESTACK_WINDOW
+  SUB_ATOM_NET_SUPPORTING_WM_CHECK,                               ///< _NET_SUPPORTING_WM_CHECK
+  SUB_ATOM_NET_WM_NAME,                                           ///< _NET_WM_NAME
+  SUB_ATOM_NET_WM_PID,                                            ///< _NET_WM_PID
+  SUB_ATOM_NET_WM_STATE,                                          ///< _NET_WM_STATE
+  SUB_ATOM_NET_WM_STATE_ABOVE,                                    ///< _NET_WM_STATE_ABOVE
+  SUB_ATOM_NET_WM_STATE_FULLSCREEN,                               ///< _NET_WM_STATE_FULLSCREEN
+  SUB_ATOM_NET_WM_STATE_STICKY,                                   ///< _NET_WM_STATE_STICKY
+  SUB_ATOM_NET_WM_STATE_TOGGLE,                                   ///< _NET_WM_STATE_TOGGLE
+  SUB_ATOM_NET_WORKAREA,                                          ///< _NET_WORKAREA
+  SUB_ATOM_SUBTLE_CLIENT_FLAGS,                                   ///< SUBTLE_CLIENT_FLAGS
+  SUB_ATOM_SUBTLE_CLIENT_GRAVITY,                                 ///< SUBTLE_CLIENT_GRAVITY
+  SUB_ATOM_SUBTLE_CLIENT_RETAG,                                   ///< SUBTLE_CLIENT_RETAG
+  SUB_ATOM_SUBTLE_CLIENT_SCREEN,                                  ///< SUBTLE_CLIENT_SCREEN
+  SUB_ATOM_SUBTLE_CLIENT_TAGS,                                    ///< SUBTLE_CLIENT_TAGS
+  SUB_ATOM_SUBTLE_COLORS,                                         ///< SUBTLE_COLORS
+  SUB_ATOM_SUBTLE_DATA,                                           ///< SUBTLE_DATA
+  SUB_ATOM_SUBTLE_FONT,                                           ///< SUBTLE_FONT
+  SUB_ATOM_SUBTLE_GRAVITY_FLAGS,                                  ///< SUBTLE_GRAVITY_FLAGS
+  SUB_ATOM_SUBTLE_GRAVITY_KILL,                                   ///< SUBTLE_GRAVITY_KILL
+  SUB_ATOM_SUBTLE_GRAVITY_LIST,                                   ///< SUBTLE_GRAVITY_LIST
+  SUB_ATOM_SUBTLE_GRAVITY_NEW,                                    ///< SUBTLE_GRAVITY_NEW
+  SUB_ATOM_SUBTLE_QUIT,                                           ///< SUBTLE_QUIT
+  SUB_ATOM_SUBTLE_RELOAD,                                         ///< SUBTLE_RELOAD
+  SUB_ATOM_SUBTLE_RENDER,                                         ///< SUBTLE_RENDER
+  SUB_ATOM_SUBTLE_RESTART,                                        ///< SUBTLE_RESTART
+  SUB_ATOM_SUBTLE_SCREEN_JUMP,                                    ///< SUBTLE_SCREEN_JUMP
+  SUB_ATOM_SUBTLE_SCREEN_PANELS,                                  ///< SUBTLE_SCREEN_PANELS
+  SUB_ATOM_SUBTLE_SCREEN_VIEWS,                                   ///< SUBTLE_SCREEN_VIEWS
+  SUB_ATOM_SUBTLE_SUBLET_DATA,                                    ///< SUBTLE_SUBLET_DATA
+  SUB_ATOM_SUBTLE_SUBLET_FLAGS,                                   ///< SUBTLE_SUBLET_FLAGS
+  SUB_ATOM_SUBTLE_SUBLET_KILL,                                    ///< SUBTLE_SUBLET_KILL
+  SUB_ATOM_SUBTLE_SUBLET_LIST,                                    ///< SUBTLE_SUBLET_LIST
+  SUB_ATOM_SUBTLE_SUBLET_STYLE,                                   ///< SUBTLE_SUBLET_STYLE
+  SUB_ATOM_SUBTLE_SUBLET_UPDATE,                                  ///< SUBTLE_SUBLET_UPDATE
+  SUB_ATOM_SUBTLE_TAG_KILL,                                       ///< SUBTLE_TAG_KILL
+  SUB_ATOM_SUBTLE_TAG_LIST,                                       ///< SUBTLE_TAG_LIST
+  SUB_ATOM_SUBTLE_TAG_NEW,                                        ///< SUBTLE_TAG_NEW
+  SUB_ATOM_SUBTLE_TRAY_LIST,                                      ///< SUBTLE_TRAY_LIST
+  SUB_ATOM_SUBTLE_VERSION,                                        ///< SUBTLE_VERSION
+  SUB_ATOM_SUBTLE_VIEW_ICONS,                                     ///< SUBTLE_VIEW_ICONS
+  SUB_ATOM_SUBTLE_VIEW_KILL,                                      ///< SUBTLE_VIEW_KILL
+  SUB_ATOM_SUBTLE_VIEW_NEW,                                       ///< SUBTLE_VIEW_NEW
+  SUB_ATOM_SUBTLE_VIEW_STYLE,                                     ///< SUBTLE_VIEW_STYLE
+  SUB_ATOM_SUBTLE_VIEW_TAGS,                                      ///< SUBTLE_VIEW_TAGS
+  SUB_ATOM_SUBTLE_VISIBLE_TAGS,                                   ///< SUBTLE_VISIBLE_TAGS
+  SUB_ATOM_SUBTLE_VISIBLE_VIEWS,                                  ///< SUBTLE_VISIBLE_VIEWS
+
+  SUB_ATOM_TOTAL                                                  ///< Total number of atoms
+} SubAtom; /* }}} */
+
 extern Display *display;
 extern VALUE mod;
 
@@ -59,8 +128,19 @@ VALUE subClientSingRecent(VALUE self);                            ///< Get recen
 
 /* Class */
 VALUE subClientInstantiate(Window win);                           ///< Instantiate client
+void subClientRecord(VALUE self, SubBackendClient *rec);          ///< Set client values from record
+int subClientLoaded(VALUE self, int groups);                      ///< Mark client attributes loaded
+void subClientLoad(VALUE self, int groups);                       ///< Load client attributes
+VALUE subClientAlloc(VALUE self);                                 ///< Allocate client
 VALUE subClientInit(VALUE self, VALUE win);                       ///< Create client
+VALUE subClientInitCopy(VALUE self, VALUE other);                 ///< Copy client
+VALUE subClientLoadedWriter(VALUE self, VALUE value);             ///< Mark client attributes loaded
 VALUE subClientUpdate(VALUE self);                                ///< Update client
+VALUE subClientNameReader(VALUE self);                            ///< Get client name
+VALUE subClientInstanceReader(VALUE self);                        ///< Get client instance
+VALUE subClientKlassReader(VALUE self);                           ///< Get client class
+VALUE subClientRoleReader(VALUE self);                            ///< Get client role
+VALUE subClientFlagsReader(VALUE self);                           ///< Get client flags
 VALUE subClientViewList(VALUE self);                              ///< Get views clients is on
 VALUE subClientFlagsAskFull(VALUE self);                          ///< Is client fullscreen
 VALUE subClientFlagsAskFloat(VALUE self);                         ///< Is client floating
@@ -97,7 +177,14 @@ VALUE subClientKill(VALUE self);                                  ///< Kill clie
 unsigned long subColorPixel(VALUE red, VALUE green,
   VALUE blue, XColor *xcolor);                                    ///< Get pixel value
 VALUE subColorInstantiate(unsigned long pixel);                   ///< Instantiate color
+VALUE subColorAlloc(VALUE self);                                  ///< Allocate color
 VALUE subColorInit(int argc, VALUE *argv, VALUE self);            ///< Create new color
+VALUE subColorInitCopy(VALUE self, VALUE other);                  ///< Copy color
+VALUE subColorRedReader(VALUE self);                              ///< Get red fraction
+VALUE subColorGreenReader(VALUE self);                            ///< Get green fraction
+VALUE subColorBlueReader(VALUE self);                             ///< Get blue fraction
+VALUE subColorPixelReader(VALUE self);                            ///< Get pixel number
+VALUE subColorSpaceship(VALUE self, VALUE other);                 ///< Compare colors
 VALUE subColorToHex(VALUE self);                                  ///< Convert to hex string
 VALUE subColorToArray(VALUE self);                                ///< Color to array
 VALUE subColorToHash(VALUE self);                                 ///< Color to hash
@@ -107,11 +194,29 @@ VALUE subColorEqual(VALUE self, VALUE other);                     ///< Whether o
 VALUE subColorEqualTyped(VALUE self, VALUE other);                ///< Whether objects are equal typed
 /* }}} */
 
+/* future.c {{{ */
+VALUE subFutureInstantiate(VALUE receiver, VALUE meth);           ///< Instantiate future
+VALUE subFutureSingAwait(VALUE self, VALUE futures);              ///< Resolve futures
+VALUE subFutureAsync(VALUE self, VALUE meth);                     ///< Create future
+VALUE subFutureValue(VALUE self);                                 ///< Get future value
+VALUE subFutureAskReady(VALUE self);                              ///< Whether future is resolved
+/* }}} */
+
 /* geometry.c {{{ */
 VALUE subGeometryInstantiate(int x, int y, int width,
   int height);                                                    ///< Instantiate geometry
 void subGeometryToRect(VALUE self, XRectangle *r);                ///< Geometry to rect
+VALUE subGeometryAlloc(VALUE self);                               ///< Allocate geometry
 VALUE subGeometryInit(int argc, VALUE *argv, VALUE self);         ///< Create new geometry
+VALUE subGeometryInitCopy(VALUE self, VALUE other);               ///< Copy geometry
+VALUE subGeometryXReader(VALUE self);                             ///< Get x offset
+VALUE subGeometryXWriter(VALUE self, VALUE value);                ///< Set x offset
+VALUE subGeometryYReader(VALUE self);                             ///< Get y offset
+VALUE subGeometryYWriter(VALUE self, VALUE value);                ///< Set y offset
+VALUE subGeometryWidthReader(VALUE self);                         ///< Get width
+VALUE subGeometryWidthWriter(VALUE self, VALUE value);            ///< Set width
+VALUE subGeometryHeightReader(VALUE self);                        ///< Get height
+VALUE subGeometryHeightWriter(VALUE self, VALUE value);           ///< Set height
 VALUE subGeometryToArray(VALUE self);                             ///< Geometry to array
 VALUE subGeometryToHash(VALUE self);                              ///< Geometry to hash
 VALUE subGeometryToString(VALUE self);                            ///< Geometry to string
@@ -140,11 +245,16 @@ VALUE subGravityKill(VALUE self);                                 ///< Kill grav
 /* }}} */
 
 /* icon.c {{{ */
+Pixmap subIconPixmap(VALUE self, unsigned int *revision);         ///< Get pixmap and revision
 VALUE subIconAlloc(VALUE self);                                   ///< Allocate icon
 VALUE subIconInit(int argc, VALUE *argv, VALUE self);             ///< Init icon
 VALUE subIconDrawPoint(int argc, VALUE *argv, VALUE self);        ///< Draw a point
 VALUE subIconDrawLine(int argc, VALUE *argv, VALUE self);         ///< Draw a line
 VALUE subIconDrawRect(int argc, VALUE *argv, VALUE self);         ///< Draw a rect
+VALUE subIconDrawPoints(int argc, VALUE *argv, VALUE self);       ///< Draw many points
+VALUE subIconDrawSegments(int argc, VALUE *argv, VALUE self);     ///< Draw many lines
+VALUE subIconDrawRects(int argc, VALUE *argv, VALUE self);        ///< Draw many rects
+VALUE subIconPutImage(int argc, VALUE *argv, VALUE self);         ///< Upload image data
 VALUE subIconCopyArea(int argc, VALUE *argv, VALUE self);         ///< Copy icon area
 VALUE subIconClear(int argc, VALUE *argv, VALUE self);            ///< Clear icon
 VALUE subIconAskBitmap(VALUE self);                               ///< Whether icon is bitmap
@@ -194,6 +304,9 @@ VALUE subSubletKill(VALUE self);                                  ///< Kill subl
 VALUE subSubtleSingDisplayReader(VALUE self);                     ///< Get display
 VALUE subSubtleSingDisplayWriter(VALUE self, VALUE display);      ///< Set display
 VALUE subSubtleSingAskRunning(VALUE self);                        ///< Is subtle running
+VALUE subSubtleSingGeneration(VALUE self);                        ///< Get state generation
+VALUE subSubtleSingAskCache(VALUE self);                          ///< Whether cache is enabled
+VALUE subSubtleSingCacheWriter(VALUE self, VALUE value);          ///< Toggle property cache
 VALUE subSubtleSingSelect(VALUE self);                            ///< Select window
 VALUE subSubtleSingRender(VALUE self);                            ///< Render panels
 VALUE subSubtleSingReload(VALUE self);                            ///< Reload config and sublets
@@ -202,24 +315,30 @@ VALUE subSubtleSingQuit(VALUE self);                              ///< Quit subt
 VALUE subSubtleSingColors(VALUE self);                            ///< Get colors
 VALUE subSubtleSingFont(VALUE self);                              ///< Get font
 VALUE subSubtleSingSpawn(VALUE self, VALUE cmd);                  ///< Spawn command
+VALUE subSubtleSingSubscribe(int argc, VALUE *argv,
+  VALUE self);                                                    ///< Subscribe to events
 /* }}} */
 
 /* subtlext.c {{{ */
 void subSubtlextConnect(char *display_string);                    ///< Connect to display
+Atom subSubtlextAtom(SubAtom a);                                  ///< Get interned atom
+int subSubtlextSubscribe(int mask);                               ///< Subscribe to events
+int subSubtlextEvent(int fd, int *slot, int *id,
+  char **name);                                                   ///< Read event
 void subSubtlextBacktrace(void);                                  ///< Print ruby backtrace
 VALUE subSubtlextConcat(VALUE str1, VALUE str2);                  ///< Concat strings
 VALUE subSubtlextParse(VALUE value, char *buf,
   int len, int *flags);                                           ///< Parse arguments
 VALUE subSubtlextOneOrMany(VALUE value, VALUE prev);              ///< Return one or many
 VALUE subSubtlextManyToOne(VALUE value);                          ///< Return one from many
-Window *subSubtlextWindowList(char *prop_name, int *size);        ///< Get window list
-int subSubtlextFindString(char *prop_name, char *source,
+Window *subSubtlextWindowList(SubAtom prop, int *size);           ///< Get window list
+int subSubtlextFindString(SubAtom prop, char *source,
   char **name, int flags);                                        ///< Find string id
-VALUE subSubtlextFindObjects(char *prop_name, char *class_name,
+VALUE subSubtlextFindObjects(SubAtom prop, char *class_name,
   char *source, int flags, int first);                            ///< Find objects
-VALUE subSubtlextFindWindows(char *prop_name, char *class_name,
+VALUE subSubtlextFindWindows(SubAtom prop, char *class_name,
   char *source, int flags, int first);                            ///< Find objects
-VALUE subSubtlextFindObjectsGeometry(char *prop_name,
+VALUE subSubtlextFindObjectsGeometry(SubAtom prop,
   char *class_name, char *source, int flags, int first);          ///< Find objects with geometries
 /* }}} */
 
@@ -299,6 +418,9 @@ VALUE subWindowBorderSizeWriter(VALUE self, VALUE value);         ///< Set borde
 VALUE subWindowGeometryReader(VALUE self);                        ///< Get geometry
 VALUE subWindowGeometryWriter(VALUE self, VALUE value);           ///< Set geometry
 VALUE subWindowOn(int argc, VALUE *argv, VALUE self);             ///< Add event handler
+VALUE subWindowWatch(int argc, VALUE *argv, VALUE self);          ///< Watch fd while grabbing
+VALUE subWindowUnwatch(VALUE self, VALUE io);                     ///< Remove fd watch
+VALUE subWindowTimer(int argc, VALUE *argv, VALUE self);          ///< Add timer while grabbing
 VALUE subWindowDrawPoint(int argc, VALUE *argv, VALUE self);      ///< Draw a point
 VALUE subWindowDrawLine(int argc, VALUE *argv, VALUE self);       ///< Draw a line
 VALUE subWindowDrawRect(int argc, VALUE *argv, VALUE self);       ///< Draw a rect
@@ -37,7 +37,8 @@ TagFind(VALUE value,
           return parsed;
     }
 
-  return subSubtlextFindObjects("SUBTLE_TAG_LIST", "Tag", buf, flags, first);
+  return subSubtlextFindObjects(SUB_ATOM_SUBTLE_TAG_LIST, "Tag",
+    buf, flags, first);
 } /* }}} */
 
 /* Singleton */
@@ -132,10 +133,10 @@ subTagSingVisible(VALUE self)
   klass   = rb_const_get(mod, rb_intern("Tag"));
   array   = rb_ary_new();
   tags    = subSharedPropertyGetStrings(display, DefaultRootWindow(display),
-    XInternAtom(display, "SUBTLE_TAG_LIST", False), &ntags);
+    subSubtlextAtom(SUB_ATOM_SUBTLE_TAG_LIST), &ntags);
   visible = (unsigned long *)subSharedPropertyGet(display,
-    DefaultRootWindow(display), XA_CARDINAL, XInternAtom(display,
-    "SUBTLE_VISIBLE_TAGS", False), NULL);
+    DefaultRootWindow(display), XA_CARDINAL,
+    subSubtlextAtom(SUB_ATOM_SUBTLE_VISIBLE_TAGS), NULL);
 
   /* Populate array */
   if(tags && visible)
@@ -179,6 +180,7 @@ subTagSingList(VALUE self)
   int i, ntags = 0;
   char **tags = NULL;
   VALUE meth = Qnil, klass = Qnil, array = Qnil;
+  SubBackend *b = NULL;
 
   subSubtlextConnect(NULL); ///< Implicit open connection
 
@@ -187,9 +189,26 @@ subTagSingList(VALUE self)
   klass = rb_const_get(mod, rb_intern("Tag"));
   array = rb_ary_new();
 
+  /* Read tags directly from subtle */
+  if((b = subSharedBackendGet(display)) && b->tags &&
+      -1 != (ntags = b->tags(&tags)))
+    {
+      for(i = 0; i < ntags; i++)
+        {
+          VALUE t = rb_funcall(klass, meth, 1, rb_str_new2(tags[i]));
+
+          rb_iv_set(t, "@id", INT2FIX(i));
+          rb_ary_push(array, t);
+        }
+
+      free(tags);
+
+      return array;
+    }
+
   /* Check results */
   if((tags = subSharedPropertyGetStrings(display, DefaultRootWindow(display),
-      XInternAtom(display, "SUBTLE_TAG_LIST", False), &ntags)))
+      subSubtlextAtom(SUB_ATOM_SUBTLE_TAG_LIST), &ntags)))
     {
       for(i = 0; i < ntags; i++)
         {
@@ -274,7 +293,7 @@ subTagSave(VALUE self)
   subSubtlextConnect(NULL); ///< Implicit open connection
 
   /* Create tag if needed */
-  if(-1 == (id = subSubtlextFindString("SUBTLE_TAG_LIST",
+  if(-1 == (id = subSubtlextFindString(SUB_ATOM_SUBTLE_TAG_LIST,
       RSTRING_PTR(name), NULL, SUB_MATCH_EXACT)))
     {
       SubMessageData data = { { 0, 0, 0, 0, 0 } };
@@ -283,7 +302,7 @@ subTagSave(VALUE self)
       subSharedMessage(display, DefaultRootWindow(display),
         "SUBTLE_TAG_NEW", data, 8, True);
 
-      id = subSubtlextFindString("SUBTLE_TAG_LIST",
+      id = subSubtlextFindString(SUB_ATOM_SUBTLE_TAG_LIST,
         RSTRING_PTR(name), NULL, SUB_MATCH_EXACT);
     }
 
@@ -295,7 +314,7 @@ subTagSave(VALUE self)
 
       /* Get names of tags */
       if((tags = subSharedPropertyGetStrings(display, DefaultRootWindow(display),
-          XInternAtom(display, "SUBTLE_TAG_LIST", False), &ntags)))
+          subSubtlextAtom(SUB_ATOM_SUBTLE_TAG_LIST), &ntags)))
         {
 
           id = ntags; ///< New id should be last
@@ -339,7 +358,7 @@ subTagClients(VALUE self)
   klass   = rb_const_get(mod, rb_intern("Client"));
   meth    = rb_intern("new");
   array   = rb_ary_new();
-  clients = subSubtlextWindowList("_NET_CLIENT_LIST", &nclients);
+  clients = subSubtlextWindowList(SUB_ATOM_NET_CLIENT_LIST, &nclients);
 
   /* Check results */
   if(clients)
@@ -347,8 +366,8 @@ subTagClients(VALUE self)
       for(i = 0; i < nclients; i++)
         {
           if((tags = (unsigned long *)subSharedPropertyGet(display,
-              clients[i], XA_CARDINAL, XInternAtom(display,
-              "SUBTLE_CLIENT_TAGS", False), NULL)))
+              clients[i], XA_CARDINAL,
+              subSubtlextAtom(SUB_ATOM_SUBTLE_CLIENT_TAGS), NULL)))
             {
               /* Check if tag id matches */
               if(*tags & (1L << (FIX2INT(id) + 1)))
@@ -403,10 +422,10 @@ subTagViews(VALUE self)
   meth   = rb_intern("new");
   array  = rb_ary_new();
   names  = subSharedPropertyGetStrings(display, DefaultRootWindow(display),
-    XInternAtom(display, "_NET_DESKTOP_NAMES", False), &nnames);
+    subSubtlextAtom(SUB_ATOM_NET_DESKTOP_NAMES), &nnames);
   tags   = (unsigned long *)subSharedPropertyGet(display,
     DefaultRootWindow(display), XA_CARDINAL,
-    XInternAtom(display, "SUBTLE_VIEW_TAGS", False), NULL);
+    subSubtlextAtom(SUB_ATOM_SUBTLE_VIEW_TAGS), NULL);
 
   /* Check results */
   if(names && tags)
@@ -35,7 +35,7 @@ TrayFind(VALUE value,
           return parsed;
     }
 
-  return subSubtlextFindWindows("SUBTLE_TRAY_LIST", "Tray",
+  return subSubtlextFindWindows(SUB_ATOM_SUBTLE_TRAY_LIST, "Tray",
     buf, flags, first);
 } /* }}} */
 
@@ -145,7 +145,7 @@ subTraySingList(VALUE self)
   array = rb_ary_new();
 
   /* Check results */
-  if((trays = subSubtlextWindowList("SUBTLE_TRAY_LIST", &ntrays)))
+  if((trays = subSubtlextWindowList(SUB_ATOM_SUBTLE_TRAY_LIST, &ntrays)))
     {
       for(i = 0; i < ntrays; i++)
         {
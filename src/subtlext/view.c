@@ -28,7 +28,7 @@ ViewSelect(VALUE self,
 
   /* Fetch data */
   if((names = subSharedPropertyGetStrings(display, DefaultRootWindow(display),
-    XInternAtom(display, "_NET_DESKTOP_NAMES", False), &nnames)))
+    subSubtlextAtom(SUB_ATOM_NET_DESKTOP_NAMES), &nnames)))
     {
       int vid = FIX2INT(id);
 
@@ -80,7 +80,7 @@ ViewFind(VALUE value,
           return parsed;
     }
 
-  return subSubtlextFindObjects("_NET_DESKTOP_NAMES", "View",
+  return subSubtlextFindObjects(SUB_ATOM_NET_DESKTOP_NAMES, "View",
     buf, flags, first);
 } /* }}} */
 
@@ -165,15 +165,31 @@ subViewSingCurrent(VALUE self)
   char **names = NULL;
   unsigned long *cur_view = NULL;
   VALUE view = Qnil;
+  SubBackend *b = NULL;
 
   subSubtlextConnect(NULL); ///< Implicit open connection
 
+  /* Ask subtle directly */
+  if((b = subSharedBackendGet(display)))
+    {
+      int id = -1;
+      char *name = NULL;
+
+      if(-1 != (id = b->view(&name)))
+        {
+          view = subViewInstantiate(name);
+          rb_iv_set(view, "@id",  INT2FIX(id));
+
+          return view;
+        }
+    }
+
   /* Fetch data */
   names    = subSharedPropertyGetStrings(display, DefaultRootWindow(display),
-    XInternAtom(display, "_NET_DESKTOP_NAMES", False), &nnames);
+    subSubtlextAtom(SUB_ATOM_NET_DESKTOP_NAMES), &nnames);
   cur_view = (unsigned long *)subSharedPropertyGet(display,
     DefaultRootWindow(display), XA_CARDINAL,
-    XInternAtom(display, "_NET_CURRENT_DESKTOP", False), NULL);
+    subSubtlextAtom(SUB_ATOM_NET_CURRENT_DESKTOP), NULL);
 
   /* Check results */
   if(names && cur_view)
@@ -217,12 +233,12 @@ subViewSingVisible(VALUE self)
   klass = rb_const_get(mod, rb_intern("View"));
   array = rb_ary_new();
   names = subSharedPropertyGetStrings(display, DefaultRootWindow(display),
-    XInternAtom(display, "_NET_DESKTOP_NAMES", False), &nnames);
+    subSubtlextAtom(SUB_ATOM_NET_DESKTOP_NAMES), &nnames);
   visible = (unsigned long *)subSharedPropertyGet(display,
-    DefaultRootWindow(display), XA_CARDINAL, XInternAtom(display,
-    "SUBTLE_VISIBLE_VIEWS", False), NULL);
+    DefaultRootWindow(display), XA_CARDINAL,
+    subSubtlextAtom(SUB_ATOM_SUBTLE_VISIBLE_VIEWS), NULL);
   tags  = (int *)subSharedPropertyGet(display, ROOT, XA_CARDINAL,
-      XInternAtom(display, "SUBTLE_VIEW_TAGS", False), NULL);
+      subSubtlextAtom(SUB_ATOM_SUBTLE_VIEW_TAGS), NULL);
 
   /* Check results */
   if(names && visible && tags)
@@ -269,6 +285,7 @@ subViewSingList(VALUE self)
   long *tags = NULL;
   char **names = NULL;
   VALUE meth = Qnil, klass = Qnil, array = Qnil, v = Qnil;
+  SubBackend *b = NULL;
 
   subSubtlextConnect(NULL); ///< Implicit open connection
 
@@ -276,10 +293,35 @@ subViewSingList(VALUE self)
   klass = rb_const_get(mod, rb_intern("View"));
   meth  = rb_intern("new");
   array = rb_ary_new();
+
+  /* Read views directly from subtle */
+  if((b = subSharedBackendGet(display)) && b->views)
+    {
+      int *vtags = NULL;
+
+      if(-1 != (nnames = b->views(&names, &vtags)))
+        {
+          for(i = 0; i < nnames; i++)
+            {
+              if(!NIL_P(v = rb_funcall(klass, meth, 1, rb_str_new2(names[i]))))
+                {
+                  rb_iv_set(v, "@id",   INT2FIX(i));
+                  rb_iv_set(v, "@tags", LONG2NUM(vtags[i]));
+
+                  rb_ary_push(array, v);
+                }
+            }
+
+          free(names);
+          free(vtags);
+
+          return array;
+        }
+    }
   names = subSharedPropertyGetStrings(display, DefaultRootWindow(display),
-      XInternAtom(display, "_NET_DESKTOP_NAMES", False), &nnames);
+      subSubtlextAtom(SUB_ATOM_NET_DESKTOP_NAMES), &nnames);
   tags  = (long *)subSharedPropertyGet(display, ROOT, XA_CARDINAL,
-      XInternAtom(display, "SUBTLE_VIEW_TAGS", False), NULL);
+      subSubtlextAtom(SUB_ATOM_SUBTLE_VIEW_TAGS), NULL);
 
   /* Check results */
   if(names && tags)
@@ -375,7 +417,7 @@ subViewUpdate(VALUE self)
 
   /* Fetch tags */
   if((tags = (long *)subSharedPropertyGet(display, ROOT, XA_CARDINAL,
-      XInternAtom(display, "SUBTLE_VIEW_TAGS", False), (unsigned long *)&ntags)))
+      subSubtlextAtom(SUB_ATOM_SUBTLE_VIEW_TAGS), (unsigned long *)&ntags)))
     {
       int idx = FIX2INT(id);
 
@@ -410,7 +452,7 @@ subViewSave(VALUE self)
   subSubtlextConnect(NULL); ///< Implicit open connection
 
   /* Create view if needed */
-  if(-1 == (id = subSubtlextFindString("_NET_DESKTOP_NAMES",
+  if(-1 == (id = subSubtlextFindString(SUB_ATOM_NET_DESKTOP_NAMES,
       RSTRING_PTR(name), NULL, SUB_MATCH_EXACT)))
     {
       SubMessageData data = { { 0, 0, 0, 0, 0 } };
@@ -419,7 +461,7 @@ subViewSave(VALUE self)
       subSharedMessage(display, DefaultRootWindow(display),
         "SUBTLE_VIEW_NEW", data, 8, True);
 
-      id = subSubtlextFindString("_NET_DESKTOP_NAMES",
+      id = subSubtlextFindString(SUB_ATOM_NET_DESKTOP_NAMES,
         RSTRING_PTR(name), NULL, SUB_MATCH_EXACT);
     }
 
@@ -431,7 +473,7 @@ subViewSave(VALUE self)
 
       /* Get names of views */
       if((names = subSharedPropertyGetStrings(display, DefaultRootWindow(display),
-          XInternAtom(display, "_NET_DESKTOP_NAMES", False), &nnames)))
+          subSubtlextAtom(SUB_ATOM_NET_DESKTOP_NAMES), &nnames)))
         {
           id = nnames; ///< New id should be last
 
@@ -476,10 +518,10 @@ subViewClients(VALUE self)
   klass     = rb_const_get(mod, rb_intern("Client"));
   meth      = rb_intern("new");
   array     = rb_ary_new();
-  clients   = subSubtlextWindowList("_NET_CLIENT_LIST", &nclients);
+  clients   = subSubtlextWindowList(SUB_ATOM_NET_CLIENT_LIST, &nclients);
   view_tags = (unsigned long *)subSharedPropertyGet(display,
     DefaultRootWindow(display), XA_CARDINAL,
-    XInternAtom(display, "SUBTLE_VIEW_TAGS", False), NULL);
+    subSubtlextAtom(SUB_ATOM_SUBTLE_VIEW_TAGS), NULL);
 
   /* Check results */
   if(clients && view_tags)
@@ -491,10 +533,10 @@ subViewClients(VALUE self)
           /* Fetch window data */
           client_tags = (unsigned long *)subSharedPropertyGet(display,
             clients[i], XA_CARDINAL,
-            XInternAtom(display, "SUBTLE_CLIENT_TAGS", False), NULL);
+            subSubtlextAtom(SUB_ATOM_SUBTLE_CLIENT_TAGS), NULL);
           flags       = (unsigned long *)subSharedPropertyGet(display,
             clients[i], XA_CARDINAL,
-            XInternAtom(display, "SUBTLE_CLIENT_FLAGS", False), NULL);
+            subSubtlextAtom(SUB_ATOM_SUBTLE_CLIENT_FLAGS), NULL);
 
           /* Check if there are common tags or window is stick */
           if((client_tags && view_tags[FIX2INT(id)] & *client_tags) ||
@@ -610,7 +652,7 @@ subViewAskCurrent(VALUE self)
   /* Check results */
   if((cur_view = (unsigned long *)subSharedPropertyGet(display,
       DefaultRootWindow(display), XA_CARDINAL,
-      XInternAtom(display, "_NET_CURRENT_DESKTOP", False), NULL)))
+      subSubtlextAtom(SUB_ATOM_NET_CURRENT_DESKTOP), NULL)))
     {
       if(FIX2INT(id) == *cur_view) ret = Qtrue;
 
@@ -646,7 +688,7 @@ subViewIcon(VALUE self)
   /* Check results */
   if((icons = (unsigned long *)subSharedPropertyGet(display,
       DefaultRootWindow(display), XA_CARDINAL,
-      XInternAtom(display, "SUBTLE_VIEW_ICONS", False), &nicons)))
+      subSubtlextAtom(SUB_ATOM_SUBTLE_VIEW_ICONS), &nicons)))
     {
       int iid = FIX2INT(id);
 
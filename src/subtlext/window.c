@@ -9,22 +9,51 @@
   * See the file COPYING for details.
   **/
 
+#include <sys/time.h>
 #include "subtlext.h"
 
 /* Flags {{{ */
 #define WINDOW_INPUT_FUNC      (1L << 2)
 #define WINDOW_FOREIGN_WIN     (1L << 3)
+#define WINDOW_DIRTY           (1L << 4)
+/* }}} */
+
+/* Primitives {{{ */
+#define WINDOW_POINT 0
+#define WINDOW_LINE  1
+#define WINDOW_RECT  2
+#define WINDOW_FILL  3
+#define WINDOW_CLEAR 4
+#define WINDOW_TEXT  5
+#define WINDOW_ICON  6
+/* }}} */
+
+/* Macros {{{ */
+#define WINDOW_SLICE 0.05                                         ///< Max wait with other threads
 /* }}} */
 
 /* Typedefs {{{ */
+typedef struct subtlextprimitive_t
+{
+  int                type, x, y, width, height, bitmap, len;
+  unsigned int       revision;
+  unsigned long      fg, bg;
+  VALUE              icon;
+  char               *text;
+} SubtlextPrimitive;
+
 typedef struct subtlextwindow_t
 {
   GC                 gc;
-  int                flags, ntext;
+  int                flags, ntext, nprims, cursor;
   unsigned long      fg, bg;
+  unsigned int       bwidth, bheight;
   Window             win;
+  Pixmap             buffer;
   VALUE              instance, expose, keyboard, pointer;
+  VALUE              watches, timers;
   SubFont            *font;
+  SubtlextPrimitive  *prims;
 } SubtlextWindow;
 /* }}} */
 
@@ -34,10 +63,18 @@ WindowMark(SubtlextWindow *w)
 {
   if(w)
     {
+      int i;
+
       rb_gc_mark(w->instance);
       if(RTEST(w->expose))     rb_gc_mark(w->expose);
       if(RTEST(w->keyboard))   rb_gc_mark(w->keyboard);
       if(RTEST(w->pointer))    rb_gc_mark(w->pointer);
+      if(RTEST(w->watches))    rb_gc_mark(w->watches);
+      if(RTEST(w->timers))     rb_gc_mark(w->timers);
+
+      /* Keep icons of the display list and their pixmaps alive */
+      for(i = 0; i < w->nprims; i++)
+        if(RTEST(w->prims[i].icon)) rb_gc_mark(w->prims[i].icon);
     }
 } /* }}} */
 
@@ -45,6 +82,8 @@ WindowMark(SubtlextWindow *w)
 static void
 WindowSweep(SubtlextWindow *w)
 {
+  int i;
+
   if(w)
     {
       /* Destroy window */
@@ -53,6 +92,13 @@ WindowSweep(SubtlextWindow *w)
 
       if(0 != w->gc) XFreeGC(display, w->gc);
       if(w->font) subSharedFontKill(display, w->font);
+      if(w->buffer) XFreePixmap(display, w->buffer);
+
+      /* Free display list */
+      for(i = 0; i < w->nprims; i++)
+        if(w->prims[i].text) free(w->prims[i].text);
+
+      if(w->prims) free(w->prims);
 
       free(w);
     }
@@ -67,15 +113,141 @@ WindowCall(VALUE data)
   return rb_funcall(rargs[0], rargs[1], rargs[2], rargs[3], rargs[4]);
 } /* }}} */
 
+/* WindowRecord {{{ */
+static void
+WindowRecord(SubtlextWindow *w,
+  SubtlextPrimitive *p)
+{
+  SubtlextPrimitive *old = NULL;
+
+  /* Skip primitive when it is equal to the one of last frame */
+  if(w->cursor < w->nprims)
+    {
+      old = &w->prims[w->cursor];
+
+      if(old->type == p->type && old->x == p->x && old->y == p->y &&
+          old->width == p->width && old->height == p->height &&
+          old->fg == p->fg && old->bg == p->bg &&
+          old->icon == p->icon && old->revision == p->revision &&
+          old->bitmap == p->bitmap &&
+          old->len == p->len && (!p->text ||
+          0 == memcmp(old->text, p->text, p->len)))
+        {
+          if(p->text) free(p->text);
+
+          w->cursor++;
+
+          return;
+        }
+
+      if(old->text) free(old->text);
+    }
+  else
+    {
+      w->prims = (SubtlextPrimitive *)subSharedMemoryRealloc(w->prims,
+        (w->nprims + 1) * sizeof(SubtlextPrimitive));
+      old      = &w->prims[w->nprims++];
+    }
+
+  *old = *p;
+
+  w->cursor++;
+  w->flags |= WINDOW_DIRTY;
+} /* }}} */
+
+/* WindowRender {{{ */
+static void
+WindowRender(SubtlextWindow *w)
+{
+  int i;
+  XRectangle r = { 0 };
+
+  subGeometryToRect(rb_iv_get(w->instance, "@geometry"), &r);
+
+  /* Drop primitives of last frame that weren't drawn again */
+  if(w->cursor < w->nprims)
+    {
+      for(i = w->cursor; i < w->nprims; i++)
+        if(w->prims[i].text) free(w->prims[i].text);
+
+      w->nprims  = w->cursor;
+      w->flags  |= WINDOW_DIRTY;
+    }
+
+  /* Create on demand */
+  if(0 == w->gc)
+    w->gc = XCreateGC(display, w->win, 0, NULL);
+
+  /* Create or resize back buffer */
+  if(!w->buffer || r.width != w->bwidth || r.height != w->bheight)
+    {
+      if(w->buffer) XFreePixmap(display, w->buffer);
+
+      w->buffer   = XCreatePixmap(display, w->win, r.width, r.height,
+        XDefaultDepth(display, DefaultScreen(display)));
+      w->bwidth   = r.width;
+      w->bheight  = r.height;
+      w->flags   |= WINDOW_DIRTY;
+    }
+
+  /* Render display list into back buffer only when it changed */
+  if(w->flags & WINDOW_DIRTY)
+    {
+      XSetForeground(display, w->gc, w->bg);
+      XFillRectangle(display, w->buffer, w->gc, 0, 0, r.width, r.height);
+
+      for(i = 0; i < w->nprims; i++)
+        {
+          SubtlextPrimitive *p = &w->prims[i];
+
+          XSetForeground(display, w->gc, p->fg);
+
+          switch(p->type)
+            {
+              case WINDOW_POINT:
+                XDrawPoint(display, w->buffer, w->gc, p->x, p->y);
+                break;
+              case WINDOW_LINE:
+                XDrawLine(display, w->buffer, w->gc, p->x, p->y,
+                  p->width, p->height);
+                break;
+              case WINDOW_RECT:
+                XDrawRectangle(display, w->buffer, w->gc, p->x, p->y,
+                  p->width, p->height);
+                break;
+              case WINDOW_FILL:
+              case WINDOW_CLEAR:
+                XFillRectangle(display, w->buffer, w->gc, p->x, p->y,
+                  p->width, p->height);
+                break;
+              case WINDOW_TEXT:
+                subSharedDrawString(display, w->gc, w->font, w->buffer,
+                  p->x, p->y, p->fg, p->bg, p->text, p->len);
+                break;
+              case WINDOW_ICON:
+                /* Pixmap changes when a shared icon is drawn on */
+                subSharedDrawIcon(display, w->gc, w->buffer, p->x, p->y,
+                  p->width, p->height, p->fg, p->bg,
+                  subIconPixmap(p->icon, NULL), p->bitmap);
+                break;
+            }
+        }
+
+      w->flags &= ~WINDOW_DIRTY;
+    }
+
+  XCopyArea(display, w->buffer, w->win, w->gc, 0, 0,
+    r.width, r.height, 0, 0);
+  XFlush(display);
+} /* }}} */
+
 /* WindowExpose {{{ */
 static void
 WindowExpose(SubtlextWindow *w)
 {
   if(w)
     {
-      XClearWindow(display, w->win);
-
-      /* Call expose proc if any */
+      /* Call expose proc if any to record a new frame */
       if(RTEST(w->expose))
         {
           int state = 0;
@@ -87,51 +259,191 @@ WindowExpose(SubtlextWindow *w)
           rargs[2] = 1;
           rargs[3] = w->instance;
 
+          w->cursor = 0;
+
           /* Carefully call listen proc */
           rb_protect(WindowCall, (VALUE)&rargs, &state);
           if(state) subSubtlextBacktrace();
         }
 
+     WindowRender(w);
      XSync(display, False); ///< Sync with X
   }
 } /* }}} */
 
-/* WindowGrab {{{ */
+/* WindowTime {{{ */
+static double
+WindowTime(void)
+{
+  struct timeval tv;
+
+  gettimeofday(&tv, NULL);
+
+  return tv.tv_sec + tv.tv_usec / 1000000.0;
+} /* }}} */
+
+/* WindowSelect {{{ */
 static VALUE
-WindowGrab(SubtlextWindow *w)
+WindowSelect(VALUE data)
 {
-  XEvent ev;
-  int loop = True, state = 0;
-  char buf[32] = { 0 };
-  unsigned long *focus = NULL, mask = 0;
-  VALUE result = Qnil, rargs[5] = { Qnil }, sym = Qnil, ary = Qnil;
-  KeySym keysym;
+  int i;
+  VALUE *sargs = (VALUE *)data, watches = sargs[0], ready = rb_ary_new();
+  rb_fdset_t *fds = (rb_fdset_t *)sargs[2];
 
-  /* Add grabs */
-  if(RTEST(w->keyboard))
+  /* Collect watches of readable fds */
+  if(0 < rb_thread_fd_select(FIX2INT(sargs[1]), fds, NULL, NULL,
+      (struct timeval *)sargs[3]))
     {
-      mask |= KeyPressMask;
+      for(i = 0; i < RARRAY_LEN(watches); i++)
+        {
+          VALUE entry = rb_ary_entry(watches, i);
 
-      XGrabKeyboard(display, w->win, True, GrabModeAsync,
-        GrabModeAsync, CurrentTime);
+          if(rb_fd_isset(FIX2INT(rb_ary_entry(entry, 0)), fds))
+            rb_ary_push(ready, entry);
+        }
     }
-  if(RTEST(w->pointer))
+
+  return ready;
+} /* }}} */
+
+/* WindowSelectDone {{{ */
+static VALUE
+WindowSelectDone(VALUE data)
+{
+  rb_fd_term((rb_fdset_t *)data);
+
+  return Qnil;
+} /* }}} */
+
+/* WindowWait {{{ */
+static void
+WindowWait(SubtlextWindow *w,
+  int queued)
+{
+  int i, fd = 0, maxfd = ConnectionNumber(display), state = 0;
+  double now = WindowTime(), next = -1, due = 0;
+  struct timeval tv, *timeout = NULL;
+  rb_fdset_t fds;
+  VALUE entries = Qnil, entry = Qnil, result = Qnil, rargs[5] = { Qnil };
+  VALUE sargs[4] = { Qnil };
+
+  XFlush(display);
+
+  /* Watch X connection and extra fds */
+  rb_fd_init(&fds);
+  rb_fd_set(maxfd, &fds);
+
+  for(i = 0; i < RARRAY_LEN(w->watches); i++)
     {
-      mask |= ButtonPressMask;
+      fd = FIX2INT(rb_ary_entry(rb_ary_entry(w->watches, i), 0));
 
-      XGrabPointer(display, w->win, True, ButtonPressMask, GrabModeAsync,
-        GrabModeAsync, None, None, CurrentTime);
+      rb_fd_set(fd, &fds);
+      if(fd > maxfd) maxfd = fd;
     }
 
-  XMapRaised(display, w->win);
-  XSelectInput(display, w->win, mask);
-  XSetInputFocus(display, w->win, RevertToPointerRoot, CurrentTime);
+  /* Sleep until next timer is due */
+  for(i = 0; i < RARRAY_LEN(w->timers); i++)
+    {
+      due = NUM2DBL(rb_ary_entry(rb_ary_entry(w->timers, i), 1));
+
+      if(0 > next || due < next) next = due;
+    }
+
+  if(0 <= next) next = next > now ? next - now : 0;
+
+  /* Other threads may read our events into the queue of the shared
+   * display, select doesn't wake up for them */
+  if(XQLength(display) != queued) next = 0;
+  else if(!rb_thread_alone() && (0 > next || WINDOW_SLICE < next))
+    next = WINDOW_SLICE;
+
+  if(0 <= next)
+    {
+      tv.tv_sec  = (long)next;
+      tv.tv_usec = (long)((next - tv.tv_sec) * 1000000);
+      timeout    = &tv;
+    }
+
+  /* Wrap up data */
+  sargs[0] = w->watches;
+  sargs[1] = INT2FIX(maxfd + 1);
+  sargs[2] = (VALUE)&fds;
+  sargs[3] = (VALUE)timeout;
+
+  /* Let other ruby threads run while waiting, fds are freed on interrupt */
+  entries = rb_ensure(WindowSelect, (VALUE)&sargs,
+    WindowSelectDone, (VALUE)&fds);
+
+  for(i = 0; i < RARRAY_LEN(entries); i++)
+    {
+      entry = rb_ary_entry(entries, i);
+
+      /* Wrap up data */
+      rargs[0] = rb_ary_entry(entry, 2);
+      rargs[1] = rb_intern("call");
+      rargs[2] = 1;
+      rargs[3] = rb_ary_entry(entry, 1);
+
+      /* Carefully call watch proc */
+      result = rb_protect(WindowCall, (VALUE)&rargs, &state);
+      if(state) subSubtlextBacktrace();
+
+      if(Qfalse == result || state) rb_ary_delete(w->watches, entry);
+    }
+
+  /* Call procs of due timers */
+  entries = rb_ary_dup(w->timers);
+  now     = WindowTime();
+
+  for(i = 0; i < RARRAY_LEN(entries); i++)
+    {
+      entry = rb_ary_entry(entries, i);
+
+      if(NUM2DBL(rb_ary_entry(entry, 1)) <= now)
+        {
+          /* Wrap up data */
+          rargs[0] = rb_ary_entry(entry, 2);
+          rargs[1] = rb_intern("call");
+          rargs[2] = 1;
+          rargs[3] = w->instance;
+
+          /* Carefully call timer proc */
+          result = rb_protect(WindowCall, (VALUE)&rargs, &state);
+          if(state) subSubtlextBacktrace();
+
+          if(Qfalse == result || state) rb_ary_delete(w->timers, entry);
+          else rb_ary_store(entry, 1, rb_float_new(now +
+            NUM2DBL(rb_ary_entry(entry, 0))));
+        }
+    }
+} /* }}} */
+
+/* WindowGrabLoop {{{ */
+static VALUE
+WindowGrabLoop(VALUE data)
+{
+  XEvent ev;
+  int loop = True, state = 0;
+  char buf[32] = { 0 };
+  VALUE *gargs = (VALUE *)data;
+  SubtlextWindow *w = (SubtlextWindow *)gargs[0];
+  unsigned long mask = (unsigned long)gargs[1];
+  VALUE result = Qnil, rargs[5] = { Qnil }, sym = Qnil, ary = Qnil;
+  KeySym keysym;
+
   WindowExpose(w);
   XFlush(display);
 
   while(loop)
     {
-      XMaskEvent(display, mask, &ev);
+      /* Wait for events, fds and timers without blocking ruby */
+      if(!XCheckMaskEvent(display, mask, &ev))
+        {
+          WindowWait(w, XQLength(display));
+
+          continue;
+        }
+
       switch(ev.type)
         {
           case KeyPress: /* {{{ */
@@ -211,31 +523,86 @@ WindowGrab(SubtlextWindow *w)
             /* End event loop? */
             if(Qtrue != result || state) loop = False;
             break; /* }}} */
+          case Expose: /* {{{ */
+            /* Repaint from back buffer */
+            if(0 == ev.xexpose.count) WindowRender(w);
+            break; /* }}} */
           default: break;
         }
     }
 
+  return Qnil;
+} /* }}} */
+
+/* WindowUngrab {{{ */
+static VALUE
+WindowUngrab(VALUE data)
+{
+  VALUE *gargs = (VALUE *)data;
+  SubtlextWindow *w = (SubtlextWindow *)gargs[0];
+  unsigned long *focus = NULL, mask = (unsigned long)gargs[1];
+
   /* Remove grabs */
-  if(RTEST(w->keyboard))
+  if(mask & KeyPressMask)
     {
       XSelectInput(display, w->win, NoEventMask);
       XUngrabKeyboard(display, CurrentTime);
     }
-  if(RTEST(w->pointer)) XUngrabPointer(display, CurrentTime);
+  if(mask & ButtonPressMask) XUngrabPointer(display, CurrentTime);
 
   /* Restore logical focus */
   if((focus = (unsigned long *)subSharedPropertyGet(display,
       DefaultRootWindow(display), XA_WINDOW,
-      XInternAtom(display, "_NET_ACTIVE_WINDOW", False), NULL)))
+      subSubtlextAtom(SUB_ATOM_NET_ACTIVE_WINDOW), NULL)))
     {
       XSetInputFocus(display, *focus, RevertToPointerRoot, CurrentTime);
 
       free(focus);
     }
 
+  XFlush(display);
+
   return Qnil;
 } /* }}} */
 
+/* WindowGrab {{{ */
+static VALUE
+WindowGrab(SubtlextWindow *w)
+{
+  unsigned long mask = 0;
+  VALUE gargs[2] = { Qnil };
+
+  /* Add grabs */
+  if(RTEST(w->keyboard))
+    {
+      mask |= KeyPressMask;
+
+      XGrabKeyboard(display, w->win, True, GrabModeAsync,
+        GrabModeAsync, CurrentTime);
+    }
+  if(RTEST(w->pointer))
+    {
+      mask |= ButtonPressMask;
+
+      XGrabPointer(display, w->win, True, ButtonPressMask, GrabModeAsync,
+        GrabModeAsync, None, None, CurrentTime);
+    }
+
+  mask |= ExposureMask;
+
+  XMapRaised(display, w->win);
+  XSelectInput(display, w->win, mask);
+  XSetInputFocus(display, w->win, RevertToPointerRoot, CurrentTime);
+
+  /* Wrap up data */
+  gargs[0] = (VALUE)w;
+  gargs[1] = (VALUE)mask;
+
+  /* Always release grabs, waiting can be interrupted */
+  return rb_ensure(WindowGrabLoop, (VALUE)&gargs,
+    WindowUngrab, (VALUE)&gargs);
+} /* }}} */
+
 /* Singleton */
 
 /* subWindowSingOnce {{{ */
@@ -300,6 +667,8 @@ subWindowAlloc(VALUE self)
 
   /* Create window */
   w = (SubtlextWindow *)subSharedMemoryAlloc(1, sizeof(SubtlextWindow));
+  w->watches  = rb_ary_new();
+  w->timers   = rb_ary_new();
   w->instance = Data_Wrap_Struct(self, WindowMark,
     WindowSweep, (void *)w);
 
@@ -519,7 +888,8 @@ subWindowFontWriter(VALUE self,
               /* Replace font */
               if(w->font) subSharedFontKill(display, w->font);
 
-              w->font = f;
+              w->font   = f;
+              w->flags |= WINDOW_DIRTY;
             }
           else rb_raise(rb_eStandardError, "Invalid font `%s'", font);
         }
@@ -677,7 +1047,8 @@ subWindowBackgroundWriter(VALUE self,
   Data_Get_Struct(self, SubtlextWindow, w);
   if(w)
     {
-      w->bg = subColorPixel(value, Qnil, Qnil, NULL);
+      w->bg     = subColorPixel(value, Qnil, Qnil, NULL);
+      w->flags |= WINDOW_DIRTY;
 
       XSetWindowBackground(display, w->win, w->bg);
     }
@@ -882,6 +1253,132 @@ subWindowOn(int argc,
   return self;
 } /* }}} */
 
+/* subWindowWatch {{{ */
+/*
+ * call-seq: watch(io, &block) -> Subtlext::Window
+ *
+ * Call block with io when it becomes readable while this Window grabs
+ * keyboard or pointer. The watch is removed when the block returns
+ * <b>false</b>.
+ *
+ *  win.watch(socket) do |io|
+ *    p io.read_nonblock(100)
+ *  end
+ *  => #<Subtlext::Window:xxx>
+ */
+
+VALUE
+subWindowWatch(int argc,
+  VALUE *argv,
+  VALUE self)
+{
+  VALUE io = Qnil, value = Qnil;
+  SubtlextWindow *w = NULL;
+
+  /* Check ruby object */
+  rb_check_frozen(self);
+
+  rb_scan_args(argc, argv, "11", &io, &value);
+
+  if(rb_block_given_p()) value = rb_block_proc(); ///< Get proc
+
+  Data_Get_Struct(self, SubtlextWindow, w);
+  if(w)
+    {
+      VALUE fd = Qnil;
+
+      /* File descriptor or ruby io */
+      if(FIXNUM_P(io)) fd = io;
+      else if(rb_respond_to(io, rb_intern("fileno")))
+        fd = rb_funcall(io, rb_intern("fileno"), 0, NULL);
+
+      if(FIXNUM_P(fd) && rb_respond_to(value, rb_intern("call")))
+        rb_ary_push(w->watches, rb_ary_new3(3, fd, io, value));
+      else rb_raise(rb_eArgError, "Unexpected value-types");
+    }
+
+  return self;
+} /* }}} */
+
+/* subWindowUnwatch {{{ */
+/*
+ * call-seq: unwatch(io) -> Subtlext::Window
+ *
+ * Remove all watches of io.
+ *
+ *  win.unwatch(socket)
+ *  => #<Subtlext::Window:xxx>
+ */
+
+VALUE
+subWindowUnwatch(VALUE self,
+  VALUE io)
+{
+  int i;
+  SubtlextWindow *w = NULL;
+
+  /* Check ruby object */
+  rb_check_frozen(self);
+
+  Data_Get_Struct(self, SubtlextWindow, w);
+  if(w)
+    {
+      for(i = RARRAY_LEN(w->watches) - 1; 0 <= i; i--)
+        {
+          VALUE entry = rb_ary_entry(w->watches, i);
+
+          if(rb_ary_entry(entry, 1) == io || rb_ary_entry(entry, 0) == io)
+            rb_ary_delete_at(w->watches, i);
+        }
+    }
+
+  return self;
+} /* }}} */
+
+/* subWindowTimer {{{ */
+/*
+ * call-seq: timer(interval, &block) -> Subtlext::Window
+ *
+ * Call block every interval seconds while this Window grabs keyboard
+ * or pointer. The timer is removed when the block returns <b>false</b>.
+ *
+ *  win.timer(0.5) do |w|
+ *    w.redraw
+ *  end
+ *  => #<Subtlext::Window:xxx>
+ */
+
+VALUE
+subWindowTimer(int argc,
+  VALUE *argv,
+  VALUE self)
+{
+  VALUE interval = Qnil, value = Qnil;
+  SubtlextWindow *w = NULL;
+
+  /* Check ruby object */
+  rb_check_frozen(self);
+
+  rb_scan_args(argc, argv, "11", &interval, &value);
+
+  if(rb_block_given_p()) value = rb_block_proc(); ///< Get proc
+
+  Data_Get_Struct(self, SubtlextWindow, w);
+  if(w)
+    {
+      if(rb_obj_is_kind_of(interval, rb_cNumeric) &&
+          0 < NUM2DBL(interval) && rb_respond_to(value, rb_intern("call")))
+        {
+          rb_ary_push(w->timers, rb_ary_new3(3,
+            rb_float_new(NUM2DBL(interval)),
+            rb_float_new(WindowTime() + NUM2DBL(interval)), value));
+        }
+      else rb_raise(rb_eArgError, "Unexpected value-types");
+    }
+
+  return self;
+} /* }}} */
+
 /* subWindowDrawPoint {{{ */
 /*
  * call-seq: draw_point(x, y, color) -> Subtlext::Window
@@ -912,24 +1409,15 @@ subWindowDrawPoint(int argc,
       Data_Get_Struct(self, SubtlextWindow, w);
       if(w)
         {
-          XGCValues gvals;
-
-          /* Create on demand */
-          if(0 == w->gc)
-            w->gc = XCreateGC(display, w->win, 0, NULL);
-
-          /* Update GC */
-          gvals.foreground = w->fg;
-          gvals.background = w->bg;
-
-          if(!NIL_P(color))
-            gvals.foreground = subColorPixel(color, Qnil, Qnil, NULL);
-
-          XChangeGC(display, w->gc, GCForeground|GCBackground, &gvals);
+          SubtlextPrimitive p = { 0 };
 
-          XDrawPoint(display, w->win, w->gc, FIX2INT(x), FIX2INT(y));
+          p.type = WINDOW_POINT;
+          p.x    = FIX2INT(x);
+          p.y    = FIX2INT(y);
+          p.fg   = NIL_P(color) ? w->fg :
+            subColorPixel(color, Qnil, Qnil, NULL);
 
-          XFlush(display);
+          WindowRecord(w, &p);
         }
     }
   else rb_raise(rb_eArgError, "Unexpected value-types");
@@ -968,25 +1456,18 @@ subWindowDrawLine(int argc,
       Data_Get_Struct(self, SubtlextWindow, w);
       if(w)
         {
-          XGCValues gvals;
-
-          /* Create on demand */
-          if(0 == w->gc)
-            w->gc = XCreateGC(display, w->win, 0, NULL);
-
-          /* Update GC */
-          gvals.foreground = w->fg;
-          gvals.background = w->bg;
-
-          if(!NIL_P(color))
-            gvals.foreground = subColorPixel(color, Qnil, Qnil, NULL);
-
-          XChangeGC(display, w->gc, GCForeground|GCBackground, &gvals);
-
-          XDrawLine(display, w->win, w->gc, FIX2INT(x1),
-            FIX2INT(y1), FIX2INT(x2), FIX2INT(y2));
-
-          XFlush(display);
+          SubtlextPrimitive p = { 0 };
+
+          /* Store end point as width and height */
+          p.type   = WINDOW_LINE;
+          p.x      = FIX2INT(x1);
+          p.y      = FIX2INT(y1);
+          p.width  = FIX2INT(x2);
+          p.height = FIX2INT(y2);
+          p.fg     = NIL_P(color) ? w->fg :
+            subColorPixel(color, Qnil, Qnil, NULL);
+
+          WindowRecord(w, &p);
         }
     }
   else rb_raise(rb_eArgError, "Unexpected value-types");
@@ -1026,31 +1507,17 @@ subWindowDrawRect(int argc,
       Data_Get_Struct(self, SubtlextWindow, w);
       if(w)
         {
-          XGCValues gvals;
-
-          /* Create on demand */
-          if(0 == w->gc)
-            w->gc = XCreateGC(display, w->win, 0, NULL);
+          SubtlextPrimitive p = { 0 };
 
-          /* Update GC */
-          gvals.foreground = w->fg;
-          gvals.background = w->bg;
-
-          if(!NIL_P(color))
-            gvals.foreground = subColorPixel(color, Qnil, Qnil, NULL);
-
-          XChangeGC(display, w->gc, GCForeground|GCBackground, &gvals);
-
-          /* Draw rect */
-          if(Qtrue == fill)
-            {
-              XFillRectangle(display, w->win, w->gc, FIX2INT(x),
-                FIX2INT(y), FIX2INT(width), FIX2INT(height));
-            }
-          else XDrawRectangle(display, w->win, w->gc, FIX2INT(x),
-            FIX2INT(y), FIX2INT(width), FIX2INT(height));
+          p.type   = Qtrue == fill ? WINDOW_FILL : WINDOW_RECT;
+          p.x      = FIX2INT(x);
+          p.y      = FIX2INT(y);
+          p.width  = FIX2INT(width);
+          p.height = FIX2INT(height);
+          p.fg     = NIL_P(color) ? w->fg :
+            subColorPixel(color, Qnil, Qnil, NULL);
 
-          XFlush(display);
+          WindowRecord(w, &p);
         }
     }
   else rb_raise(rb_eArgError, "Unexpected value-types");
@@ -1063,7 +1530,7 @@ subWindowDrawRect(int argc,
  * call-seq: draw_text(x, y, string, color) -> Subtlext::Window
  *
  * Draw a text on the Window starting at x/y with given width, height
- * and color <b>without</b> caching it.
+ * and color. It is shown on next redraw.
  *
  *  win.draw_text(10, 10, "subtle")
  *  => #<Subtlext::Window:xxx>
@@ -1085,17 +1552,19 @@ subWindowDrawText(int argc,
   Data_Get_Struct(self, SubtlextWindow, w);
   if(w && FIXNUM_P(x) && FIXNUM_P(y) && T_STRING == rb_type(text))
     {
-      long lcolor = w->fg;
+      SubtlextPrimitive p = { 0 };
 
-      /* Create on demand */
-      if(0 == w->gc)
-        w->gc = XCreateGC(display, w->win, 0, NULL);
+      p.type = WINDOW_TEXT;
+      p.x    = FIX2INT(x);
+      p.y    = FIX2INT(y);
+      p.fg   = NIL_P(color) ? w->fg : subColorPixel(color, Qnil, Qnil, NULL);
+      p.bg   = w->bg;
+      p.len  = RSTRING_LEN(text);
+      p.text = (char *)subSharedMemoryAlloc(p.len + 1, sizeof(char));
 
-      /* Parse colors */
-      if(!NIL_P(color)) lcolor = subColorPixel(color, Qnil, Qnil, NULL);
+      memcpy(p.text, RSTRING_PTR(text), p.len);
 
-      subSharedDrawString(display, w->gc, w->font, w->win, FIX2INT(x),
-        FIX2INT(y), lcolor, w->bg, RSTRING_PTR(text), RSTRING_LEN(text));
+      WindowRecord(w, &p);
     }
 
   return self;
@@ -1106,7 +1575,7 @@ subWindowDrawText(int argc,
  * call-seq: draw_icon(x, y, icon, fg, bg) -> Subtlext::Window
  *
  * Draw a icon on the Window starting at x/y with given width, height
- * and color <b>without</b> caching it.
+ * and color. It is shown on next redraw.
  *
  *  win.draw_icon(10, 10, Subtlext::Icon.new("foo.xbm"))
  *  => #<Subtlext::Window:xxx>
@@ -1129,27 +1598,24 @@ subWindowDrawIcon(int argc,
   if(w && FIXNUM_P(x) && FIXNUM_P(y) &&
       rb_obj_is_instance_of(icon, rb_const_get(mod, rb_intern("Icon"))))
     {
-      int bitmap = False;
-      long lfg = w->fg, lbg = w->bg;
-      VALUE width = Qnil, height = Qnil, pixmap = Qnil;
-
-      /* Create on demand */
-      if(0 == w->gc)
-        w->gc = XCreateGC(display, w->win, 0, NULL);
+      SubtlextPrimitive p = { 0 };
 
       /* Parse colors */
-      if(!NIL_P(fg)) lfg = subColorPixel(fg, Qnil, Qnil, NULL);
-      if(!NIL_P(bg)) lbg = subColorPixel(bg, Qnil, Qnil, NULL);
+      p.fg = NIL_P(fg) ? w->fg : subColorPixel(fg, Qnil, Qnil, NULL);
+      p.bg = NIL_P(bg) ? w->bg : subColorPixel(bg, Qnil, Qnil, NULL);
 
       /* Fetch icon values */
-      width  = rb_iv_get(icon, "@width");
-      height = rb_iv_get(icon, "@height");
-      pixmap = rb_iv_get(icon, "@pixmap");
-      bitmap = Qtrue == subIconAskBitmap(icon) ? True : False;
-
-      subSharedDrawIcon(display, w->gc, w->win, FIX2INT(x),
-        FIX2INT(y), FIX2INT(width), FIX2INT(height), lfg, lbg,
-        NUM2LONG(pixmap), bitmap);
+      p.type   = WINDOW_ICON;
+      p.x      = FIX2INT(x);
+      p.y      = FIX2INT(y);
+      p.width  = FIX2INT(rb_iv_get(icon, "@width"));
+      p.height = FIX2INT(rb_iv_get(icon, "@height"));
+      p.icon   = icon;
+      p.bitmap = Qtrue == subIconAskBitmap(icon) ? True : False;
+
+      subIconPixmap(icon, &p.revision);
+
+      WindowRecord(w, &p);
     }
 
   return self;
@@ -1159,7 +1625,8 @@ subWindowDrawIcon(int argc,
 /*
  * call-seq: clear -> Subtlext::Window
  *
- * Clear this Window and remove all stored text.
+ * Clear this Window or an area of it and start a new frame. Drawing
+ * the same primitives again doesn't cause any rendering.
  *
  *  win.clear
  *  => #<Subtlext::Window:xxx>
@@ -1182,13 +1649,21 @@ subWindowClear(int argc,
 
       rb_scan_args(argc, argv, "04", &x, &y, &width, &height);
 
-      /* Either clear area or whole window */
+      /* Either clear area or start a new frame */
       if(FIXNUM_P(x) && FIXNUM_P(y) && FIXNUM_P(width) && FIXNUM_P(height))
         {
-          XClearArea(display, w->win, FIX2INT(x), FIX2INT(y),
-            FIX2INT(width), FIX2INT(height), False);
+          SubtlextPrimitive p = { 0 };
+
+          p.type   = WINDOW_CLEAR;
+          p.x      = FIX2INT(x);
+          p.y      = FIX2INT(y);
+          p.width  = FIX2INT(width);
+          p.height = FIX2INT(height);
+          p.fg     = w->bg;
+
+          WindowRecord(w, &p);
         }
-      else XClearWindow(display, w->win);
+      else w->cursor = 0;
     }
 
   return self;
@@ -1198,7 +1673,8 @@ subWindowClear(int argc,
 /*
  * call-seq: redraw -> Subtlext::Window
  *
- * Redraw Window content.
+ * Redraw Window content: Call the draw proc if any and render changes of
+ * the recorded primitives into the back buffer of the Window.
  *
  *  win.redraw
  *  => #<Subtlext::Window:xxx>
@@ -1241,7 +1717,7 @@ subWindowRaise(VALUE self)
   if(w)
     {
       XRaiseWindow(display, w->win);
-      WindowExpose(w);
+      WindowRender(w);
     }
 
   return self;
@@ -1270,7 +1746,7 @@ subWindowLower(VALUE self)
   if(w)
     {
       XLowerWindow(display, w->win);
-      WindowExpose(w);
+      WindowRender(w);
     }
 
   return self;
@@ -1303,7 +1779,10 @@ subWindowShow(VALUE self)
       else
         {
           XMapRaised(display, w->win);
-          WindowExpose(w);
+
+          /* Call draw proc only for first frame */
+          if(w->buffer) WindowRender(w);
+          else WindowExpose(w);
         }
     }
 
@@ -52,6 +52,29 @@ context 'Client' do
     topic.eql?(Subtlext::Client.current) and topic == topic
   end # }}}
 
+  asserts 'Load attributes of copies' do # {{{
+    client = Subtlext::Client.new(topic.win)
+    copy   = client.dup
+
+    CLIENT_NAME == client.name and CLIENT_NAME == copy.name and
+      client.instance_variables.none? { |iv| :@loaded == iv.to_sym }
+  end # }}}
+
+  asserts 'Invalidate cached properties' do # {{{
+    Subtlext::Subtle.cache = true
+
+    topic[:cache_test] = 'before'
+    before = topic[:cache_test]
+
+    topic[:cache_test] = 'after'
+    sleep 0.5
+    after = topic[:cache_test]
+
+    Subtlext::Subtle.cache = false
+
+    'before' == before and 'after' == after and !Subtlext::Subtle.cache?
+  end # }}}
+
   asserts 'Hash and unique' do # {{{
     1 == [ topic, topic ].uniq.size
   end # }}}
@@ -168,6 +191,50 @@ context 'Client' do
     'test' == Subtlext::Client.current[:test]
   end # }}}
 
+  asserts 'Await futures' do # {{{
+    name  = topic.async(:name)
+    geom  = topic.async(:geometry)
+    list  = Subtlext::Client.async(:list)
+    ready = [ name, geom, list ].none? { |f| f.ready? }
+
+    values = Subtlext.await([ name, geom, list ])
+
+    ready and [ name, geom, list ].all? { |f| f.ready? } and
+      CLIENT_NAME == values[0] and topic.geometry == values[1] and
+      CLIENT_COUNT == values[2].size and values[0] == name.value
+  end # }}}
+
+  asserts 'Resolve single future' do # {{{
+    future = topic.async(:instance)
+
+    CLIENT_NAME == future.value and future.ready? and
+      CLIENT_NAME == Subtlext.await(topic.async(:instance))
+  end # }}}
+
+  asserts 'Unknown future method' do # {{{
+    begin
+      topic.async(:abcdef)
+
+      false
+    rescue ArgumentError
+      true
+    end
+  end # }}}
+
+  asserts 'Raise stored error' do # {{{
+    future = Subtlext::Client.async(:first)
+
+    Subtlext.await([ future ])
+
+    begin
+      future.value
+
+      false
+    rescue ArgumentError
+      future.ready?
+    end
+  end # }}}
+
   asserts 'Kill a client' do # {{{
     topic.kill
 
@@ -45,6 +45,24 @@ context 'Color' do
   asserts 'Convert to string' do # {{{
     topic.to_str.match(/<>#[0-9]+<>/)
   end # }}}
+
+  asserts 'Frozen value' do # {{{
+    begin
+      topic.send(:initialize, '#00ff00')
+
+      false
+    rescue RuntimeError
+      topic.frozen? and 255 == topic.red and 0 == topic.green
+    end
+  end # }}}
+
+  asserts 'Dup and clone' do # {{{
+    dup   = topic.dup
+    clone = topic.clone
+
+    topic == dup and topic == clone and topic.pixel == dup.pixel and
+      clone.frozen? and 0 == (topic <=> clone)
+  end # }}}
 end
 
 # vim:ts=2:bs=2:sw=2:et:fdm=marker
@@ -45,6 +45,29 @@ context 'Geometry' do
   asserts 'Convert to string' do # {{{
     '0x0+1+1' == topic.to_str
   end # }}}
+
+  asserts 'Dup and clone' do # {{{
+    dup   = topic.dup
+    clone = topic.clone
+
+    dup.x     = 5
+    dup.width = 10
+
+    topic == clone and 0 == topic.x and 1 == topic.width and
+      5 == dup.x and 10 == dup.width and 0 == dup.y
+  end # }}}
+
+  asserts 'Frozen geometry' do # {{{
+    frozen = topic.dup.freeze
+
+    begin
+      frozen.x = 1
+
+      false
+    rescue RuntimeError
+      0 == frozen.x
+    end
+  end # }}}
 end
 
 # vim:ts=2:bs=2:sw=2:et:fdm=marker
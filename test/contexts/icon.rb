@@ -10,6 +10,12 @@
 #
 
 context 'Icon' do
+  # Pixels of the icon pixmap, set bits of bitmaps are black
+  ICON_PIXELS = lambda { |icon|
+    Gdk::Pixbuf.from_drawable(nil, Gdk::Pixmap.foreign_new(icon.pixmap),
+      0, 0, icon.width, icon.height).pixels
+  }
+
   setup do # {{{
     Subtlext::Icon.new('icon/clock.xbm')
   end # }}}
@@ -34,6 +40,87 @@ context 'Icon' do
     true
   end # }}}
 
+  asserts 'Draw many points' do # {{{
+    icon = Subtlext::Icon.new(8, 8).clear
+    flat = Subtlext::Icon.new(8, 8).clear
+    before = ICON_PIXELS.call(icon)
+
+    icon.draw_points([ [ 1, 1 ], [ 2, 4 ], [ 3, 2 ] ])
+    flat.draw_points([ 1, 1, 2, 4, 3, 2 ])
+
+    before != ICON_PIXELS.call(icon) and
+      ICON_PIXELS.call(icon) == ICON_PIXELS.call(flat)
+  end # }}}
+
+  asserts 'Draw many segments' do # {{{
+    icon = Subtlext::Icon.new(8, 8).clear
+    line = Subtlext::Icon.new(8, 8).clear
+
+    icon.draw_segments([ [ 1, 1, 1, 6 ], [ 3, 2, 6, 2 ] ])
+    line.draw_line(1, 1, 1, 6)
+    line.draw_line(3, 2, 6, 2)
+
+    ICON_PIXELS.call(icon) == ICON_PIXELS.call(line)
+  end # }}}
+
+  asserts 'Draw many rects' do # {{{
+    icon = Subtlext::Icon.new(8, 8).clear
+    rect = Subtlext::Icon.new(8, 8).clear
+
+    icon.draw_rects([ [ 0, 0, 3, 3 ], [ 4, 4, 3, 3 ] ], true)
+    rect.draw_rect(0, 0, 3, 3, true)
+    rect.draw_rect(4, 4, 3, 3, true)
+
+    ICON_PIXELS.call(icon) == ICON_PIXELS.call(rect)
+  end # }}}
+
+  asserts 'Put image' do # {{{
+    icon = Subtlext::Icon.new(8, 8).clear
+    rect = Subtlext::Icon.new(8, 8).clear
+
+    icon.put_image("\xff\x81\x81\x81\x81\x81\x81\xff")
+    rect.draw_rect(0, 0, 7, 7, false)
+
+    ICON_PIXELS.call(icon) == ICON_PIXELS.call(rect)
+  end # }}}
+
+  asserts 'Reject invalid bulk data' do # {{{
+    icon = Subtlext::Icon.new(8, 8)
+
+    [
+      lambda { icon.draw_points([ [ 1, 1 ], [ 2, 'x' ] ]) },
+      lambda { icon.draw_segments([ 1, 1, 1 ]) },
+      lambda { icon.draw_rects([ [ 0, 0, 3 ] ], true) },
+      lambda { icon.put_image("\xff") }
+    ].all? do |call|
+      begin
+        call.call
+
+        false
+      rescue ArgumentError, TypeError
+        true
+      end
+    end
+  end # }}}
+
+  asserts 'Share icons of the same file' do # {{{
+    icon1 = Subtlext::Icon.new('icon/clock.xbm')
+    icon2 = Subtlext::Icon.new('icon/clock.xbm')
+
+    icon1.pixmap == icon2.pixmap
+  end # }}}
+
+  asserts 'Draw on shared icons' do # {{{
+    icon1  = Subtlext::Icon.new('icon/clock.xbm')
+    icon2  = Subtlext::Icon.new('icon/clock.xbm')
+    before = ICON_PIXELS.call(icon2)
+
+    icon1.clear
+
+    icon1.pixmap != icon2.pixmap and before == ICON_PIXELS.call(icon2) and
+      before != ICON_PIXELS.call(icon1)
+  end # }}}
+
   asserts 'Copy area' do # {{{
     icon = Subtlext::Icon.new('icon/clock.xbm')
 
@@ -14,6 +14,14 @@ context 'Sublet' do
   SUBLET_ID    = 0
   SUBLET_NAME  = 'dummy'
 
+  # Top panel pixels below the sublet, geometry y is the panel height
+  SUBLET_PIXELS = lambda {
+    geom = Subtlext::Sublet.first(SUBLET_ID).geometry
+
+    Gdk::Pixbuf.from_drawable(nil, Gdk::Window.default_root_window,
+      geom.x, 0, geom.width, geom.y).pixels
+  }
+
   setup do # {{{
     Subtlext::Sublet.first(SUBLET_ID)
   end # }}}
@@ -56,6 +64,33 @@ context 'Sublet' do
     topic.geometry.is_a?(Subtlext::Geometry)
   end # }}}
 
+  asserts 'Push graph samples' do # {{{
+    topic.send_data('^%40^')
+
+    sleep 0.5
+
+    before = SUBLET_PIXELS.call
+    topic.send_data('100')
+
+    sleep 0.5
+
+    before != SUBLET_PIXELS.call
+  end # }}}
+
+  asserts 'Push without graph' do # {{{
+    topic.send_data('dummy')
+
+    sleep 0.5
+
+    # Nothing is drawn over the text once the graph is gone
+    before = SUBLET_PIXELS.call
+    topic.send_data('50')
+
+    sleep 0.5
+
+    before == SUBLET_PIXELS.call
+  end # }}}
+
   asserts 'Equal and compare' do # {{{
     topic.eql?(topic) and topic == topic
   end # }}}
@@ -100,6 +100,42 @@ context 'View' do
     view_prev == topic
   end # }}}
 
+  asserts 'Subscribe to events' do # {{{
+    view_next = topic.next
+    event     = nil
+    view      = nil
+
+    # Jump once subscribed
+    Thread.new do
+      sleep 0.5
+
+      view_next.jump
+    end
+
+    Subtlext::Subtle.subscribe(:view_focus) do |e, v|
+      event = e
+      view  = v
+
+      false
+    end
+
+    topic.jump
+
+    sleep 1
+
+    :view_focus == event and view_next == view
+  end # }}}
+
+  asserts 'Subscribe to unknown event' do # {{{
+    begin
+      Subtlext::Subtle.subscribe(:abcdef) { |e, o| false }
+
+      false
+    rescue ArgumentError
+      true
+    end
+  end # }}}
+
   asserts 'Add/remove tags' do # {{{
     tag = Subtlext::Tag.all.last
 
@@ -0,0 +1,143 @@
+#
+# @package test
+#
+# @file Test Subtlext::Window functions
+# @version $Id$
+#
+# This program can be distributed under the terms of the GNU GPLv2.
+# See the file COPYING for details.
+#
+
+context 'Window' do
+  setup do # {{{
+    win = Subtlext::Window.new(x: 0, y: 0, width: 50, height: 50)
+
+    # Stop grabbing on any key
+    win.on :key_down do |key, mods|
+      false
+    end
+
+    win
+  end # }}}
+
+  asserts 'Run timers while grabbing' do # {{{
+    ticks = 0
+    once  = 0
+
+    # Stop grabbing after the fifth tick
+    topic.timer(0.05) do |w|
+      ticks += 1
+
+      w.send_key('a') if 5 == ticks
+
+      5 > ticks
+    end
+
+    # Remove timer on first call
+    topic.timer(0.05) do |w|
+      once += 1
+
+      false
+    end
+
+    topic.show
+
+    5 == ticks and 1 == once
+  end # }}}
+
+  asserts 'Watch io while grabbing' do # {{{
+    rd, wr = IO.pipe
+    data   = nil
+
+    topic.watch(rd) do |io|
+      data = io.read_nonblock(6)
+
+      false
+    end
+
+    # Write to pipe first and stop grabbing later
+    topic.timer(0.05) do |w|
+      if data.nil?
+        wr.write('subtle')
+      else
+        w.send_key('a')
+      end
+
+      data.nil?
+    end
+
+    topic.show
+
+    rd.close
+    wr.close
+
+    'subtle' == data
+  end # }}}
+
+  asserts 'Unwatch io' do # {{{
+    rd, wr = IO.pipe
+    called = false
+
+    topic.watch(rd) do |io|
+      called = true
+    end
+
+    topic.unwatch(rd)
+    wr.write('subtle')
+
+    topic.timer(0.1) do |w|
+      w.send_key('a')
+
+      false
+    end
+
+    topic.show
+
+    rd.close
+    wr.close
+
+    !called
+  end # }}}
+
+  asserts 'Reject bad timer' do # {{{
+    begin
+      topic.timer(0) do |w|
+        false
+      end
+
+      false
+    rescue ArgumentError
+      true
+    end
+  end # }}}
+
+  asserts 'Draw from display list' do # {{{
+    frames = 0
+
+    topic.on :draw do |w|
+      frames += 1
+
+      w.clear
+      w.draw_rect(1, 1, 10, 10, '#ff0000', true)
+      w.draw_text(10, 10, 'subtle')
+    end
+
+    topic.redraw
+
+    # Raise and lower repaint from the back buffer only
+    topic.raise
+    topic.lower
+
+    topic.redraw
+
+    2 == frames
+  end # }}}
+
+  asserts 'Kill a window' do # {{{
+    topic.kill
+
+    true
+  end # }}}
+end
+
+# vim:ts=2:bs=2:sw=2:et:fdm=marker
@@ -1,3 +1,13 @@
 configure :dummy do |s|
   s.interval = 60
+  s.graph(10, 100)
+end
+
+on :data do |s, data|
+  # Push numbers, show anything else
+  if data.match(/^[0-9]+$/)
+    s.push(data.to_i)
+  else
+    s.data = data
+  end
 end
@@ -67,6 +67,7 @@ require_relative "contexts/screen.rb"
 require_relative "contexts/sublet.rb"
 require_relative "contexts/tag.rb"
 require_relative "contexts/view.rb"
+require_relative "contexts/window.rb"
 require_relative "contexts/client.rb"
 require_relative "contexts/tray.rb"
 require_relative "contexts/subtle_finish.rb"